@@ -43,6 +43,7 @@ LINUX_DEPENDENCIES = \
   LIBRT \
   LIBSNDFILE \
   LIBX11 \
+  LIBXEXT \
   LIBXRANDR
 
 LINUX_TEST_DEPENDENCIES = \
@@ -67,6 +68,7 @@ BSD_DEPENDENCIES = \
   LIBRT \
   LIBSNDFILE \
   LIBX11 \
+  LIBXEXT \
   LIBXRANDR
 
 BSD_TEST_DEPENDENCIES = \
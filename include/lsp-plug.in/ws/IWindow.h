@@ -467,6 +467,14 @@ namespace lsp
                  * @param state window state
                  */
                 virtual status_t set_window_state(window_state_t state);
+
+                /**
+                 * Invalidate the area of the window and issue it's redraw. Invalidated areas
+                 * are accumulated until the redraw happens and are passed to the UIE_REDRAW event.
+                 * @param r the area of the window to invalidate
+                 * @return status of operation
+                 */
+                virtual status_t invalidate(const rectangle_t *r);
         };
     } /* namespace ws */
 } /* namespace lsp */
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_LRUCACHE_H_
+#define PRIVATE_LRUCACHE_H_
+
+#include <lsp-plug.in/common/types.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        /**
+         * Header of the record stored in the LRU cache, should be the first field of the record
+         */
+        typedef struct lru_item_t
+        {
+            lru_item_t         *hnext;          // Next item in the hash bin
+            lru_item_t         *prev;           // Previous item in the LRU list
+            lru_item_t         *next;           // Next item in the LRU list
+            uint32_t            hash;           // Hash of the key
+            size_t              size;           // Amount of memory accounted for the item in bytes
+        } lru_item_t;
+
+        /**
+         * Bounded LRU cache of variable-sized records. The cache does not know the layout of
+         * the key: records are looked up by the hash and compared by the match function of
+         * the owner. The amount of memory used by records is limited, the least recently used
+         * records are destroyed by the destroy function of the owner when the limit is exceeded.
+         */
+        class LSP_HIDDEN_MODIFIER LRUCache
+        {
+            public:
+                /**
+                 * Check that the item matches the key
+                 * @param item item with the same hash as the key
+                 * @param key the key passed to the get() method
+                 * @return true if the item matches the key
+                 */
+                typedef bool        (* match_t)(const lru_item_t *item, const void *key);
+
+                /**
+                 * Destroy the item removed from the cache
+                 * @param item item to destroy
+                 */
+                typedef void        (* destroy_t)(lru_item_t *item);
+
+            private:
+                lru_item_t        **vBins;              // Hash bins, allocated on first insert
+                size_t              nBins;              // Number of hash bins, power of two
+                lru_item_t         *pHead;              // Most recently used item
+                lru_item_t         *pTail;              // Least recently used item
+                destroy_t           pDestroy;           // Function to destroy items
+                size_t              nSize;              // Current cache size
+                size_t              nMaxSize;           // Maximum cache size
+                size_t              nHits;              // Number of cache hits
+                size_t              nMisses;            // Number of cache misses
+
+            private:
+                inline void         unlink(lru_item_t *item);
+                inline void         link_first(lru_item_t *item);
+
+            public:
+                /**
+                 * Create the cache
+                 * @param bins number of hash bins, should be power of two
+                 * @param max_size maximum cache size in bytes
+                 * @param destroy function to destroy removed items
+                 */
+                explicit LRUCache(size_t bins, size_t max_size, destroy_t destroy);
+                LRUCache(const LRUCache &) = delete;
+                LRUCache(LRUCache &&) = delete;
+                ~LRUCache();
+                LRUCache & operator = (const LRUCache &) = delete;
+                LRUCache & operator = (LRUCache &&) = delete;
+
+            public:
+                /**
+                 * Lookup for the item and mark it as most recently used, update hit/miss statistics
+                 * @param hash hash of the key
+                 * @param match function to compare items with the key
+                 * @param key the key
+                 * @return pointer to the item or NULL if not found
+                 */
+                lru_item_t         *get(uint32_t hash, match_t match, const void *key);
+
+                /**
+                 * Free space for the new item by removing least recently used items
+                 * @param size size of the new item in bytes
+                 * @return false if the item is too large to be cached
+                 */
+                bool                reserve(size_t size);
+
+                /**
+                 * Insert the item as most recently used, the hash and size fields should be set
+                 * @param item item to insert
+                 * @return false if there is not enough memory, the item is not destroyed
+                 */
+                bool                insert(lru_item_t *item);
+
+                /**
+                 * Remove the item from the cache and destroy it
+                 * @param item item to remove
+                 */
+                void                remove(lru_item_t *item);
+
+                /**
+                 * Remove and destroy all items
+                 */
+                void                clear();
+
+                /**
+                 * Set maximum cache size, drop least recently used items if necessary
+                 * @param max_size maximum cache size
+                 * @return previous maximum cache size
+                 */
+                size_t              set_max_size(size_t max_size);
+
+                /**
+                 * Reset hit/miss statistics
+                 */
+                void                clear_stats();
+
+            public:
+                inline lru_item_t  *first() const       { return pHead;         }
+                inline size_t       size() const        { return nSize;         }
+                inline size_t       max_size() const    { return nMaxSize;      }
+                inline size_t       hits() const        { return nHits;         }
+                inline size_t       misses() const      { return nMisses;       }
+        };
+
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* PRIVATE_LRUCACHE_H_ */
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_DECIMATION_H_
+#define PRIVATE_DECIMATION_H_
+
+#include <lsp-plug.in/common/types.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        static constexpr size_t DECIMATION_MIN_POINTS   = 0x100;    // Minimum number of points to perform decimation
+        static constexpr size_t DECIMATION_DENSITY      = 4;        // Minimum number of points per pixel column
+
+        /**
+         * Check that the polyline is dense enough to be decimated before rendering
+         * @param x X coordinates of the polyline
+         * @param n number of points
+         * @return true if polyline should be decimated
+         */
+        LSP_HIDDEN_MODIFIER
+        bool        need_decimation(const float *x, size_t n);
+
+        /**
+         * Decimate the polyline: each run of consecutive points that fall into the same
+         * pixel column is replaced by it's first point, points with minimum and maximum
+         * Y coordinate and it's last point. Peaks of the polyline are preserved exactly.
+         * Destination buffers may be the same as source buffers.
+         *
+         * @param dx destination buffer to store X coordinates, should hold at least n elements
+         * @param dy destination buffer to store Y coordinates, should hold at least n elements
+         * @param x X coordinates of the polyline
+         * @param y Y coordinates of the polyline
+         * @param n number of points
+         * @return number of points after decimation
+         */
+        LSP_HIDDEN_MODIFIER
+        size_t      decimate_poly(float *dx, float *dy, const float *x, const float *y, size_t n);
+
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* PRIVATE_DECIMATION_H_ */
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_FREETYPE_DISKCACHE_H_
+#define PRIVATE_FREETYPE_DISKCACHE_H_
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/lltl/parray.h>
+
+#include <private/freetype/face.h>
+#include <private/freetype/glyph.h>
+#include <private/freetype/GlyphAllocator.h>
+#include <private/freetype/types.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            /**
+             * Persistent cache of rasterized glyphs. Glyphs of each strike (the font file, face index,
+             * size, flags and transformation) are stored in a separate file which is memory-mapped on
+             * the first glyph lookup. The strike file is valid only for the same size, beginning and
+             * modification time of the font file and the same version of FreeType library. Glyphs
+             * rendered by the font manager are collected in memory and written on flush(), the oldest
+             * strike files are removed when the total size of the cache exceeds the limit.
+             */
+            class LSP_HIDDEN_MODIFIER DiskCache
+            {
+                private:
+                    typedef struct key_t
+                    {
+                        uint64_t            font;           // Hash of the beginning of font data and font size
+                        int64_t             mtime;          // Modification time of the font file
+                        uint32_t            version;        // Version of the FreeType library
+                        uint32_t            index;          // Index of the face in the font file
+                        uint32_t            flags;          // Face flags
+                        int32_t             h_size;         // Horizontal size
+                        int32_t             v_size;         // Vertical size
+                        int32_t             matrix[4];      // Transformation matrix
+                        uint32_t            reserved;       // Reserved, should be zero
+                    } key_t;
+
+                    typedef struct header_t
+                    {
+                        char                signature[8];   // File signature
+                        uint32_t            count;          // Number of glyphs
+                        uint32_t            reserved;       // Reserved, should be zero
+                        key_t               key;            // The key of the strike
+                    } header_t;
+
+                    typedef struct entry_t
+                    {
+                        uint32_t            codepoint;      // Codepoint of the glyph
+                        uint32_t            offset;         // Offset of the glyph record from the beginning of file
+                    } entry_t;
+
+                    typedef struct record_t
+                    {
+                        uint32_t            codepoint;      // Codepoint of the glyph
+                        uint32_t            format;         // Format of the bitmap
+                        int32_t             width;          // Glyph width
+                        int32_t             height;         // Glyph height
+                        int32_t             x_advance;      // Advance by X
+                        int32_t             y_advance;      // Advance by Y
+                        int32_t             x_bearing;      // Bearing by X
+                        int32_t             y_bearing;      // Bearing by Y
+                        int32_t             lsb_delta;      // LSB delta
+                        int32_t             rsb_delta;      // RSB delta
+                        uint32_t            bm_width;       // Width of the bitmap
+                        uint32_t            bm_height;      // Height of the bitmap
+                        uint32_t            bm_stride;      // Stride of the bitmap, the bitmap data follows the record
+                        uint32_t            reserved;       // Reserved, should be zero
+                    } record_t;
+
+                    typedef struct strike_t
+                    {
+                        key_t               key;            // The key of the strike
+                        bool                loaded;         // The strike file has been loaded
+                        bool                mapped;         // The data is memory-mapped
+                        uint8_t            *data;           // Contents of the strike file
+                        size_t              size;           // Size of the strike file
+                        const entry_t      *index;          // Sorted index of glyphs
+                        size_t              count;          // Number of glyphs in the index
+                        lltl::parray<record_t> pending;     // Glyphs to be written to the file
+                    } strike_t;
+
+                    static constexpr size_t MAX_PENDING     = 0x400000;     // Maximum amount of memory for pending glyphs
+                    static constexpr size_t HASH_PREFIX     = 0x10000;      // Number of bytes of the font data to hash
+                    static constexpr wsize_t MAX_DISK_SIZE  = 0x4000000;    // Maximum total size of strike files
+                    static constexpr wssize_t STALE_TEMP_TIME = 3600 * 1000; // Time after which temporary files are removed, ms
+
+                private:
+                    io::Path                sPath;          // Directory with strike files
+                    bool                    bEnabled;       // The cache is enabled
+                    uint32_t                nVersion;       // Version of the FreeType library
+                    lltl::parray<strike_t>  vStrikes;       // Strikes
+                    size_t                  nPending;       // Amount of memory used by pending glyphs
+                    size_t                  nHits;          // Number of glyphs loaded from the cache
+                    size_t                  nMisses;        // Number of glyphs not found in the cache
+
+                private:
+                    static uint64_t         font_hash(font_t *font);
+                    static size_t           record_size(const record_t *rec);
+                    static const record_t  *find_record(const strike_t *s, lsp_wchar_t ch);
+                    static void             unload_strike(strike_t *s);
+                    static void             destroy_strike(strike_t *s);
+
+                    strike_t               *get_strike(face_t *face);
+                    status_t                strike_path(io::Path *path, const strike_t *s);
+                    void                    load_strike(strike_t *s);
+                    status_t                save_strike(strike_t *s);
+                    void                    trim();
+
+                public:
+                    DiskCache();
+                    DiskCache(const DiskCache &) = delete;
+                    DiskCache(DiskCache &&) = delete;
+                    ~DiskCache();
+                    DiskCache & operator = (const DiskCache &) = delete;
+                    DiskCache & operator = (DiskCache &&) = delete;
+
+                public:
+                    /**
+                     * Get default location of the cache
+                     * @param path pointer to store the location
+                     * @return status of operation
+                     */
+                    static status_t         default_path(io::Path *path);
+
+                    /**
+                     * Enable the cache, the strike files are loaded lazily
+                     * @param path directory to store strike files
+                     * @param version version of the FreeType library
+                     * @return status of operation
+                     */
+                    status_t                open(const io::Path *path, uint32_t version);
+
+                    /**
+                     * Write all pending glyphs to the strike files and remove the oldest strike files
+                     * if the total size of the cache exceeds the limit
+                     * @return status of operation
+                     */
+                    status_t                flush();
+
+                    /**
+                     * Disable the cache and drop all pending glyphs
+                     */
+                    void                    close();
+
+                    /**
+                     * Load the glyph from the strike file of the face
+                     * @param face the font face
+                     * @param ch the codepoint
+                     * @param alloc the allocator for the glyph, NULL for heap allocation
+                     * @return the loaded glyph or NULL if there is no glyph in the cache
+                     */
+                    glyph_t                *load(face_t *face, lsp_wchar_t ch, GlyphAllocator *alloc);
+
+                    /**
+                     * Remember the glyph rendered by FreeType to write it on flush()
+                     * @param glyph the glyph to store
+                     */
+                    void                    store(const glyph_t *glyph);
+
+                    /**
+                     * Reset hit/miss statistics
+                     */
+                    void                    clear_stats();
+
+                public:
+                    inline bool             enabled() const     { return bEnabled;      }
+                    inline size_t           pending() const     { return nPending;      }
+                    inline size_t           hits() const        { return nHits;         }
+                    inline size_t           misses() const      { return nMisses;       }
+            };
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
+
+#endif /* PRIVATE_FREETYPE_DISKCACHE_H_ */
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_FREETYPE_FONTINDEX_H_
+#define PRIVATE_FREETYPE_FONTINDEX_H_
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/lltl/pphash.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            /**
+             * Index of system fonts provided by fontconfig. The index maps the font family and
+             * the style (bold, italic) to the best matching font file. It is built once from the
+             * full list of system fonts and persisted on disk, the persisted copy is valid until
+             * the fontconfig configuration or font directories change.
+             */
+            class LSP_HIDDEN_MODIFIER FontIndex
+            {
+                public:
+                    typedef struct font_info_t
+                    {
+                        char               *family;         // Font family
+                        char               *path;           // Path to the font file
+                        char               *style;          // Font style
+                        int                 weight;         // Font weight
+                        int                 slant;          // Font slant
+                    } font_info_t;
+
+                private:
+                    lltl::pphash<char, font_info_t> vFonts;     // Fonts keyed by style selector and lower-case family
+                    uint64_t            nSignature;         // Signature of the fontconfig configuration
+                    bool                bInitialized;       // The index has been loaded or built
+
+                private:
+                    static char        *make_key(size_t flags, const char *family);
+                    static font_info_t *make_info(const char *family, const char *path, const char *style, int weight, int slant);
+                    static uint64_t     config_signature();
+                    static status_t     index_path(io::Path *path);
+
+                    bool                put(const char *key, font_info_t *info);
+                    void                init();
+                    status_t            build();
+                    status_t            load(const io::Path *path);
+                    status_t            save(const io::Path *path);
+                    void                drop();
+
+                public:
+                    FontIndex();
+                    FontIndex(const FontIndex &) = delete;
+                    FontIndex(FontIndex &&) = delete;
+                    ~FontIndex();
+                    FontIndex & operator = (const FontIndex &) = delete;
+                    FontIndex & operator = (FontIndex &&) = delete;
+
+                public:
+                    /**
+                     * Find the best matching system font. Builds or loads the index on first call.
+                     * @param family font family, NULL or empty string for the preferred default font
+                     * @param flags face flags, only FID_BOLD and FID_ITALIC are taken into account
+                     * @return font information or NULL if there is no matching font
+                     */
+                    const font_info_t  *find(const char *family, size_t flags);
+
+                    /**
+                     * Drop the index, it will be loaded again on the next lookup
+                     */
+                    void                clear();
+
+                    inline size_t       size() const        { return vFonts.size(); }
+            };
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
+
+#endif /* PRIVATE_FREETYPE_FONTINDEX_H_ */
@@ -30,12 +30,17 @@
 
 #include <private/freetype/types.h>
 #include <private/freetype/bitmap.h>
+#include <private/freetype/DiskCache.h>
 #include <private/freetype/face.h>
 #include <private/freetype/face_id.h>
+#include <private/freetype/FontIndex.h>
 #include <private/freetype/glyph.h>
 #include <private/freetype/library.h>
+#include <private/freetype/GlyphAllocator.h>
 #include <private/freetype/GlyphCache.h>
-#include <private/freetype/LRUCache.h>
+#include <private/freetype/GlyphRun.h>
+#include <private/freetype/Prefetcher.h>
+#include <private/freetype/TextCache.h>
 
 namespace lsp
 {
@@ -60,7 +65,13 @@ namespace lsp
                     lltl::darray<font_entry_t>          vFaces;
                     lltl::pphash<face_id_t, face_t>     vFontCache;
                     lltl::pphash<char, char>            vAliases;
-                    LRUCache                            sLRU;
+                    GlyphAllocator                      sAllocator;
+                    GlyphCache                          sGlyphs;
+                    TextCache                           sTextCache;
+                    FontIndex                           sFontIndex;
+                    Prefetcher                          sPrefetcher;
+                    DiskCache                           sDiskCache;
+                    GlyphRun                            sRun;
                     size_t                              nCacheSize;
                     size_t                              nMinCacheSize;
                     size_t                              nMaxCacheSize;
@@ -69,16 +80,22 @@ namespace lsp
                     size_t                              nGlyphHits;
                     size_t                              nGlyphMisses;
                     size_t                              nGlyphRemoval;
+                    size_t                              nSerial;
 
                 protected:
                     glyph_t                *get_glyph(face_t *face, lsp_wchar_t ch);
                     void                    invalidate_faces(const char *name);
                     void                    invalidate_face(face_t *face);
                     static bool             add_font_face(lltl::darray<font_entry_t> *entries, const char *name, face_t *face);
+                    status_t                add_faces(const char *name, lltl::parray<face_t> *loaded);
                     void                    dereference(face_t *face);
                     face_t                 *select_font_face(const Font *f);
                     face_t                 *find_face(const face_id_t *id);
                     face_t                 *lookup_face(const face_id_t *id);
+                    void                    sync_prefetched();
+                    bool                    build_run(face_t *face, GlyphRun *run, const LSPString *text, ssize_t first, ssize_t last);
+                    static dsp::bitmap_t   *composite(const GlyphRun *run);
+                    static void             emit(const GlyphRun *run, glyph_callback_t cb, void *arg);
 
                 public:
                     FontManager();
@@ -121,7 +138,28 @@ namespace lsp
                     bool                    get_text_parameters(const Font *f, text_range_t *tp, const LSPString *text, ssize_t first, ssize_t last);
 
                     /**
-                     * Render text to bitmap
+                     * Lay out the text: resolve glyphs and their positions in a single pass. The run
+                     * can be used for measuring and rendering the same text several times, it remains
+                     * valid until the font manager removes glyphs from the cache, see is_valid().
+                     * @param f font descriptor
+                     * @param run the glyph run to store the result
+                     * @param text the text to lay out
+                     * @param first first character of substring in the string
+                     * @param last last character of substring in the string
+                     * @return true if corresponding font has been found and text has been processed
+                     */
+                    bool                    layout_text(const Font *f, GlyphRun *run, const LSPString *text, ssize_t first, ssize_t last);
+
+                    /**
+                     * Check that glyphs referenced by the glyph run are still present in the cache
+                     * @param run the glyph run
+                     * @return true if the glyph run can be rendered
+                     */
+                    inline bool             is_valid(const GlyphRun *run) const     { return run->nSerial == nSerial; }
+
+                    /**
+                     * Render text to bitmap. The bitmap may be shared with the rendered text cache,
+                     * so it should not be modified and should be released with free_bitmap().
                      * @param f font descriptor
                      * @param text text to render
                      * @param first first character of substring in the string
@@ -130,6 +168,71 @@ namespace lsp
                      */
                     dsp::bitmap_t          *render_text(const Font *f, text_range_t *tp, const LSPString *text, ssize_t first, ssize_t last);
 
+                    /**
+                     * Render the laid out text to bitmap. The bitmap is not shared with the rendered text
+                     * cache and should be released with free_bitmap().
+                     * @param run the glyph run
+                     * @return pointer to bitmap or NULL if the run is empty or not valid anymore
+                     */
+                    dsp::bitmap_t          *render_text(const GlyphRun *run);
+
+                    /**
+                     * Render text as a run of glyphs without allocating the text bitmap. The callback is called
+                     * for each glyph of the text, the glyph remains valid only until the callback returns.
+                     * @param f font descriptor
+                     * @param tp pointer to store text parameters, may be NULL
+                     * @param text text to render
+                     * @param first first character of substring in the string
+                     * @param last last character of substring in the string
+                     * @param cb callback to render the glyph
+                     * @param arg argument to pass to the callback
+                     * @return true if corresponding font has been found and text has been processed
+                     */
+                    bool                    render_glyphs(const Font *f, text_range_t *tp, const LSPString *text, ssize_t first, ssize_t last,
+                                                glyph_callback_t cb, void *arg);
+
+                    /**
+                     * Pass glyphs of the laid out text to the callback
+                     * @param run the glyph run
+                     * @param cb callback to render the glyph
+                     * @param arg argument to pass to the callback
+                     * @return true if the run is valid and has been processed
+                     */
+                    bool                    render_glyphs(const GlyphRun *run, glyph_callback_t cb, void *arg);
+
+                    /**
+                     * Request background rasterization of the range of characters, the rendered glyphs
+                     * are added to the glyph cache by subsequent calls of the font manager
+                     * @param f font descriptor
+                     * @param first first character of the range
+                     * @param last last character of the range (inclusive)
+                     * @return status of operation, STATUS_OVERFLOW if there are too many pending requests
+                     */
+                    status_t                prefetch(const Font *f, lsp_wchar_t first, lsp_wchar_t last);
+
+                    /**
+                     * Get number of prefetch requests which were not completed yet
+                     * @return number of pending prefetch requests
+                     */
+                    inline size_t           prefetch_pending() const    { return sPrefetcher.pending(); }
+
+                    /**
+                     * Enable or disable the persistent cache of rendered glyphs. Pending glyphs of the
+                     * previously enabled cache are written to disk.
+                     * @param path directory to store the cache, NULL to disable the cache
+                     * @return status of operation
+                     */
+                    status_t                set_disk_cache(const io::Path *path);
+
+                    /**
+                     * Write glyphs rendered since the last flush to the persistent cache.
+                     * Called automatically on destroy().
+                     * @return status of operation
+                     */
+                    status_t                flush_disk_cache();
+
+                    inline bool             disk_cache_enabled() const  { return sDiskCache.enabled();  }
+
                 public: // Cache control and statistics
                     /**
                      * Perform garbage collection
@@ -143,12 +246,27 @@ namespace lsp
                     inline size_t           min_cache_size() const  { return nMinCacheSize; }
                     inline size_t           max_cache_size() const  { return nMaxCacheSize; }
                     inline size_t           used_cache_size() const { return nCacheSize;    }
+                    inline size_t           reserved_cache_size() const { return sAllocator.reserved(); }
+
+                    /**
+                     * Set the memory limit for the rendered text cache
+                     * @param size the maximum size of the cache in bytes
+                     * @return the previous limit
+                     */
+                    size_t                  set_text_cache_size(size_t size);
+
+                    inline size_t           text_cache_size() const         { return sTextCache.max_size(); }
+                    inline size_t           used_text_cache_size() const    { return sTextCache.size();     }
 
                     inline size_t           face_hits() const       { return nFaceHits;     }
                     inline size_t           face_misses() const     { return nFaceMisses;   }
                     inline size_t           glyph_hits() const      { return nGlyphHits;    }
                     inline size_t           glyph_misses() const    { return nGlyphMisses;  }
                     inline size_t           glyph_removal() const   { return nGlyphRemoval; }
+                    inline size_t           text_hits() const       { return sTextCache.hits();     }
+                    inline size_t           text_misses() const     { return sTextCache.misses();   }
+                    inline size_t           disk_hits() const       { return sDiskCache.hits();     }
+                    inline size_t           disk_misses() const     { return sDiskCache.misses();   }
                     void                    clear_cache_stats();
             };
 
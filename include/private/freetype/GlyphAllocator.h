@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_FREETYPE_GLYPHALLOCATOR_H_
+#define PRIVATE_FREETYPE_GLYPHALLOCATOR_H_
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/common/types.h>
+
+#include <private/freetype/glyph.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            /**
+             * Slab of glyphs: the block of memory split into slots of the same size
+             */
+            typedef struct glyph_slab_t
+            {
+                GlyphAllocator     *owner;          // Allocator that owns the slab
+                glyph_slab_t       *prev;           // Previous slab in the list of slabs with free slots
+                glyph_slab_t       *next;           // Next slab in the list of slabs with free slots
+                uint8_t            *free;           // List of released slots
+                size_t              sclass;         // Size class of the slab
+                size_t              used;           // Number of used slots
+                size_t              capacity;       // Overall number of slots
+                size_t              allocated;      // Number of slots ever allocated from the slab
+                size_t              size;           // Size of the slab including header
+                uint8_t            *data;           // Pointer to the first slot
+            } glyph_slab_t;
+
+            /**
+             * Allocator of glyphs. Glyphs are allocated from the slabs of fixed size classes,
+             * so the eviction of glyphs does not fragment the heap, and memory of slabs which
+             * became empty can be returned back to the system. Glyphs that do not fit into the
+             * largest size class get their own slab of the exact size.
+             */
+            class LSP_HIDDEN_MODIFIER GlyphAllocator
+            {
+                private:
+                    static constexpr size_t SLAB_SIZE           = 0x10000;      // Size of the slab
+                    static constexpr size_t CLASSES             = 11;           // Number of size classes
+                    static const size_t     vClassSize[CLASSES];                // Slot size of each size class
+
+                private:
+                    glyph_slab_t           *vPartial[CLASSES];  // Slabs with free slots for each size class
+                    glyph_slab_t           *vFull[CLASSES];     // Slabs without free slots for each size class
+                    glyph_slab_t           *pLarge;             // Dedicated slabs of large glyphs
+                    size_t                  nUsed;              // Size of allocated glyphs
+                    size_t                  nReserved;          // Overall size of slabs
+                    size_t                  nSlabs;             // Number of slabs
+
+                private:
+                    static size_t           size_class(size_t size);
+                    static inline void      unlink(glyph_slab_t **list, glyph_slab_t *slab);
+                    static inline void      link_first(glyph_slab_t **list, glyph_slab_t *slab);
+                    static inline void      link_last(glyph_slab_t **list, glyph_slab_t *slab);
+                    glyph_slab_t           *create_slab(size_t sclass, size_t size);
+                    void                    destroy_slab(glyph_slab_t **list, glyph_slab_t *slab);
+                    void                    release_slot(glyph_t *glyph);
+
+                public:
+                    GlyphAllocator();
+                    GlyphAllocator(const GlyphAllocator &) = delete;
+                    GlyphAllocator(GlyphAllocator &&) = delete;
+                    ~GlyphAllocator();
+
+                    GlyphAllocator & operator = (const GlyphAllocator &) = delete;
+                    GlyphAllocator & operator = (GlyphAllocator &&) = delete;
+
+                public:
+                    /**
+                     * Allocate memory for the glyph. The slab and szof fields of the glyph are initialized,
+                     * the szof field contains the actual size of memory used by the glyph.
+                     * @param size the minimum size of the glyph including it's bitmap data
+                     * @return pointer to the glyph or NULL if there is no memory
+                     */
+                    glyph_t                *allocate(size_t size);
+
+                    /**
+                     * Move the glyph allocated in the heap to the slab
+                     * @param glyph glyph to move, released on success
+                     * @return pointer to the moved glyph or NULL if there is no memory, the source glyph
+                     *   is kept untouched in this case
+                     */
+                    glyph_t                *move(glyph_t *glyph);
+
+                    /**
+                     * Release the glyph allocated by any allocator or in the heap
+                     * @param glyph glyph to release
+                     */
+                    static void             release(glyph_t *glyph);
+
+                    /**
+                     * Return memory of all empty slabs back to the system
+                     * @return number of released bytes
+                     */
+                    size_t                  trim();
+
+                public:
+                    inline size_t           used() const        { return nUsed;         }
+                    inline size_t           reserved() const    { return nReserved;     }
+                    inline size_t           slabs() const       { return nSlabs;        }
+            };
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
+
+#endif /* PRIVATE_FREETYPE_GLYPHALLOCATOR_H_ */
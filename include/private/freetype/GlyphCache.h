@@ -33,34 +33,93 @@ namespace lsp
         namespace ft
         {
             /**
-             * Glyph cache designed for storing glyphs for a singe font face
+             * Glyph cache shared between all font faces. The cache is an open-addressing hash table
+             * with linear probing keyed by the font face and the codepoint. Keys are stored in
+             * separate arrays to keep the lookup within few cache lines. The aging of glyphs is
+             * performed by the CLOCK (second chance) algorithm: the lookup only sets the reference
+             * bit of the glyph, the eviction clears reference bits until it finds the glyph that
+             * was not referenced since the previous pass.
              */
             class LSP_HIDDEN_MODIFIER GlyphCache
             {
                 protected:
-                    typedef struct bin_t
-                    {
-                        size_t      size;       // Number of used tuples in storage
-                        glyph_t    *data;       // List of glyphs
-                    } bin_t;
+                    static constexpr size_t MIN_CAPACITY        = 0x100;        // Minimum capacity of the table
 
                 protected:
-                    size_t          nSize;      // Overall size of the hash
-                    size_t          nCap;       // Capacity in bins
-                    bin_t          *vBins;      // Overall array of bins
+                    size_t              nSize;      // Number of glyphs in the cache
+                    size_t              nCap;       // Capacity of the table, power of two
+                    size_t              nHand;      // Position of the CLOCK hand
+                    uint8_t            *pData;      // Allocated data
+                    const face_t      **vFaces;     // Font faces (keys)
+                    lsp_wchar_t        *vCodes;     // Codepoints (keys)
+                    glyph_t           **vGlyphs;    // Glyphs (values), NULL for empty slots
+                    uint8_t            *vRefs;      // Reference bits
 
                 protected:
-                    bool            grow();
+                    static inline size_t    hash(const face_t *face, lsp_wchar_t codepoint);
+                    ssize_t                 index_of(const face_t *face, lsp_wchar_t codepoint) const;
+                    void                    remove_at(size_t index);
+                    bool                    rehash(size_t cap);
 
                 public:
                     GlyphCache();
+                    GlyphCache(const GlyphCache &) = delete;
+                    GlyphCache(GlyphCache &&) = delete;
                     ~GlyphCache();
 
+                    GlyphCache & operator = (const GlyphCache &) = delete;
+                    GlyphCache & operator = (GlyphCache &&) = delete;
+
                 public:
+                    /**
+                     * Remove all glyphs from the cache
+                     * @return list of removed glyphs linked by the cache_next field
+                     */
                     glyph_t        *clear();
+
+                    /**
+                     * Remove all glyphs of the font face from the cache
+                     * @param face font face
+                     * @return list of removed glyphs linked by the cache_next field
+                     */
+                    glyph_t        *remove_face(const face_t *face);
+
+                    /**
+                     * Put glyph to the cache, the glyph is keyed by it's face and codepoint
+                     * @param glyph glyph to put
+                     * @return true if glyph has been put, false if the glyph with the same key
+                     *   is already present or there is not enough memory
+                     */
                     bool            put(glyph_t *glyph);
+
+                    /**
+                     * Remove glyph from the cache
+                     * @param glyph glyph to remove
+                     * @return true if glyph has been removed
+                     */
                     bool            remove(glyph_t *glyph);
-                    glyph_t        *get(lsp_wchar_t codepoint);
+
+                    /**
+                     * Lookup for the glyph and mark it as recently used
+                     * @param face font face
+                     * @param codepoint the codepoint
+                     * @return pointer to glyph or NULL if not found
+                     */
+                    glyph_t        *get(const face_t *face, lsp_wchar_t codepoint);
+
+                    /**
+                     * Check that glyph is present in the cache, does not mark the glyph as recently used
+                     * @param face font face
+                     * @param codepoint the codepoint
+                     * @return true if glyph is present in the cache
+                     */
+                    bool            contains(const face_t *face, lsp_wchar_t codepoint) const;
+
+                    /**
+                     * Remove the glyph that was not used for a long time
+                     * @return removed glyph or NULL if the cache is empty
+                     */
+                    glyph_t        *evict();
 
                     inline size_t   size() const        { return nSize; }
                     inline size_t   capacity() const    { return nCap;  }
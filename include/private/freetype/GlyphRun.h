@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_FREETYPE_GLYPHRUN_H_
+#define PRIVATE_FREETYPE_GLYPHRUN_H_
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/lltl/darray.h>
+
+#include <private/freetype/glyph.h>
+#include <private/freetype/types.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            class FontManager;
+
+            /**
+             * Positioned glyph of the glyph run
+             */
+            typedef struct glyph_pos_t
+            {
+                const glyph_t  *glyph;      // The glyph
+                ssize_t         x;          // Horizontal position of the left edge of the glyph bitmap relative to the text origin
+                ssize_t         y;          // Vertical position of the top edge of the glyph bitmap relative to the text origin
+            } glyph_pos_t;
+
+            /**
+             * The run of glyphs of the laid out text. The glyphs are owned by the glyph cache of
+             * the font manager, so the run remains valid until the font manager removes any glyph
+             * from the cache. The run can be reused for laying out other text to avoid allocations.
+             */
+            class LSP_HIDDEN_MODIFIER GlyphRun
+            {
+                private:
+                    friend class FontManager;
+
+                private:
+                    lltl::darray<glyph_pos_t>   vGlyphs;    // Positioned glyphs
+                    const face_t               *pFace;      // The font face used for layout
+                    size_t                      nSerial;    // Serial number of the glyph cache state
+                    ssize_t                     nSkew;      // Additional width of the bitmap for slanted faces
+                    text_range_t                sRange;     // Text parameters
+
+                public:
+                    GlyphRun();
+                    GlyphRun(const GlyphRun &) = delete;
+                    GlyphRun(GlyphRun &&) = delete;
+                    ~GlyphRun();
+
+                    GlyphRun & operator = (const GlyphRun &) = delete;
+                    GlyphRun & operator = (GlyphRun &&) = delete;
+
+                public:
+                    /**
+                     * Drop all glyphs and release the memory
+                     */
+                    void                        clear();
+
+                    inline size_t               size() const    { return vGlyphs.size();    }
+                    inline const glyph_pos_t   *glyphs() const  { return vGlyphs.array();   }
+                    inline const glyph_pos_t   *glyph(size_t index) const { return vGlyphs.get(index); }
+                    inline const text_range_t  *range() const   { return &sRange;           }
+            };
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
+
+#endif /* PRIVATE_FREETYPE_GLYPHRUN_H_ */
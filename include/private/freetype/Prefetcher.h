@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_FREETYPE_PREFETCHER_H_
+#define PRIVATE_FREETYPE_PREFETCHER_H_
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/ipc/Condition.h>
+#include <lsp-plug.in/ipc/Thread.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/lltl/parray.h>
+
+#include <private/freetype/face.h>
+#include <private/freetype/glyph.h>
+#include <private/freetype/library.h>
+#include <private/freetype/types.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            /**
+             * Background glyph rasterizer. The worker thread uses it's own FreeType library
+             * and own instances of font faces opened from the shared font data, so it does not
+             * touch any FreeType object of the font manager. Completed jobs are passed back
+             * through the single-producer single-consumer ring, so the consumer never blocks.
+             */
+            class LSP_HIDDEN_MODIFIER Prefetcher
+            {
+                public:
+                    typedef struct job_t
+                    {
+                        face_t                     *face;       // Target face, referenced by the job, should not be accessed by worker
+                        const uint8_t              *data;       // The font data
+                        size_t                      size;       // The size of the font data
+                        FT_Long                     index;      // Index of the face in the font data
+                        size_t                      flags;      // Face flags
+                        f26p6_t                     h_size;     // The horizontal character size
+                        f26p6_t                     v_size;     // The verical character size
+                        FT_Matrix                   matrix;     // Transformation matrix
+                        lltl::darray<lsp_wchar_t>   chars;      // Characters to render
+                        lltl::parray<glyph_t>       glyphs;     // Rendered glyphs
+                    } job_t;
+
+                private:
+                    static constexpr size_t JOBS_MAX            = 32;           // Maximum number of outstanding jobs
+
+                private:
+                    library_t               sLibrary;           // FreeType library used by the worker
+                    ipc::Thread            *pThread;            // Worker thread
+                    ipc::Condition          sLock;              // Synchronization of the job queue
+                    lltl::parray<job_t>     vPending;           // Jobs waiting for the worker
+                    job_t                  *vDone[JOBS_MAX];    // Ring of completed jobs
+                    uatomic_t               nTail;              // Number of jobs completed by the worker
+                    uatomic_t               nHead;              // Number of jobs consumed by the owner
+                    size_t                  nJobs;              // Number of outstanding jobs
+
+                private:
+                    static status_t         execute(void *arg);
+                    status_t                run();
+                    void                    render(job_t *job);
+                    void                    complete(job_t *job);
+
+                public:
+                    Prefetcher();
+                    Prefetcher(const Prefetcher &) = delete;
+                    Prefetcher(Prefetcher &&) = delete;
+                    ~Prefetcher();
+                    Prefetcher & operator = (const Prefetcher &) = delete;
+                    Prefetcher & operator = (Prefetcher &&) = delete;
+
+                public:
+                    /**
+                     * Create the job for the face. The glyphs will be rendered with the same
+                     * parameters as the face has at the moment of the call.
+                     * @param face the target face
+                     * @return pointer to the job or NULL on error
+                     */
+                    static job_t           *create_job(face_t *face);
+
+                    /**
+                     * Destroy the job and all glyphs that are still stored in the job
+                     * @param job job to destroy
+                     */
+                    static void             destroy_job(job_t *job);
+
+                    /**
+                     * Submit job to the worker, start the worker if it is not running.
+                     * @param job job to submit, ownership is passed to the prefetcher on success
+                     * @return status of operation, STATUS_OVERFLOW if there are too many outstanding jobs
+                     */
+                    status_t                submit(job_t *job);
+
+                    /**
+                     * Get the next completed job, does not block
+                     * @return pointer to the completed job or NULL if there are no completed jobs,
+                     *   the ownership of the job is passed to the caller
+                     */
+                    job_t                  *poll();
+
+                    /**
+                     * Stop the worker. All outstanding jobs become available for poll(),
+                     * the jobs that were not processed have no glyphs rendered.
+                     */
+                    void                    stop();
+
+                    /**
+                     * Get number of outstanding jobs
+                     * @return number of jobs that were submitted but not polled yet
+                     */
+                    inline size_t           pending() const     { return nJobs; }
+            };
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
+
+#endif /* PRIVATE_FREETYPE_PREFETCHER_H_ */
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_FREETYPE_TEXTCACHE_H_
+#define PRIVATE_FREETYPE_TEXTCACHE_H_
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+#include <private/freetype/face.h>
+#include <private/freetype/types.h>
+#include <private/LRUCache.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            /**
+             * Bounded LRU cache of rendered text strings. The text is keyed by the font face
+             * and the UTF-32 representation of the string. The cache holds a reference to
+             * the rendered bitmap, the bitmap should not be modified by the caller.
+             */
+            class LSP_HIDDEN_MODIFIER TextCache
+            {
+                public:
+                    typedef struct text_t
+                    {
+                        lru_item_t          item;           // Item of the LRU cache, should be the first field
+                        const face_t       *face;           // Font face
+                        uint32_t            length;         // Length of the text in characters
+                        dsp::bitmap_t      *bitmap;         // Rendered bitmap
+                        text_range_t        range;          // Text parameters
+                        lsp_wchar_t        *text;           // The text
+                    } text_t;
+
+                private:
+                    static constexpr size_t BINS                = 0x100;        // Number of hash bins
+
+                    typedef struct key_t
+                    {
+                        const face_t       *face;           // Font face
+                        const lsp_wchar_t  *text;           // The text
+                        size_t              length;         // Length of the text in characters
+                    } key_t;
+
+                private:
+                    LRUCache            sCache;             // Cached text
+
+                private:
+                    static bool         match(const lru_item_t *item, const void *key);
+                    static void         destroy(lru_item_t *item);
+
+                public:
+                    TextCache(size_t max_size = default_text_cache_size);
+                    TextCache(const TextCache &) = delete;
+                    TextCache(TextCache &&) = delete;
+                    ~TextCache();
+                    TextCache & operator = (const TextCache &) = delete;
+                    TextCache & operator = (TextCache &&) = delete;
+
+                public:
+                    /**
+                     * Compute hash of the text
+                     * @param face font face
+                     * @param text the text
+                     * @param length length of the text
+                     * @return hash value
+                     */
+                    static uint32_t     hash(const face_t *face, const lsp_wchar_t *text, size_t length);
+
+                    /**
+                     * Lookup for the rendered text and mark it as most recently used
+                     * @param hash hash of the text
+                     * @param face font face
+                     * @param text the text
+                     * @param length length of the text
+                     * @return pointer to cached text or NULL if not found
+                     */
+                    const text_t       *get(uint32_t hash, const face_t *face, const lsp_wchar_t *text, size_t length);
+
+                    /**
+                     * Put rendered text to the cache, the cache adds reference to the bitmap
+                     * @param hash hash of the text
+                     * @param face font face
+                     * @param text the text
+                     * @param length length of the text
+                     * @param bitmap rendered bitmap
+                     * @param range text parameters
+                     * @return true if text has been put into the cache
+                     */
+                    bool                put(
+                        uint32_t hash, const face_t *face, const lsp_wchar_t *text, size_t length,
+                        dsp::bitmap_t *bitmap, const text_range_t *range);
+
+                    /**
+                     * Drop all text rendered with the specified font face
+                     * @param face font face
+                     */
+                    void                remove_face(const face_t *face);
+
+                    /**
+                     * Drop all cached text
+                     */
+                    void                clear();
+
+                    /**
+                     * Set maximum cache size, drop least recently used text if necessary
+                     * @param max_size maximum cache size
+                     * @return previous maximum cache size
+                     */
+                    size_t              set_max_size(size_t max_size);
+
+                    /**
+                     * Reset hit/miss statistics
+                     */
+                    void                clear_stats();
+
+                public:
+                    inline size_t       size() const        { return sCache.size();     }
+                    inline size_t       max_size() const    { return sCache.max_size(); }
+                    inline size_t       hits() const        { return sCache.hits();     }
+                    inline size_t       misses() const      { return sCache.misses();   }
+            };
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
+
+#endif /* PRIVATE_FREETYPE_TEXTCACHE_H_ */
@@ -40,7 +40,8 @@ namespace lsp
             size_t compute_bitmap_stride(size_t width);
 
             /**
-             * Create bitmap, 1 byte per pixel
+             * Create bitmap, 1 byte per pixel. The bitmap is reference-counted, the initial
+             * number of references is 1.
              * @param width width of the bitmap
              * @param height height of the bitmap
              * @return pointer to bitmap or NULL
@@ -48,6 +49,20 @@ namespace lsp
             LSP_HIDDEN_MODIFIER
             dsp::bitmap_t *create_bitmap(size_t width, size_t height);
 
+            /**
+             * Add reference to the bitmap. The bitmap is shared between all owners of
+             * references and should not be modified by them.
+             * @param bitmap bitmap to reference
+             * @return pointer to the bitmap
+             */
+            LSP_HIDDEN_MODIFIER
+            dsp::bitmap_t *reference_bitmap(dsp::bitmap_t *bitmap);
+
+            /**
+             * Release reference to the bitmap, the bitmap is destroyed when the last
+             * reference has been released. Can be called from any thread.
+             * @param bitmap bitmap to release
+             */
             LSP_HIDDEN_MODIFIER
             void free_bitmap(dsp::bitmap_t *bitmap);
 
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_FREETYPE_BLEND_H_
+#define PRIVATE_FREETYPE_BLEND_H_
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/common/types.h>
+
+#include <private/freetype/glyph.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            /**
+             * Convert colour to premultiplied ARGB32 pixel
+             * @param r red component [0..1]
+             * @param g green component [0..1]
+             * @param b blue component [0..1]
+             * @param a alpha component [0..1]
+             * @return premultiplied ARGB32 pixel
+             */
+            LSP_HIDDEN_MODIFIER
+            uint32_t premultiply_color(float r, float g, float b, float a);
+
+            /**
+             * Blend premultiplied colour over the row of ARGB32 pixels using 8-bit coverage values
+             * @param dst destination pixels
+             * @param cov coverage values, one byte per pixel
+             * @param color premultiplied ARGB32 colour
+             * @param count number of pixels to process
+             */
+            LSP_HIDDEN_MODIFIER
+            void blend_a8_argb32(uint32_t *dst, const uint8_t *cov, uint32_t color, size_t count);
+
+            /**
+             * Composite glyph with premultiplied colour over ARGB32 image, the glyph bitmap is
+             * used as coverage mask without conversion to 8 bits per pixel bitmap
+             * @param data pointer to the image data
+             * @param stride stride between image rows in bytes
+             * @param glyph the glyph to composite
+             * @param x horizontal position of the left edge of the glyph bitmap
+             * @param y vertical position of the top edge of the glyph bitmap
+             * @param l left edge of the clipping rectangle (inclusive)
+             * @param t top edge of the clipping rectangle (inclusive)
+             * @param r right edge of the clipping rectangle (exclusive)
+             * @param b bottom edge of the clipping rectangle (exclusive)
+             * @param color premultiplied ARGB32 colour
+             * @return true if the glyph intersects the clipping rectangle
+             */
+            LSP_HIDDEN_MODIFIER
+            bool blend_glyph(
+                uint8_t *data, size_t stride, const glyph_t *glyph, ssize_t x, ssize_t y,
+                ssize_t l, ssize_t t, ssize_t r, ssize_t b, uint32_t color);
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
+
+#endif /* PRIVATE_FREETYPE_BLEND_H_ */
@@ -27,6 +27,7 @@
 #include <lsp-plug.in/ws/ws.h>
 #include <lsp-plug.in/dsp/dsp.h>
 #include <lsp-plug.in/io/IInStream.h>
+#include <lsp-plug.in/io/Path.h>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -34,7 +35,6 @@
 #include <private/freetype/face_id.h>
 #include <private/freetype/library.h>
 #include <private/freetype/types.h>
-#include <private/freetype/GlyphCache.h>
 
 namespace lsp
 {
@@ -51,7 +51,8 @@ namespace lsp
             {
                 size_t      references;         // Number of references
                 size_t      cache_size;         // The amount of memory used by glyphs in cache
-                FT_Face     ft_face;            // The font face
+                FT_Face     ft_face;            // The font face, shared between faces of all sizes
+                FT_Size     ft_size;            // The size object of the face, NULL if not allocated yet
                 font_t     *font;               // The font data
 
                 size_t      flags;              // Face flags
@@ -61,8 +62,6 @@ namespace lsp
                 f26p6_t     height;             // The height of the font
                 f26p6_t     ascent;             // The ascender
                 f26p6_t     descent;            // The descender
-
-                GlyphCache  cache;              // Glyph cache
             } face_t;
 
             /**
@@ -75,6 +74,17 @@ namespace lsp
             LSP_HIDDEN_MODIFIER
             status_t    load_face(lltl::parray<face_t> *faces, library_t & ft, io::IInStream *is);
 
+            /**
+             * Load font face from file. The file is memory-mapped if possible, so the font data
+             * is shared with other processes and between all faces loaded from the file
+             * @param faces array to store all loaded font faces
+             * @param ft the FreeType library handle
+             * @param path path to the font file
+             * @return status of operation
+             */
+            LSP_HIDDEN_MODIFIER
+            status_t    load_face(lltl::parray<face_t> *faces, library_t & ft, const io::Path *path);
+
             /**
              * Create font face
              * @param ft the FreeType library handle
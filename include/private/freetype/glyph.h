@@ -34,6 +34,8 @@ namespace lsp
         namespace ft
         {
             struct face_t;
+            struct glyph_slab_t;
+            class GlyphAllocator;
 
             /**
              * Number of bits per pixel for a glyph
@@ -51,9 +53,8 @@ namespace lsp
              */
             typedef struct glyph_t
             {
-                glyph_t        *cache_next; // The pointer to the next item in the hash
-                glyph_t        *lru_next;   // Pointer to next glyph in the LRU cache
-                glyph_t        *lru_prev;   // Pointer to previous glyph in the LRU cache
+                glyph_t        *cache_next; // The pointer to the next item in the list of glyphs removed from cache
+                glyph_slab_t   *slab;       // The slab that holds the glyph, NULL if the glyph is allocated in the heap
 
                 face_t         *face;       // The pointer to the font face
                 lsp_wchar_t     codepoint;  // UTF-32 codepoint associated with the glyph
@@ -72,15 +73,25 @@ namespace lsp
                 dsp::bitmap_t   bitmap;     // The bitmap that stores the glyph data
             } glyph_t;
 
+            /**
+             * Callback for rendering the glyph run
+             * @param arg argument passed to the rendering function
+             * @param glyph glyph to render
+             * @param x horizontal position of the left edge of the glyph bitmap relative to the text origin
+             * @param y vertical position of the top edge of the glyph bitmap relative to the text origin
+             */
+            typedef void (*glyph_callback_t)(void *arg, const glyph_t *glyph, ssize_t x, ssize_t y);
+
             /**
              * Use the font face to load glyph and render it
              * @param ft freetype library
              * @param face the font face to load the glyph
              * @param ch UTF-32 codepoint of the glyph
+             * @param alloc allocator of the glyph, NULL to allocate the glyph in the heap
              * @return pointer to allocated glyph or NULL if no memory is available
              */
             LSP_HIDDEN_MODIFIER
-            glyph_t *render_glyph(library_t & ft, face_t *face, lsp_wchar_t ch);
+            glyph_t *render_glyph(library_t & ft, face_t *face, lsp_wchar_t ch, GlyphAllocator *alloc);
 
             /**
              * Free the glyph and data associated with it
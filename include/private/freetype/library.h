@@ -31,6 +31,7 @@
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
+#include FT_SIZES_H
 
 #include <lsp-plug.in/ipc/Library.h>
 
@@ -54,6 +55,10 @@ namespace lsp
                     decltype(&FT_Done_Face)         pDone_Face;
                     decltype(&FT_Reference_Face)    pReference_Face;
                     decltype(&FT_Set_Transform)     pSet_Transform;
+                    decltype(&FT_Set_Char_Size)     pSet_Char_Size;
+                    decltype(&FT_New_Size)          pNew_Size;
+                    decltype(&FT_Done_Size)         pDone_Size;
+                    decltype(&FT_Activate_Size)     pActivate_Size;
 
                     decltype(&FT_Load_Glyph)        pLoad_Glyph;
                     decltype(&FT_Bitmap_Embolden)   pBitmap_Embolden;
@@ -83,6 +88,10 @@ namespace lsp
                     FT_Error                        done_face(FT_Face face);
                     FT_Error                        reference_face(FT_Face face);
                     void                            set_transform(FT_Face face, FT_Matrix *matrix, FT_Vector*delta);
+                    FT_Error                        set_char_size(FT_Face face, FT_F26Dot6 width, FT_F26Dot6 height, FT_UInt h_res, FT_UInt v_res);
+                    FT_Error                        new_size(FT_Face face, FT_Size *size);
+                    FT_Error                        done_size(FT_Size size);
+                    FT_Error                        activate_size(FT_Size size);
                     FT_Error                        load_glyph(FT_Face face, FT_UInt glyph_index, FT_Int32 load_flags);
                     FT_Error                        outline_embolden(FT_Outline *outline, FT_Pos strength);
                     FT_Error                        bitmap_embolden(FT_Bitmap *bitmap, FT_Pos xStrength, FT_Pos yStrength);
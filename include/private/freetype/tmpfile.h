@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_FREETYPE_TMPFILE_H_
+#define PRIVATE_FREETYPE_TMPFILE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            /**
+             * Create temporary file next to the file to be replaced atomically with rename().
+             * The name of the temporary file is unique for the process and the call, so concurrent
+             * writers of the same file do not overwrite each other's temporary files.
+             * @param name pointer to store the native name of the temporary file
+             * @param path path to the file to be replaced
+             * @return opened for binary writing temporary file or NULL on error
+             */
+            LSP_HIDDEN_MODIFIER
+            FILE *create_temp_file(LSPString *name, const io::Path *path);
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* PRIVATE_FREETYPE_TMPFILE_H_ */
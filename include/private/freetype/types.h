@@ -46,6 +46,11 @@ namespace lsp
              */
             constexpr size_t            default_max_font_cache_size     = 2 * default_min_font_cache_size;
 
+            /**
+             * The default size of the rendered text cache for the font manager
+             */
+            constexpr size_t            default_text_cache_size         = 2 * 1024 * 1024;
+
             constexpr f26p6_t           f26p6_one               = 64;
             constexpr f26p6_t           f26p6_half              = 32;
             constexpr float             f26p6_divider           = 1.0f / 64.0f;
@@ -60,6 +65,9 @@ namespace lsp
                 size_t          references; // Number of references
                 size_t          size;       // The size of the font data
                 uint8_t        *data;       // The actual data for the font stored in memory
+                bool            mapped;     // The data is read-only memory mapping of the font file
+                int64_t         mtime;      // Modification time of the font file, zero if unknown
+                uint64_t        hash;       // Hash of the font data for the disk cache, zero if not computed yet
             } font_t;
 
             typedef struct text_range_t
@@ -126,6 +126,28 @@ namespace lsp
                      */
                     inline uint32_t next_vertex_index() const { return pCurrent->vertices.count; }
 
+                    /**
+                     * Position of the next index that will be allocated on addition call
+                     * @return position of the next index in the index buffer
+                     */
+                    inline uint32_t next_index_position() const { return pCurrent->indices.count; }
+
+                    /**
+                     * Get pointer to the vertex of the current draw. The pointer remains valid until the next
+                     * vertex allocation.
+                     * @param index index of the vertex
+                     * @return pointer to the vertex
+                     */
+                    inline const vertex_t *vertex_at(uint32_t index) const { return &pCurrent->vertices.v[index]; }
+
+                    /**
+                     * Get pointer to the index of the current draw. The pointer remains valid until the next
+                     * index allocation. The element size should be checked by issuing index_format() function.
+                     * @param position position of the index in the index buffer
+                     * @return pointer to the index
+                     */
+                    const void *index_at(uint32_t position) const;
+
                     /**
                      * Add new set of vertices
                      * @param count number of vertices to add
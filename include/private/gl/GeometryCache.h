@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_GL_GEOMETRYCACHE_H_
+#define PRIVATE_GL_GEOMETRYCACHE_H_
+
+#include <private/gl/defs.h>
+
+#ifdef LSP_PLUGINS_USE_OPENGL
+
+#include <lsp-plug.in/common/types.h>
+
+#include <private/gl/Actions.h>
+#include <private/gl/Data.h>
+#include <private/LRUCache.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace gl
+        {
+            /**
+             * Bounded LRU cache of tessellated polylines. The geometry is keyed by the
+             * coordinates of the polyline and it's width. Vertices are stored without
+             * draw command, indices are stored relative to the first vertex.
+             */
+            class LSP_HIDDEN_MODIFIER GeometryCache
+            {
+                public:
+                    static constexpr size_t DEFAULT_CACHE_SIZE  = 0x400000;     // Default cache size in bytes
+                    static constexpr size_t MIN_POINTS          = 0x10;         // Minimum number of points to cache
+
+                public:
+                    typedef struct geometry_t
+                    {
+                        lru_item_t          item;           // Item of the LRU cache, should be the first field
+                        uint32_t            count;          // Number of points
+                        float               width;          // Line width
+                        uint32_t            nvertices;      // Number of vertices
+                        uint32_t            nindices;       // Number of indices
+                        clip_rect_t         rect;           // Bounding rectangle
+                        float              *coords;         // Coordinates of the polyline (X then Y)
+                        vertex_t           *vertices;       // Vertices
+                        uint32_t           *indices;        // Indices relative to the first vertex
+                    } geometry_t;
+
+                private:
+                    static constexpr size_t BINS                = 0x100;        // Number of hash bins
+                    static constexpr size_t RECENT              = 0x40;         // Number of recently seen keys
+
+                    typedef struct key_t
+                    {
+                        const float        *coords;         // Coordinates of the polyline
+                        size_t              count;          // Number of points
+                        float               width;          // Line width
+                    } key_t;
+
+                private:
+                    LRUCache            sCache;             // Cached geometry
+                    uint32_t            vRecent[RECENT];    // Hashes of recently seen but not cached geometry
+                    size_t              nRecent;            // Next position in the list of recently seen hashes
+
+                private:
+                    static bool         match(const lru_item_t *item, const void *key);
+                    static void         destroy(lru_item_t *item);
+
+                public:
+                    GeometryCache(size_t max_size = DEFAULT_CACHE_SIZE);
+                    GeometryCache(const GeometryCache &) = delete;
+                    GeometryCache(GeometryCache &&) = delete;
+                    ~GeometryCache();
+                    GeometryCache & operator = (const GeometryCache &) = delete;
+                    GeometryCache & operator = (GeometryCache &&) = delete;
+
+                public:
+                    /**
+                     * Compute hash of the polyline
+                     * @param coords coordinates of the polyline: count X coordinates followed by count Y coordinates
+                     * @param count number of points
+                     * @param width width of the line
+                     * @return hash value
+                     */
+                    static uint32_t     hash(const float *coords, size_t count, float width);
+
+                    /**
+                     * Lookup for the cached geometry and mark it as most recently used
+                     * @param hash hash of the polyline
+                     * @param coords coordinates of the polyline
+                     * @param count number of points
+                     * @param width width of the line
+                     * @return pointer to cached geometry or NULL if not found
+                     */
+                    const geometry_t   *get(uint32_t hash, const float *coords, size_t count, float width);
+
+                    /**
+                     * Check that geometry is worth caching. The geometry is considered worth caching
+                     * if it has been requested at least twice during the short time period.
+                     * @param hash hash of the polyline
+                     * @return true if geometry should be cached
+                     */
+                    bool                admit(uint32_t hash);
+
+                    /**
+                     * Put geometry to the cache
+                     * @param hash hash of the polyline
+                     * @param coords coordinates of the polyline
+                     * @param count number of points
+                     * @param width width of the line
+                     * @param rect bounding rectangle of the geometry
+                     * @param v list of generated vertices
+                     * @param nv number of generated vertices
+                     * @param indices list of generated indices
+                     * @param format format of the index
+                     * @param vi the index of the first vertex, will be subtracted from each index
+                     * @param ni number of generated indices
+                     * @return true if geometry has been put into the cache
+                     */
+                    bool                put(
+                        uint32_t hash, const float *coords, size_t count, float width, const clip_rect_t & rect,
+                        const vertex_t *v, size_t nv,
+                        const void *indices, index_format_t format, uint32_t vi, size_t ni);
+
+                    /**
+                     * Drop all cached geometry
+                     */
+                    void                clear();
+
+                public:
+                    inline size_t       size() const        { return sCache.size();     }
+                    inline size_t       max_size() const    { return sCache.max_size(); }
+                    inline size_t       hits() const        { return sCache.hits();     }
+                    inline size_t       misses() const      { return sCache.misses();   }
+            };
+
+        } /* namespace gl */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* LSP_PLUGINS_USE_OPENGL */
+
+#endif /* PRIVATE_GL_GEOMETRYCACHE_H_ */
@@ -47,6 +47,10 @@ namespace lsp
 
             class LSP_HIDDEN_MODIFIER IContext
             {
+                private:
+                    static constexpr size_t UNPACK_BUFFERS      = 4;            // Number of pixel unpack buffers in the ring
+                    static constexpr size_t UNPACK_THRESHOLD    = 0x10000;      // Minimum image size to use pixel unpack buffer
+
                 protected:
                     typedef struct texture_t
                     {
@@ -72,6 +76,11 @@ namespace lsp
                     uint32_t            nCommandsSize;      // Size of the command texture
                     GLuint              nCommandsProcessor; // Commands processor
 
+                    GLuint              vUnpackIds[UNPACK_BUFFERS];     // Ring of pixel unpack buffers
+                    size_t              vUnpackSizes[UNPACK_BUFFERS];   // Capacity of pixel unpack buffers
+                    uint32_t            nUnpackIndex;       // Index of the next pixel unpack buffer in the ring
+                    bool                bUnpackBound;       // Pixel unpack buffer is currently bound
+
                 protected:
                     const gl::vtbl_t   *pVtbl;
 
@@ -177,6 +186,23 @@ namespace lsp
                      */
                     void unbind_empty_texture(GLuint processor_id, bool multisample);
 
+                    /**
+                     * Prepare pixel data for uploading to the texture. Large images are copied into the
+                     * next pixel unpack buffer of the ring which then becomes bound as GL_PIXEL_UNPACK_BUFFER,
+                     * so the driver can transfer the data to the texture asynchronously. Small images and
+                     * contexts without buffer mapping support use the client memory directly.
+                     *
+                     * @param buf pointer to the pixel data
+                     * @param size size of the pixel data in bytes
+                     * @return pointer to pass to glTexImage2D/glTexSubImage2D, should be followed by end_unpack() call
+                     */
+                    const void *begin_unpack(const void *buf, size_t size);
+
+                    /**
+                     * Unbind pixel unpack buffer bound by begin_unpack() call
+                     */
+                    void end_unpack();
+
                 public:
                     /**
                      * Activate context
@@ -33,6 +33,7 @@
 
 #include <private/gl/Allocator.h>
 #include <private/gl/Batch.h>
+#include <private/gl/GeometryCache.h>
 #include <private/gl/SurfaceContext.h>
 #include <private/gl/Texture.h>
 #include <private/gl/TextAllocator.h>
@@ -45,6 +46,9 @@ namespace lsp
         {
             class LSP_HIDDEN_MODIFIER Renderer
             {
+                protected:
+                    static constexpr size_t MAX_STREAK      = 4;        // Maximum number of surfaces taken ahead of older ones
+
                 protected:
                     enum cmd_color_t
                     {
@@ -77,9 +81,12 @@ namespace lsp
                     ipc::Condition                  sLock;
                     ipc::Thread                     sThread;
                     lltl::parray<SurfaceContext>    sQueue;
+                    ws::IDrawable                  *pActive;            // Drawable the context is currently bound to
+                    size_t                          nStreak;            // Number of surfaces taken ahead of the oldest one
                     gl::Allocator                   sAllocator;
                     gl::TextAllocator               sTextAllocator;
                     gl::Batch                       sBatch;
+                    gl::GeometryCache               sGeometry;
                     ws::rectangle_t                 sViewport;
                     gl::matrix_t                    sMatrix;
                     lltl::darray<gl::uniform_t>     vUniforms;
@@ -89,9 +96,10 @@ namespace lsp
 
                 protected:
                     status_t                setup_context(SurfaceContext *surface);
+                    void                    release_context();
                     status_t                run();
                     void                    do_destroy();
-                    SurfaceContext         *poll();
+                    SurfaceContext         *poll(bool wait);
                     status_t                render_batch(SurfaceContext *surface);
 
                 protected: // Drawing
@@ -128,6 +136,8 @@ namespace lsp
                     inline void             wire_polyline(vertex_t * & vertices, T * & indices, T vi, uint32_t ci, clip_rect_t &rect, const float *x, const float *y, float width, size_t n);
                     void                    wire_polyline(uint32_t ci, clip_rect_t &rect, const float *x, const float *y, float width, size_t n);
                     void                    wire_polyline(uint32_t ci, const float *x, const float *y, float width, size_t n);
+                    void                    wire_cached_polyline(uint32_t ci, clip_rect_t *rect, const float *coords, float width, size_t n);
+                    void                    replay_geometry(uint32_t ci, clip_rect_t *rect, const GeometryCache::geometry_t *g);
                     void                    wire_arc(uint32_t ci, float x, float y, float r, float a1, float a2, float width);
 
                 protected: // Event processing
@@ -52,6 +52,12 @@ namespace lsp
                 size_t vertex_realloc;
                 size_t index_alloc;
                 size_t index_realloc;
+                size_t context_switch;
+                size_t context_reuse;
+                size_t upload_direct;
+                size_t upload_buffered;
+                size_t geometry_hit;
+                size_t geometry_miss;
 
                 gl_stats_t();
             } gl_stats_t;
@@ -61,6 +61,7 @@ namespace lsp
 
                 protected:
                     static inline float    *copy_coords(const float *x, const float *y, size_t n);
+                    static inline float    *decimate_coords(const float *x, const float *y, size_t & n);
 
                 protected:
                     explicit Surface(IDisplay *display, SurfaceContext *context);
@@ -64,6 +64,7 @@ namespace lsp
                     inline GLuint       allocate_framebuffer();
                     inline GLuint       allocate_stencil();
                     inline void         deallocate_buffers();
+                    const void         *begin_upload(const void *buf, size_t width, size_t height, size_t stride, size_t pixel_size);
                     bool                bind_processor(GLuint processor_id);
                     bool                unbind_processor(GLuint processor_id);
 
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_GL_EXTRUDE_H_
+#define PRIVATE_GL_EXTRUDE_H_
+
+#include <private/gl/defs.h>
+
+#ifdef LSP_PLUGINS_USE_OPENGL
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/stdlib/math.h>
+
+#include <private/gl/Data.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace gl
+        {
+            static constexpr size_t EXTRUDE_CHUNK       = 0x100;    // Number of polyline segments processed at once
+
+            /**
+             * Emit vertices and indices of one polyline segment
+             * @param v pointer to the vertex buffer, advanced by the call
+             * @param iv pointer to the index buffer, advanced by the call
+             * @param vi index of the first vertex of the previous segment
+             * @param first true if there were no segments emitted yet
+             * @param ci draw command
+             * @param x0 X coordinate of the segment start
+             * @param y0 Y coordinate of the segment start
+             * @param x1 X coordinate of the segment end
+             * @param y1 Y coordinate of the segment end
+             * @param nx X offset of the extruded edges
+             * @param ny Y offset of the extruded edges
+             */
+            template <class T>
+            inline void extrude_polyline_segment(vertex_t * & v, T * & iv, T & vi, bool & first, uint32_t ci,
+                float x0, float y0, float x1, float y1, float nx, float ny)
+            {
+                v[0].x          = x1 - nx;
+                v[0].y          = y1 + ny;
+                v[1].x          = x1 + nx;
+                v[1].y          = y1 - ny;
+                v[2].x          = x0 + nx;
+                v[2].y          = y0 - ny;
+                v[3].x          = x0 - nx;
+                v[3].y          = y0 + ny;
+                for (size_t i=0; i<4; ++i)
+                {
+                    v[i].s          = 0.0f;
+                    v[i].t          = 0.0f;
+                    v[i].cmd        = ci;
+                }
+                v              += 4;
+
+                if (first)
+                {
+                    iv[0]           = vi;
+                    iv[1]           = vi + 1;
+                    iv[2]           = vi + 2;
+                    iv[3]           = vi;
+                    iv[4]           = vi + 2;
+                    iv[5]           = vi + 3;
+                    iv             += 6;
+                    first           = false;
+                }
+                else
+                {
+                    iv[0]           = vi + 4;
+                    iv[1]           = vi + 5;
+                    iv[2]           = vi + 6;
+                    iv[3]           = vi + 4;
+                    iv[4]           = vi + 6;
+                    iv[5]           = vi + 7;
+                    iv[6]           = vi;
+                    iv[7]           = vi + 6;
+                    iv[8]           = vi + 1;
+                    iv[9]           = vi;
+                    iv[10]          = vi + 1;
+                    iv[11]          = vi + 7;
+                    iv             += 12;
+                    vi             += 4;
+                }
+            }
+
+            /**
+             * Extrude the part of polyline point by point, segments shorter than 1e-5 are
+             * joined with the following segments
+             * @param v pointer to the vertex buffer, advanced by the call
+             * @param iv pointer to the index buffer, advanced by the call
+             * @param vi index of the first vertex of the previous segment
+             * @param first true if there were no segments emitted yet
+             * @param si index of the last emitted point
+             * @param ci draw command
+             * @param x X coordinates of the polyline
+             * @param y Y coordinates of the polyline
+             * @param hwidth half of the line width
+             * @param first_point index of the first point to process
+             * @param last_point index of the point after the last point to process
+             */
+            template <class T>
+            inline void extrude_polyline_points(vertex_t * & v, T * & iv, T & vi, bool & first, size_t & si, uint32_t ci,
+                const float *x, const float *y, float hwidth, size_t first_point, size_t last_point)
+            {
+                for (size_t i=first_point; i < last_point; ++i)
+                {
+                    const float dx  = x[i] - x[si];
+                    const float dy  = y[i] - y[si];
+                    const float d   = dx*dx + dy*dy;
+                    if (d <= 1e-10f)
+                        continue;
+
+                    const float kd  = hwidth / sqrtf(d);
+                    extrude_polyline_segment(v, iv, vi, first, ci, x[si], y[si], x[i], y[i], dy * kd, dx * kd);
+                    si              = i;
+                }
+            }
+
+            /**
+             * Extrude the polyline point by point. This is the reference implementation of the
+             * extrude_polyline() function
+             * @param v pointer to the vertex buffer, advanced by the call, should hold (n - 1) * 4 vertices
+             * @param iv pointer to the index buffer, advanced by the call, should hold (n - 1) * 12 indices
+             * @param vi index of the first vertex in the vertex buffer
+             * @param ci draw command
+             * @param x X coordinates of the polyline
+             * @param y Y coordinates of the polyline
+             * @param width line width
+             * @param n number of points
+             */
+            template <class T>
+            inline void extrude_polyline_scalar(vertex_t * & v, T * & iv, T vi, uint32_t ci, const float *x, const float *y, float width, size_t n)
+            {
+                if (n < 2)
+                    return;
+
+                size_t si       = 0;
+                bool first      = true;
+                extrude_polyline_points(v, iv, vi, first, si, ci, x, y, width * 0.5f, 1, n);
+            }
+
+            /**
+             * Extrude the polyline. Segments are processed in chunks of EXTRUDE_CHUNK with vectorized
+             * DSP functions, chunks that contain short segments are processed point by point. The
+             * output is the same as the output of extrude_polyline_scalar()
+             * @param v pointer to the vertex buffer, advanced by the call, should hold (n - 1) * 4 vertices
+             * @param iv pointer to the index buffer, advanced by the call, should hold (n - 1) * 12 indices
+             * @param vi index of the first vertex in the vertex buffer
+             * @param ci draw command
+             * @param x X coordinates of the polyline
+             * @param y Y coordinates of the polyline
+             * @param width line width
+             * @param n number of points
+             */
+            template <class T>
+            inline void extrude_polyline(vertex_t * & v, T * & iv, T vi, uint32_t ci, const float *x, const float *y, float width, size_t n)
+            {
+                if (n < 2)
+                    return;
+
+                float vdx[EXTRUDE_CHUNK];
+                float vdy[EXTRUDE_CHUNK];
+                float vkd[EXTRUDE_CHUNK];
+
+                width          *= 0.5f;
+                size_t si       = 0;        // Index of the last emitted point
+                bool first      = true;     // No segments have been emitted yet
+
+                for (size_t b=0; b < n - 1; )
+                {
+                    const size_t count  = lsp_min(n - 1 - b, EXTRUDE_CHUNK);
+                    const float *x0     = &x[b];
+                    const float *y0     = &y[b];
+                    const float *x1     = &x[b + 1];
+                    const float *y1     = &y[b + 1];
+
+                    // Compute direction vectors and squared lengths of segments
+                    dsp::sub3(vdx, x1, x0, count);
+                    dsp::sub3(vdy, y1, y0, count);
+                    dsp::sqr2(vkd, vdx, count);
+                    dsp::fmadd3(vkd, vdy, vdy, count);
+
+                    if ((si == b) && (dsp::min(vkd, count) > 1e-10f))
+                    {
+                        // Compute normals for all segments: nx = dy * w/d, ny = dx * w/d
+                        dsp::ssqrt1(vkd, count);
+                        dsp::rdiv_k2(vkd, width, count);
+                        dsp::mul2(vdx, vkd, count);
+                        dsp::mul2(vdy, vkd, count);
+
+                        // Emit vertices and indices
+                        for (size_t i=0; i<count; ++i)
+                            extrude_polyline_segment(v, iv, vi, first, ci, x0[i], y0[i], x1[i], y1[i], vdy[i], vdx[i]);
+
+                        si              = b + count;
+                    }
+                    else // There are short segments that should be skipped, process points one by one
+                        extrude_polyline_points(v, iv, vi, first, si, ci, x, y, width, b + 1, b + count + 1);
+
+                    b              += count;
+                }
+            }
+
+        } /* namespace gl */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* LSP_PLUGINS_USE_OPENGL */
+
+#endif /* PRIVATE_GL_EXTRUDE_H_ */
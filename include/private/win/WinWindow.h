@@ -126,6 +126,7 @@ namespace lsp
                 public:
                     virtual ISurface   *get_surface() override;
                     virtual status_t    invalidate() override;
+                    virtual status_t    invalidate(const rectangle_t *r) override;
                     virtual void       *handle() override;
 
                     virtual ssize_t     left() override;
@@ -27,6 +27,10 @@
 #if defined(USE_LIBX11) && defined(USE_LIBCAIRO)
 
 #include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/ipc/Condition.h>
+#include <lsp-plug.in/ipc/Thread.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/lltl/parray.h>
 
 #include <private/x11/X11Display.h>
 
@@ -36,6 +40,7 @@
 
 #include <cairo/cairo.h>
 #include <X11/Xlib.h>
+#include <X11/extensions/XShm.h>
 
 namespace lsp
 {
@@ -45,6 +50,79 @@ namespace lsp
         {
             class LSP_HIDDEN_MODIFIER X11CairoSurface: public ISurface
             {
+                protected:
+                    static constexpr size_t DAMAGE_MAX      = 0x10;     // Maximum number of damaged boxes
+                    static constexpr size_t ASYNC_FRAMES    = 2;        // Maximum number of frames queued for asynchronous rasterization
+                    static constexpr size_t BANDS_MAX       = 0x10;     // Maximum number of bands for tiled rasterization
+                    static constexpr size_t BAND_MIN_ROWS   = 0x40;     // Minimum number of rows in one band
+                    static constexpr size_t BACKING_STEP    = 0x100;    // Granularity of the back buffer size in pixels
+                    static constexpr size_t BACKING_SHRINK_FRAMES = 0x20; // Number of frames without resize before shrinking the back buffer
+                    static constexpr size_t SCALED_MAX      = 4;        // Maximum number of cached downscaled copies of the surface
+
+                protected:
+                    typedef struct damage_t
+                    {
+                        ssize_t                 l, t, r, b;     // Left, top, right and bottom bounds in device space
+                    } damage_t;
+
+                    typedef struct backing_t
+                    {
+                        XImage                 *image;          // Shared memory image, NULL if back buffer is allocated on heap
+                        XShmSegmentInfo         shm;            // Shared memory segment
+                        bool                    attached;       // Shared memory segment is attached to X server
+                        uint8_t                *heap;           // Heap-allocated pixel data
+                        uint8_t                *data;           // Pixel data
+                        size_t                  stride;         // Row stride in bytes
+                        size_t                  width;          // Capacity in pixels
+                        size_t                  height;         // Capacity in rows
+                    } backing_t;
+
+                    typedef struct clip_t
+                    {
+                        float                   x, y, w, h;     // Clipping rectangle in user space
+                        float                   ox, oy;         // Drawing origin at the moment of clipping
+                    } clip_t;
+
+                    typedef struct step_t
+                    {
+                        cairo_surface_t        *recording[BANDS_MAX]; // Recorded drawing commands for each band, NULL for clear step
+                        double                  l, t, r, b;     // Area to clear in device space
+                        double                  color[4];       // Clear color: red, green, blue and alpha
+                    } step_t;
+
+                    typedef struct frame_t
+                    {
+                        lltl::darray<step_t>    steps;          // Rasterization steps
+                        damage_t                damage[DAMAGE_MAX]; // Damaged areas
+                        size_t                  ndamage;        // Number of damaged areas
+                    } frame_t;
+
+                    typedef struct glyph_run_t
+                    {
+                        uint8_t                *data;           // Pixel data of the surface
+                        ssize_t                 stride;         // Row stride in bytes
+                        ssize_t                 x, y;           // Text origin in device space
+                        uint32_t                color;          // Premultiplied ARGB32 colour of the text
+                        damage_t                clip[DAMAGE_MAX];   // Clipping boxes in device space
+                        size_t                  nclip;          // Number of clipping boxes
+                        damage_t                bounds;         // Bounds of the modified area
+                    } glyph_run_t;
+
+                    typedef struct scaled_t
+                    {
+                        cairo_surface_t        *surface;        // Downscaled copy of the surface, NULL if not used
+                        size_t                  width;          // Width of the copy
+                        size_t                  height;         // Height of the copy
+                        size_t                  used;           // Serial number of the last use
+                    } scaled_t;
+
+                    typedef struct band_t
+                    {
+                        X11CairoSurface        *self;           // Owning surface
+                        ipc::Thread            *thread;         // Worker thread
+                        size_t                  index;          // Index of the band
+                    } band_t;
+
                 protected:
                     cairo_surface_t        *pRoot;
                     cairo_surface_t        *pSurface;
@@ -52,8 +130,45 @@ namespace lsp
                     cairo_font_options_t   *pFO;
                     X11Display             *pDisplay;
 
+                    Drawable                hDrawable;      // Target drawable for MIT-SHM presentation
+                    GC                      hGC;            // Graphic context for MIT-SHM presentation
+                    backing_t               sBacking;       // Back buffer of the window surface
+                    size_t                  nStableFrames;  // Number of frames drawn since the last resize
+                    bool                    bShmPending;    // X server may still read the shared memory segment
+                    damage_t                vDamage[DAMAGE_MAX];    // Damaged areas of the back buffer
+                    size_t                  nDamage;        // Number of damaged areas
+                    ws::rectangle_t         sRedraw;        // Redraw area to apply as clipping at begin()
+                    bool                    bRedrawPending; // Redraw area should be applied at begin()
+                    bool                    bRedrawActive;  // Redraw area is applied as clipping
+
+                    ipc::Thread            *pRasterizer;    // Asynchronous rasterization thread, NULL in synchronous mode
+                    ipc::Condition          sFrameLock;     // Synchronization of frame queue
+                    lltl::parray<frame_t>   vFrames;        // Frames queued for rasterization
+                    frame_t                *pFrame;         // Currently recorded frame
+                    cairo_surface_t        *vRecording[BANDS_MAX]; // Currently recorded segment of the frame, one copy per band
+                    lltl::darray<clip_t>    vClips;         // Clipping stack of the recorded frame
+
+                    band_t                  vBands[BANDS_MAX];  // Band workers, the first band is rasterized by the rasterization thread
+                    size_t                  nBands;         // Number of bands
+                    ipc::Condition          sBandLock;      // Synchronization of band workers
+                    frame_t                *pBandFrame;     // Frame to rasterize by band workers
+                    size_t                  nBandJob;       // Sequential number of the band job
+                    size_t                  nBandPending;   // Number of band workers that did not complete the job
+                    ssize_t                 nBandTop;       // Top of the area to rasterize
+                    ssize_t                 nBandBottom;    // Bottom of the area to rasterize
+                    ssize_t                 nBandRows;      // Number of rows per band
+                    bool                    bBandStop;      // Band workers should terminate
+
+                    scaled_t                vScaled[SCALED_MAX];    // Cached downscaled copies of the surface
+                    size_t                  nScaledUse;     // Serial number of the last use of downscaled copy
+                    size_t                  nScaledWidth;   // Width of the last requested copy that is not cached yet
+                    size_t                  nScaledHeight;  // Height of the last requested copy that is not cached yet
+
                     float                   fOriginX;
                     float                   fOriginY;
+                #ifdef USE_LIBFREETYPE
+                    ft::GlyphRun            sGlyphRun;      // Glyph run of the directly composited text
+                #endif /* USE_LIBFREETYPE */
                 #ifdef LSP_DEBUG
                     size_t                  nNumClips;
                 #endif /* LSP_DEBUG */
@@ -66,11 +181,60 @@ namespace lsp
                     } font_context_t;
 
                 protected:
+                    void                init_state(X11Display *dpy);
                     void                destroy_context(bool root);
+                    static void         init_backing(backing_t *b);
+                    bool                alloc_shm_backing(backing_t *b, size_t width, size_t height);
+                    bool                alloc_backing(backing_t *b, size_t width, size_t height);
+                    void                free_backing(backing_t *b);
+                    void                shrink_backing();
+                    static cairo_surface_t *wrap_backing(const backing_t *b, size_t width, size_t height);
+                    void                present(const damage_t *damage, size_t count, bool sync);
+                    void                setup_context(cairo_antialias_t aa);
+
+                    static status_t     rasterize_proc(void *arg);
+                    status_t            rasterize();
+                    void                rasterize_frame(frame_t *frame);
+                    void                rasterize_tiled(frame_t *frame);
+                    void                rasterize_band(const frame_t *frame, size_t index);
+                    static void         replay_frame(cairo_t *cr, const frame_t *frame, size_t index);
+                    static status_t     band_proc(void *arg);
+                    status_t            band_main(size_t index);
+                    status_t            start_bands(size_t count);
+                    void                stop_bands();
+                    void                wait_frames(size_t count);
+                    void                stop_rasterizer();
+                    static void         destroy_frame(frame_t *frame);
+                    bool                begin_segment(cairo_antialias_t aa);
+                    void                end_segment();
+                    void                destroy_segment();
+                    void                clear_async(double r, double g, double b, double a);
+                    cairo_surface_t    *scaled_copy(size_t width, size_t height);
+                    void                drop_scaled();
+
+                    void                add_damage(ssize_t l, ssize_t t, ssize_t r, ssize_t b);
+                    void                damage_user(double l, double t, double r, double b);
+                    inline void         damage_path(double extra);
+                    inline void         fill_path();
+                    inline void         fill_path_preserve();
+                    inline void         stroke_path();
+                    inline void         paint();
+                    inline void         paint_with_alpha(double alpha);
+                    inline void         mask_surface(cairo_surface_t *s, double x, double y);
+                    inline void         show_text(const char *text);
 
                     inline void         setSourceRGB(const Color &col);
                     inline void         setSourceRGBA(const Color &col);
                     void                drawRoundRect(float left, float top, float width, float height, float radius, size_t mask);
+                    bool                direct_clip(damage_t *clip, size_t *count, double *dx, double *dy);
+                    bool                fill_rect_fast(const Color &color, size_t mask, float radius, float left, float top, float width, float height);
+                #ifdef USE_LIBFREETYPE
+                    static bool         glyphs_overlap(const ft::GlyphRun *run);
+                    static void         draw_glyph(void *arg, const ft::glyph_t *glyph, ssize_t x, ssize_t y);
+                    bool                out_glyphs(
+                                            ft::FontManager *mgr, const Font &f, const Color &color, float x, float y,
+                                            ft::text_range_t *tr, const LSPString *text, ssize_t first, ssize_t last);
+                #endif /* USE_LIBFREETYPE */
                     void                set_current_font(font_context_t *ctx, const Font &f);
                     void                unset_current_font(font_context_t *ctx);
 
@@ -112,6 +276,34 @@ namespace lsp
 
                     virtual status_t resize(size_t width, size_t height) override;
 
+                    /**
+                     * Mark the area of the surface as damaged. Only damaged areas are copied to
+                     * the drawable by the end() call.
+                     * @param left left coordinate of the area
+                     * @param top top coordinate of the area
+                     * @param width width of the area
+                     * @param height height of the area
+                     */
+                    void                damage(ssize_t left, ssize_t top, ssize_t width, ssize_t height);
+
+                    /**
+                     * Set the redraw area of the surface. The area will be applied as clipping
+                     * between the next begin() and end() calls.
+                     * @param r redraw area, NULL to drop the redraw area if it has not been applied yet
+                     */
+                    void                set_redraw_area(const ws::rectangle_t *r);
+
+                    /**
+                     * Switch the surface to asynchronous mode: drawing commands are recorded between
+                     * begin() and end() calls and are rasterized and presented by the separate thread.
+                     * Image surfaces do not track damage and are rasterized entirely on each frame.
+                     * Should be called before the first begin() call.
+                     * @param threads number of threads used for rasterization, when greater than one,
+                     *   the damaged area is split into horizontal bands rasterized in parallel
+                     * @return status of operation
+                     */
+                    status_t            start_async(size_t threads = 1);
+
                 public:
                     virtual IDisplay *display() override;
 
@@ -35,9 +35,11 @@
 
 #include <time.h>
 #include <X11/Xlib.h>
+#include <X11/extensions/XShm.h>
 
 #include <private/gl/defs.h>
 #include <private/x11/X11Atoms.h>
+#include <private/x11/X11MetricsCache.h>
 #include <private/x11/X11Window.h>
 
 #ifdef USE_LIBFREETYPE
@@ -157,6 +159,14 @@ namespace lsp
                         bool                bSuccess;       // Success flag
                     } xsetinputfocus_t;
 
+                    typedef struct xshm_t
+                    {
+                        int                 nOpcode;        // Major opcode of MIT-SHM extension, negative if not usable
+                        bool                bChecked;       // Extension availability has been checked
+                        bool                bPending;       // XShmAttach request is pending
+                        bool                bSuccess;       // Success flag
+                    } xshm_t;
+
                     typedef struct dnd_proxy_t: public cb_common_t
                     {
                         Window              hTarget;        // The target window which has XDndProxy attribute
@@ -226,10 +236,12 @@ namespace lsp
                     lltl::parray<char>          vDndMimeTypes;
                     xtranslate_t                sTranslateReq;
                     xsetinputfocus_t            sSetInputFocusReq;
+                    xshm_t                      sShmReq;
 
                     lltl::darray<MonitorInfo>   vMonitors;
 
                     ISurface                   *pEstimation;        // Estimation surface
+                    X11MetricsCache             sMetrics;           // Cache of font and text measurements
 
                 protected:
                     void            decode_event(event_t *ue, XEvent *ev);
@@ -370,6 +382,20 @@ namespace lsp
 
                     bool                        set_input_focus(::Window wnd);
 
+                    /**
+                     * Check that MIT-SHM extension is available for the display
+                     * @return true if MIT-SHM extension is available
+                     */
+                    bool                        shm_supported();
+
+                    /**
+                     * Attach shared memory segment to the X server. If the attach fails (for example,
+                     * the display is remote), the MIT-SHM extension is considered to be not usable.
+                     * @param info shared memory segment
+                     * @return true if segment has been successfully attached
+                     */
+                    bool                        shm_attach(XShmSegmentInfo *info);
+
                     void                        flush();
 
                 public:
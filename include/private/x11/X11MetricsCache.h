@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef UI_X11_X11METRICSCACHE_H_
+#define UI_X11_X11METRICSCACHE_H_
+
+#include <lsp-plug.in/ws/version.h>
+
+#ifdef USE_LIBX11
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/ws/Font.h>
+#include <lsp-plug.in/ws/types.h>
+
+#include <private/LRUCache.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace x11
+        {
+            /**
+             * Bounded LRU cache of font and text measurements. The record is keyed by the font
+             * descriptor and the binary representation of the measured text, so the display can
+             * answer repeated measurement requests without accessing the estimation surface.
+             */
+            class LSP_HIDDEN_MODIFIER X11MetricsCache
+            {
+                public:
+                    enum key_type_t
+                    {
+                        KEY_FONT,                           // Font parameters, no text
+                        KEY_UTF8,                           // Text parameters of UTF-8 string
+                        KEY_UTF32                           // Text parameters of UTF-32 string
+                    };
+
+                    typedef union params_t
+                    {
+                        font_parameters_t   font;           // Font parameters
+                        text_parameters_t   text;           // Text parameters
+                    } params_t;
+
+                    typedef struct metrics_t
+                    {
+                        lru_item_t          item;           // Item of the LRU cache, should be the first field
+                        uint32_t            type;           // Type of the key
+                        float               fsize;          // Font size
+                        size_t              flags;          // Font flags
+                        size_t              nlength;        // Length of the font name in bytes
+                        size_t              tlength;        // Length of the text in bytes
+                        params_t            params;         // Measured parameters
+                        char               *name;           // Font name
+                        uint8_t            *text;           // The text
+                    } metrics_t;
+
+                    static constexpr size_t DEFAULT_MAX_SIZE    = 0x40000;      // Default cache size
+
+                private:
+                    static constexpr size_t BINS                = 0x400;        // Number of hash bins
+
+                    typedef struct key_t
+                    {
+                        uint32_t            type;           // Type of the key
+                        float               fsize;          // Font size
+                        size_t              flags;          // Font flags
+                        const char         *name;           // Font name
+                        size_t              nlength;        // Length of the font name in bytes
+                        const void         *text;           // The text
+                        size_t              tlength;        // Length of the text in bytes
+                    } key_t;
+
+                private:
+                    LRUCache            sCache;             // Cached measurements
+
+                private:
+                    static bool         match(const lru_item_t *item, const void *key);
+                    static void         destroy(lru_item_t *item);
+
+                public:
+                    X11MetricsCache(size_t max_size = DEFAULT_MAX_SIZE);
+                    X11MetricsCache(const X11MetricsCache &) = delete;
+                    X11MetricsCache(X11MetricsCache &&) = delete;
+                    ~X11MetricsCache();
+                    X11MetricsCache & operator = (const X11MetricsCache &) = delete;
+                    X11MetricsCache & operator = (X11MetricsCache &&) = delete;
+
+                public:
+                    /**
+                     * Compute hash of the key
+                     * @param f font descriptor, should have non-NULL name
+                     * @param type type of the key
+                     * @param text the text
+                     * @param length length of the text in bytes
+                     * @return hash value
+                     */
+                    static uint32_t     hash(const Font &f, key_type_t type, const void *text, size_t length);
+
+                    /**
+                     * Lookup for the measurements and mark them as most recently used
+                     * @param hash hash of the key
+                     * @param f font descriptor
+                     * @param type type of the key
+                     * @param text the text
+                     * @param length length of the text in bytes
+                     * @return pointer to cached parameters or NULL if not found
+                     */
+                    const params_t     *get(uint32_t hash, const Font &f, key_type_t type, const void *text, size_t length);
+
+                    /**
+                     * Put measurements to the cache
+                     * @param hash hash of the key
+                     * @param f font descriptor
+                     * @param type type of the key
+                     * @param text the text
+                     * @param length length of the text in bytes
+                     * @param params measured parameters
+                     * @return true if measurements have been put into the cache
+                     */
+                    bool                put(uint32_t hash, const Font &f, key_type_t type, const void *text, size_t length, const params_t *params);
+
+                    /**
+                     * Drop all cached measurements
+                     */
+                    void                clear();
+
+                    /**
+                     * Set maximum cache size, drop least recently used records if necessary
+                     * @param max_size maximum cache size
+                     * @return previous maximum cache size
+                     */
+                    size_t              set_max_size(size_t max_size);
+
+                    /**
+                     * Reset hit/miss statistics
+                     */
+                    void                clear_stats();
+
+                public:
+                    inline size_t       size() const        { return sCache.size();     }
+                    inline size_t       max_size() const    { return sCache.max_size(); }
+                    inline size_t       hits() const        { return sCache.hits();     }
+                    inline size_t       misses() const      { return sCache.misses();   }
+            };
+
+        } /* namespace x11 */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBX11 */
+
+#endif /* UI_X11_X11METRICSCACHE_H_ */
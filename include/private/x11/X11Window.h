@@ -78,6 +78,7 @@ namespace lsp
                     bool                bVisible;
                     bool                bInvalidated;
 
+                    rectangle_t         sInvalid;           // Invalidated area, empty means the whole window
                     rectangle_t         sCurrentSize;
                     rectangle_t         sSize;
                     size_limit_t        sConstraints;
@@ -89,6 +90,7 @@ namespace lsp
                     static bool         check_click(const btn_event_t *ev);
                     static bool         check_double_click(const btn_event_t *pe, const btn_event_t *ce);
                     void                send_focus_event();
+                    void                add_invalid_area(ssize_t left, ssize_t top, ssize_t width, ssize_t height);
 
                 protected:
 
@@ -120,6 +122,7 @@ namespace lsp
                 public:
                     virtual ISurface   *get_surface() override;
                     virtual status_t    invalidate() override;
+                    virtual status_t    invalidate(const rectangle_t *r) override;
 
                     virtual ssize_t     left() override;
                     virtual ssize_t     top() override;
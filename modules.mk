@@ -190,6 +190,10 @@ LIBX11_VERSION             := system
 LIBX11_NAME                := x11
 LIBX11_TYPE                := pkg
 
+LIBXEXT_VERSION            := system
+LIBXEXT_NAME               := xext
+LIBXEXT_TYPE               := pkg
+
 LIBXRANDR_VERSION          := system
 LIBXRANDR_NAME             := xrandr
 LIBXRANDR_TYPE             := pkg
@@ -451,5 +451,10 @@ namespace lsp
             return STATUS_NOT_IMPLEMENTED;
         }
 
+        status_t IWindow::invalidate(const rectangle_t *r)
+        {
+            return invalidate();
+        }
+
     } /* namespace ws */
 } /* namespace lsp */
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+
+#include <private/LRUCache.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        LRUCache::LRUCache(size_t bins, size_t max_size, destroy_t destroy)
+        {
+            vBins                   = NULL;
+            nBins                   = bins;
+            pHead                   = NULL;
+            pTail                   = NULL;
+            pDestroy                = destroy;
+            nSize                   = 0;
+            nMaxSize                = max_size;
+            nHits                   = 0;
+            nMisses                 = 0;
+        }
+
+        LRUCache::~LRUCache()
+        {
+            clear();
+            if (vBins != NULL)
+            {
+                free(vBins);
+                vBins                   = NULL;
+            }
+        }
+
+        inline void LRUCache::unlink(lru_item_t *item)
+        {
+            if (item->prev != NULL)
+                item->prev->next    = item->next;
+            else
+                pHead               = item->next;
+            if (item->next != NULL)
+                item->next->prev    = item->prev;
+            else
+                pTail               = item->prev;
+
+            item->prev          = NULL;
+            item->next          = NULL;
+        }
+
+        inline void LRUCache::link_first(lru_item_t *item)
+        {
+            item->prev          = NULL;
+            item->next          = pHead;
+            if (pHead != NULL)
+                pHead->prev         = item;
+            else
+                pTail               = item;
+            pHead               = item;
+        }
+
+        lru_item_t *LRUCache::get(uint32_t hash, match_t match, const void *key)
+        {
+            if (vBins != NULL)
+            {
+                for (lru_item_t *item = vBins[hash & (nBins - 1)]; item != NULL; item = item->hnext)
+                {
+                    if ((item->hash != hash) || (!match(item, key)))
+                        continue;
+
+                    // Move to the head of LRU list
+                    if (item != pHead)
+                    {
+                        unlink(item);
+                        link_first(item);
+                    }
+
+                    ++nHits;
+                    return item;
+                }
+            }
+
+            ++nMisses;
+            return NULL;
+        }
+
+        bool LRUCache::reserve(size_t size)
+        {
+            if (size > (nMaxSize >> 2))
+                return false;
+
+            while ((pTail != NULL) && ((nSize + size) > nMaxSize))
+                remove(pTail);
+
+            return true;
+        }
+
+        bool LRUCache::insert(lru_item_t *item)
+        {
+            if (vBins == NULL)
+            {
+                vBins                   = static_cast<lru_item_t **>(calloc(nBins, sizeof(lru_item_t *)));
+                if (vBins == NULL)
+                    return false;
+            }
+
+            lru_item_t **bin        = &vBins[item->hash & (nBins - 1)];
+            item->hnext             = *bin;
+            *bin                    = item;
+            link_first(item);
+            nSize                  += item->size;
+
+            return true;
+        }
+
+        void LRUCache::remove(lru_item_t *item)
+        {
+            // Remove from hash bin
+            for (lru_item_t **pi = &vBins[item->hash & (nBins - 1)]; *pi != NULL; pi = &(*pi)->hnext)
+            {
+                if (*pi == item)
+                {
+                    *pi                 = item->hnext;
+                    break;
+                }
+            }
+
+            // Remove from LRU list
+            unlink(item);
+            nSize              -= item->size;
+
+            pDestroy(item);
+        }
+
+        void LRUCache::clear()
+        {
+            for (lru_item_t *item = pHead; item != NULL; )
+            {
+                lru_item_t *next    = item->next;
+                pDestroy(item);
+                item                = next;
+            }
+
+            if (vBins != NULL)
+            {
+                for (size_t i=0; i<nBins; ++i)
+                    vBins[i]            = NULL;
+            }
+
+            pHead                   = NULL;
+            pTail                   = NULL;
+            nSize                   = 0;
+        }
+
+        size_t LRUCache::set_max_size(size_t max_size)
+        {
+            const size_t old_size   = nMaxSize;
+            nMaxSize                = max_size;
+
+            while ((pTail != NULL) && (nSize > nMaxSize))
+                remove(pTail);
+
+            return old_size;
+        }
+
+        void LRUCache::clear_stats()
+        {
+            nHits                   = 0;
+            nMisses                 = 0;
+        }
+
+    } /* namespace ws */
+} /* namespace lsp */
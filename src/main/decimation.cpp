@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/stdlib/math.h>
+
+#include <private/decimation.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        bool need_decimation(const float *x, size_t n)
+        {
+            if (n < DECIMATION_MIN_POINTS)
+                return false;
+
+            float min, max;
+            dsp::minmax(x, n, &min, &max);
+
+            // Decimate only if there are more points than the polyline can show
+            const float columns = max - min + 1.0f;
+            return (columns >= 0.0f) && (float(n) > columns * DECIMATION_DENSITY);
+        }
+
+        size_t decimate_poly(float *dx, float *dy, const float *x, const float *y, size_t n)
+        {
+            size_t count = 0;
+
+            for (size_t i=0; i<n; )
+            {
+                // Find the run of points within the same pixel column
+                const float column  = floorf(x[i]);
+                size_t first        = i;
+                size_t imin         = i;
+                size_t imax         = i;
+
+                for (++i; (i < n) && (floorf(x[i]) == column); ++i)
+                {
+                    if (y[i] < y[imin])
+                        imin                = i;
+                    if (y[i] > y[imax])
+                        imax                = i;
+                }
+
+                // Emit first point, extremums and last point in the original order
+                const size_t last   = i - 1;
+                const size_t a      = lsp_min(imin, imax);
+                const size_t b      = lsp_max(imin, imax);
+
+                dx[count]           = x[first];
+                dy[count++]         = y[first];
+                if (a > first)
+                {
+                    dx[count]           = x[a];
+                    dy[count++]         = y[a];
+                }
+                if (b > a)
+                {
+                    dx[count]           = x[b];
+                    dy[count++]         = y[b];
+                }
+                if (last > b)
+                {
+                    dx[count]           = x[last];
+                    dy[count++]         = y[last];
+                }
+            }
+
+            return count;
+        }
+
+    } /* namespace ws */
+} /* namespace lsp */
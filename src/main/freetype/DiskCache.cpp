@@ -0,0 +1,681 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/io/Dir.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/runtime/system.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/freetype/DiskCache.h>
+#include <private/freetype/tmpfile.h>
+
+#ifdef PLATFORM_POSIX
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif /* PLATFORM_POSIX */
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            static const char strike_signature[8]   = { 'L', 'S', 'P', 'G', 'L', 'Y', 'F', '1' };
+
+            typedef struct strike_item_t
+            {
+                uint32_t            codepoint;
+                const void         *record;
+            } strike_item_t;
+
+            typedef struct cache_file_t
+            {
+                io::Path            path;
+                wsize_t             size;
+                wssize_t            mtime;
+            } cache_file_t;
+
+            static ssize_t cmp_strike_items(const strike_item_t *a, const strike_item_t *b)
+            {
+                return (a->codepoint < b->codepoint) ? -1 : (a->codepoint > b->codepoint) ? 1 : 0;
+            }
+
+            static ssize_t cmp_cache_files(const cache_file_t *a, const cache_file_t *b)
+            {
+                return (a->mtime < b->mtime) ? -1 : (a->mtime > b->mtime) ? 1 : 0;
+            }
+
+            static bool has_suffix(const LSPString *s, const char *suffix)
+            {
+                const size_t len = strlen(suffix);
+                if (s->length() < len)
+                    return false;
+
+                for (size_t i=0, off=s->length() - len; i<len; ++i)
+                    if (s->char_at(off + i) != lsp_wchar_t(uint8_t(suffix[i])))
+                        return false;
+                return true;
+            }
+
+            DiskCache::DiskCache()
+            {
+                bEnabled            = false;
+                nVersion            = 0;
+                nPending            = 0;
+                nHits               = 0;
+                nMisses             = 0;
+            }
+
+            DiskCache::~DiskCache()
+            {
+                close();
+            }
+
+            status_t DiskCache::default_path(io::Path *path)
+            {
+                status_t res;
+                LSPString dir;
+
+                if ((system::get_env_var("XDG_CACHE_HOME", &dir) == STATUS_OK) && (!dir.is_empty()))
+                    res     = path->set(&dir);
+                else
+                {
+                    if ((res = system::get_env_var("HOME", &dir)) != STATUS_OK)
+                        return res;
+                    if ((res = path->set(&dir)) == STATUS_OK)
+                        res     = path->append_child(".cache");
+                }
+
+                if (res == STATUS_OK)
+                    res     = path->append_child("lsp-ws-lib");
+                if (res == STATUS_OK)
+                    res     = path->append_child("glyphs");
+
+                return res;
+            }
+
+            uint64_t DiskCache::font_hash(font_t *font)
+            {
+                if (font->hash != 0)
+                    return font->hash;
+
+                // FNV-1a over 64-bit words of the beginning of font data and the size of the font. The
+                // beginning of font file contains the table directory with checksums of all tables, the
+                // modification time of the font file is checked separately, so the whole file is not read.
+                const uint8_t *p    = font->data;
+                const size_t bytes  = lsp_min(font->size, size_t(HASH_PREFIX));
+                const size_t words  = bytes >> 3;
+                uint64_t h          = 0xcbf29ce484222325ULL;
+                uint64_t w;
+
+                for (size_t i=0; i<words; ++i, p += sizeof(uint64_t))
+                {
+                    memcpy(&w, p, sizeof(w));
+                    h                   = (h ^ w) * 0x100000001b3ULL;
+                }
+                for (size_t i=words << 3; i<bytes; ++i, ++p)
+                    h                   = (h ^ *p) * 0x100000001b3ULL;
+                h                   = (h ^ uint64_t(font->size)) * 0x100000001b3ULL;
+
+                font->hash          = (h != 0) ? h : 1;
+                return font->hash;
+            }
+
+            size_t DiskCache::record_size(const record_t *rec)
+            {
+                return align_size(sizeof(record_t) + size_t(rec->bm_stride) * rec->bm_height, sizeof(uint32_t));
+            }
+
+            const DiskCache::record_t *DiskCache::find_record(const strike_t *s, lsp_wchar_t ch)
+            {
+                // Binary search in the sorted index
+                ssize_t first = 0, last = ssize_t(s->count) - 1;
+                while (first <= last)
+                {
+                    const ssize_t mid       = (first + last) >> 1;
+                    const entry_t *e        = &s->index[mid];
+                    if (e->codepoint < ch)
+                        first                   = mid + 1;
+                    else if (e->codepoint > ch)
+                        last                    = mid - 1;
+                    else
+                    {
+                        // Validate the record
+                        const size_t offset     = e->offset;
+                        if ((offset & (sizeof(uint32_t) - 1)) || ((offset + sizeof(record_t)) > s->size))
+                            return NULL;
+                        const record_t *rec     = reinterpret_cast<const record_t *>(&s->data[offset]);
+                        if ((rec->codepoint != ch) || (rec->format > FMT_8_BPP))
+                            return NULL;
+                        if (size_t(rec->bm_stride) < ((size_t(rec->bm_width) << rec->format) + 7) >> 3)
+                            return NULL;
+                        if ((offset + sizeof(record_t) + size_t(rec->bm_stride) * rec->bm_height) > s->size)
+                            return NULL;
+                        return rec;
+                    }
+                }
+
+                return NULL;
+            }
+
+            void DiskCache::unload_strike(strike_t *s)
+            {
+                if (s->data != NULL)
+                {
+                #ifdef PLATFORM_POSIX
+                    if (s->mapped)
+                        ::munmap(s->data, s->size);
+                    else
+                        free(s->data);
+                #else
+                    free(s->data);
+                #endif /* PLATFORM_POSIX */
+                }
+
+                s->loaded           = false;
+                s->mapped           = false;
+                s->data             = NULL;
+                s->size             = 0;
+                s->index            = NULL;
+                s->count            = 0;
+            }
+
+            void DiskCache::destroy_strike(strike_t *s)
+            {
+                if (s == NULL)
+                    return;
+
+                unload_strike(s);
+                for (size_t i=0, n=s->pending.size(); i<n; ++i)
+                    free(s->pending.uget(i));
+                s->pending.flush();
+                delete s;
+            }
+
+            DiskCache::strike_t *DiskCache::get_strike(face_t *face)
+            {
+                // Make the key
+                key_t key;
+                bzero(&key, sizeof(key));
+                key.font            = font_hash(face->font);
+                key.mtime           = face->font->mtime;
+                key.version         = nVersion;
+                key.index           = uint32_t(face->ft_face->face_index);
+                key.flags           = uint32_t(face->flags);
+                key.h_size          = face->h_size;
+                key.v_size          = face->v_size;
+                key.matrix[0]       = int32_t(face->matrix.xx);
+                key.matrix[1]       = int32_t(face->matrix.xy);
+                key.matrix[2]       = int32_t(face->matrix.yx);
+                key.matrix[3]       = int32_t(face->matrix.yy);
+
+                // Lookup for existing strike
+                for (size_t i=0, n=vStrikes.size(); i<n; ++i)
+                {
+                    strike_t *s         = vStrikes.uget(i);
+                    if (memcmp(&s->key, &key, sizeof(key)) == 0)
+                        return s;
+                }
+
+                // Create new strike
+                strike_t *s         = new strike_t;
+                if (s == NULL)
+                    return NULL;
+
+                s->key              = key;
+                s->loaded           = false;
+                s->mapped           = false;
+                s->data             = NULL;
+                s->size             = 0;
+                s->index            = NULL;
+                s->count            = 0;
+
+                if (!vStrikes.add(s))
+                {
+                    delete s;
+                    return NULL;
+                }
+
+                return s;
+            }
+
+            status_t DiskCache::strike_path(io::Path *path, const strike_t *s)
+            {
+                // The file name does not depend on the modification time, so outdated files are overwritten
+                key_t key           = s->key;
+                key.mtime           = 0;
+
+                const uint8_t *p    = reinterpret_cast<const uint8_t *>(&key);
+                uint64_t h          = 0xcbf29ce484222325ULL;
+                for (size_t i=0; i<sizeof(key); ++i)
+                    h                   = (h ^ p[i]) * 0x100000001b3ULL;
+
+                char name[32];
+                snprintf(name, sizeof(name), "%016llx.glyphs", (unsigned long long)(h));
+
+                status_t res        = path->set(&sPath);
+                if (res == STATUS_OK)
+                    res                 = path->append_child(name);
+                return res;
+            }
+
+            void DiskCache::load_strike(strike_t *s)
+            {
+                s->loaded           = true;
+
+                io::Path path;
+                if (strike_path(&path, s) != STATUS_OK)
+                    return;
+
+            #ifdef PLATFORM_POSIX
+                int fd = ::open(path.as_native(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0)
+                    return;
+                lsp_finally { ::close(fd); };
+
+                struct stat st;
+                if ((::fstat(fd, &st) != 0) || (!S_ISREG(st.st_mode)) || (size_t(st.st_size) < sizeof(header_t)))
+                    return;
+
+                void *addr = ::mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                if (addr == MAP_FAILED)
+                    return;
+
+                s->data             = static_cast<uint8_t *>(addr);
+                s->size             = st.st_size;
+                s->mapped           = true;
+            #else
+                FILE *fd = fopen(path.as_native(), "rb");
+                if (fd == NULL)
+                    return;
+                lsp_finally { fclose(fd); };
+
+                if (fseek(fd, 0, SEEK_END) != 0)
+                    return;
+                const long size = ftell(fd);
+                if ((size < long(sizeof(header_t))) || (fseek(fd, 0, SEEK_SET) != 0))
+                    return;
+
+                s->data             = static_cast<uint8_t *>(malloc(size));
+                if (s->data == NULL)
+                    return;
+                s->size             = size;
+                if (fread(s->data, 1, size, fd) != size_t(size))
+                {
+                    unload_strike(s);
+                    s->loaded           = true;
+                    return;
+                }
+            #endif /* PLATFORM_POSIX */
+
+                // Validate the header, the file of outdated font is ignored and overwritten on flush
+                const header_t *hdr = reinterpret_cast<const header_t *>(s->data);
+                if ((memcmp(hdr->signature, strike_signature, sizeof(strike_signature)) != 0) ||
+                    (memcmp(&hdr->key, &s->key, sizeof(key_t)) != 0) ||
+                    ((sizeof(header_t) + size_t(hdr->count) * sizeof(entry_t)) > s->size))
+                {
+                    unload_strike(s);
+                    s->loaded           = true;
+                    return;
+                }
+
+                s->index            = reinterpret_cast<const entry_t *>(&s->data[sizeof(header_t)]);
+                s->count            = hdr->count;
+
+                lsp_trace("Loaded %d glyphs from %s", int(s->count), path.as_native());
+            }
+
+            status_t DiskCache::save_strike(strike_t *s)
+            {
+                if (!s->loaded)
+                    load_strike(s);
+
+                // Merge glyphs from the file and pending glyphs, prefer glyphs stored in the file
+                lltl::darray<strike_item_t> items;
+                if (!items.reserve(s->count + s->pending.size()))
+                    return STATUS_NO_MEM;
+
+                for (size_t i=0; i<s->count; ++i)
+                {
+                    const record_t *rec = find_record(s, s->index[i].codepoint);
+                    if (rec == NULL)
+                        continue;
+                    strike_item_t *item = items.append();
+                    item->codepoint     = rec->codepoint;
+                    item->record        = rec;
+                }
+                for (size_t i=0, n=s->pending.size(); i<n; ++i)
+                {
+                    const record_t *rec = s->pending.uget(i);
+                    strike_item_t *item = items.append();
+                    item->codepoint     = rec->codepoint;
+                    item->record        = rec;
+                }
+                items.qsort(cmp_strike_items);
+
+                // Remove duplicates, the sort is not stable so glyphs of the same codepoint are interchangeable
+                size_t count        = 0;
+                strike_item_t *vi   = items.array();
+                for (size_t i=0, n=items.size(); i<n; ++i)
+                {
+                    if ((count > 0) && (vi[count-1].codepoint == vi[i].codepoint))
+                        continue;
+                    vi[count++]         = vi[i];
+                }
+
+                // Write to temporary file and replace the strike file atomically
+                io::Path path;
+                status_t res        = strike_path(&path, s);
+                if (res != STATUS_OK)
+                    return res;
+                res                 = path.mkparent(true);
+                if ((res != STATUS_OK) && (res != STATUS_ALREADY_EXISTS))
+                    return res;
+
+                LSPString tmp;
+                FILE *fd = create_temp_file(&tmp, &path);
+                if (fd == NULL)
+                    return STATUS_IO_ERROR;
+
+                header_t hdr;
+                bzero(&hdr, sizeof(hdr));
+                memcpy(hdr.signature, strike_signature, sizeof(strike_signature));
+                hdr.count           = uint32_t(count);
+                hdr.key             = s->key;
+                fwrite(&hdr, sizeof(hdr), 1, fd);
+
+                size_t offset       = sizeof(header_t) + count * sizeof(entry_t);
+                for (size_t i=0; i<count; ++i)
+                {
+                    entry_t e;
+                    e.codepoint         = vi[i].codepoint;
+                    e.offset            = uint32_t(offset);
+                    fwrite(&e, sizeof(e), 1, fd);
+                    offset             += record_size(static_cast<const record_t *>(vi[i].record));
+                }
+
+                const uint32_t padding = 0;
+                for (size_t i=0; i<count; ++i)
+                {
+                    const record_t *rec = static_cast<const record_t *>(vi[i].record);
+                    const size_t bytes  = sizeof(record_t) + size_t(rec->bm_stride) * rec->bm_height;
+                    fwrite(rec, bytes, 1, fd);
+                    fwrite(&padding, record_size(rec) - bytes, 1, fd);
+                }
+
+                const bool failed = (ferror(fd) != 0) || (offset > UINT32_MAX);
+                if ((fclose(fd) != 0) || (failed) || (rename(tmp.get_native(), path.as_native()) != 0))
+                {
+                    remove(tmp.get_native());
+                    return STATUS_IO_ERROR;
+                }
+
+                lsp_trace("Saved %d glyphs to %s", int(count), path.as_native());
+
+                // The file will be loaded again on the next lookup
+                unload_strike(s);
+
+                return STATUS_OK;
+            }
+
+            void DiskCache::trim()
+            {
+                io::Dir dir;
+                if (dir.open(&sPath) != STATUS_OK)
+                    return;
+                lsp_finally { dir.close(); };
+
+                lltl::parray<cache_file_t> files;
+                lsp_finally {
+                    for (size_t i=0, n=files.size(); i<n; ++i)
+                        delete files.uget(i);
+                    files.flush();
+                };
+
+                // Collect strike files and remove temporary files left by crashed processes
+                const wssize_t now  = system::get_time_millis();
+                wsize_t total       = 0;
+                LSPString item;
+                io::Path child;
+                io::fattr_t fattr;
+                while (dir.read(&item, false) == STATUS_OK)
+                {
+                    const bool strike   = has_suffix(&item, ".glyphs");
+                    if ((!strike) && (!has_suffix(&item, ".tmp")))
+                        continue;
+                    if ((child.set(&sPath, &item) != STATUS_OK) || (child.stat(&fattr) != STATUS_OK))
+                        continue;
+                    if (fattr.type != io::fattr_t::FT_REGULAR)
+                        continue;
+
+                    if (!strike)
+                    {
+                        if ((now - fattr.mtime) > STALE_TEMP_TIME)
+                            child.remove();
+                        continue;
+                    }
+
+                    cache_file_t *f     = new cache_file_t;
+                    if (f == NULL)
+                        return;
+                    if ((f->path.set(&child) != STATUS_OK) || (!files.add(f)))
+                    {
+                        delete f;
+                        return;
+                    }
+                    f->size             = fattr.size;
+                    f->mtime            = fattr.mtime;
+                    total              += fattr.size;
+                }
+
+                if (total <= MAX_DISK_SIZE)
+                    return;
+
+                // Remove the oldest strike files, mapped files stay valid until they are unmapped
+                files.qsort(cmp_cache_files);
+                for (size_t i=0, n=files.size(); (i<n) && (total > MAX_DISK_SIZE); ++i)
+                {
+                    cache_file_t *f     = files.uget(i);
+                    if (f->path.remove() != STATUS_OK)
+                        continue;
+                    total              -= f->size;
+                    lsp_trace("Removed strike file %s", f->path.as_native());
+                }
+            }
+
+            status_t DiskCache::open(const io::Path *path, uint32_t version)
+            {
+                close();
+
+                status_t res        = sPath.set(path);
+                if (res != STATUS_OK)
+                    return res;
+
+                bEnabled            = true;
+                nVersion            = version;
+
+                return STATUS_OK;
+            }
+
+            status_t DiskCache::flush()
+            {
+                status_t res        = STATUS_OK;
+                bool written        = false;
+
+                for (size_t i=0, n=vStrikes.size(); i<n; ++i)
+                {
+                    strike_t *s         = vStrikes.uget(i);
+                    if (s->pending.is_empty())
+                        continue;
+
+                    status_t xres       = save_strike(s);
+                    if (xres == STATUS_OK)
+                        written             = true;
+                    else if (res == STATUS_OK)
+                        res                 = xres;
+
+                    // Pending glyphs are dropped even if the file was not written
+                    for (size_t j=0, m=s->pending.size(); j<m; ++j)
+                        free(s->pending.uget(j));
+                    s->pending.flush();
+                }
+                nPending            = 0;
+
+                // Keep the size of the cache bounded
+                if (written)
+                    trim();
+
+                return res;
+            }
+
+            void DiskCache::close()
+            {
+                for (size_t i=0, n=vStrikes.size(); i<n; ++i)
+                    destroy_strike(vStrikes.uget(i));
+                vStrikes.flush();
+
+                sPath.clear();
+                bEnabled            = false;
+                nPending            = 0;
+            }
+
+            glyph_t *DiskCache::load(face_t *face, lsp_wchar_t ch, GlyphAllocator *alloc)
+            {
+                if (!bEnabled)
+                    return NULL;
+
+                strike_t *s         = get_strike(face);
+                if (s == NULL)
+                    return NULL;
+                if (!s->loaded)
+                    load_strike(s);
+
+                const record_t *rec = find_record(s, ch);
+                if (rec == NULL)
+                {
+                    ++nMisses;
+                    return NULL;
+                }
+
+                // Allocate the glyph the same way as it is done for rendered glyphs
+                const size_t bytes      = size_t(rec->bm_stride) * rec->bm_height;
+                const size_t to_alloc   = sizeof(glyph_t) + DEFAULT_ALIGN + bytes;
+                glyph_t *res            = NULL;
+                if (alloc != NULL)
+                {
+                    if ((res = alloc->allocate(to_alloc)) == NULL)
+                        return NULL;
+                }
+                else
+                {
+                    if ((res = static_cast<glyph_t *>(malloc(to_alloc))) == NULL)
+                        return NULL;
+                    res->slab               = NULL;
+                    res->szof               = to_alloc;
+                }
+                uint8_t *buf            = reinterpret_cast<uint8_t *>(res);
+
+                res->cache_next         = NULL;
+                res->face               = face;
+                res->codepoint          = ch;
+                res->width              = rec->width;
+                res->height             = rec->height;
+                res->x_advance          = rec->x_advance;
+                res->y_advance          = rec->y_advance;
+                res->x_bearing          = rec->x_bearing;
+                res->y_bearing          = rec->y_bearing;
+                res->lsb_delta          = rec->lsb_delta;
+                res->rsb_delta          = rec->rsb_delta;
+
+                res->bitmap.width       = rec->bm_width;
+                res->bitmap.height      = rec->bm_height;
+                res->bitmap.stride      = rec->bm_stride;
+                res->bitmap.data        = align_ptr(&buf[sizeof(glyph_t)], DEFAULT_ALIGN);
+                res->format             = rec->format;
+
+                memcpy(res->bitmap.data, &rec[1], bytes);
+
+                ++nHits;
+                return res;
+            }
+
+            void DiskCache::store(const glyph_t *glyph)
+            {
+                if (!bEnabled)
+                    return;
+
+                const size_t bytes  = size_t(glyph->bitmap.stride) * glyph->bitmap.height;
+                const size_t size   = sizeof(record_t) + bytes;
+                if ((nPending + size) > MAX_PENDING)
+                    return;
+
+                strike_t *s         = get_strike(glyph->face);
+                if (s == NULL)
+                    return;
+
+                record_t *rec       = static_cast<record_t *>(malloc(size));
+                if (rec == NULL)
+                    return;
+
+                rec->codepoint      = glyph->codepoint;
+                rec->format         = glyph->format;
+                rec->width          = glyph->width;
+                rec->height         = glyph->height;
+                rec->x_advance      = glyph->x_advance;
+                rec->y_advance      = glyph->y_advance;
+                rec->x_bearing      = glyph->x_bearing;
+                rec->y_bearing      = glyph->y_bearing;
+                rec->lsb_delta      = glyph->lsb_delta;
+                rec->rsb_delta      = glyph->rsb_delta;
+                rec->bm_width       = glyph->bitmap.width;
+                rec->bm_height      = glyph->bitmap.height;
+                rec->bm_stride      = glyph->bitmap.stride;
+                rec->reserved       = 0;
+                memcpy(&rec[1], glyph->bitmap.data, bytes);
+
+                if (!s->pending.add(rec))
+                {
+                    free(rec);
+                    return;
+                }
+                nPending           += size;
+            }
+
+            void DiskCache::clear_stats()
+            {
+                nHits               = 0;
+                nMisses             = 0;
+            }
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
@@ -0,0 +1,467 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/runtime/system.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/freetype/face_id.h>
+#include <private/freetype/FontIndex.h>
+#include <private/freetype/tmpfile.h>
+
+#include <fontconfig/fontconfig.h>
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            static const char * const preferred_fonts[] =
+            {
+                "Noto Sans",
+                "Open Sans",
+                "FreeSans",
+                "Bitstream Vera Sans",
+                "DejaVu Sans",
+                "Verdana",
+                "Arial",
+                "Albany AMT",
+                "Luxi Sans",
+                "Nimbus Sans L",
+                "Nimbus Sans",
+                "Helvetica",
+                "Lucida Sans Unicode",
+                "BPG Glaho International",
+                "Tahoma",
+                NULL
+            };
+
+            static const char * const index_header  = "LSP-WS-LIB-FONT-INDEX-1";
+            static constexpr size_t index_fields    = 6;
+            static constexpr size_t style_selectors = 4;
+
+            static int preferred_index(const char *face)
+            {
+                for (size_t i=0; ; ++i)
+                {
+                    const char *family = preferred_fonts[i];
+                    if (family == NULL)
+                        return -1;
+                    if (strcasecmp(family, face) == 0)
+                        return i;
+                }
+
+                return -1;
+            }
+
+            static void hash_file(uint64_t *hash, const FcChar8 *name)
+            {
+                // FNV-1a over the file name, modification time and size
+                const char *path    = reinterpret_cast<const char *>(name);
+                uint64_t h          = *hash;
+                for (const char *p = path; *p != '\0'; ++p)
+                    h                   = (h ^ uint8_t(*p)) * 0x100000001b3ULL;
+
+                struct stat st;
+                if (stat(path, &st) == 0)
+                {
+                    h                   = (h ^ uint64_t(st.st_mtime)) * 0x100000001b3ULL;
+                    h                   = (h ^ uint64_t(st.st_size)) * 0x100000001b3ULL;
+                }
+
+                *hash               = h;
+            }
+
+            static void hash_files(uint64_t *hash, FcStrList *list)
+            {
+                if (list == NULL)
+                    return;
+
+                for (FcChar8 *name = FcStrListNext(list); name != NULL; name = FcStrListNext(list))
+                    hash_file(hash, name);
+                FcStrListDone(list);
+            }
+
+            static bool has_separators(const char *s)
+            {
+                return strpbrk(s, "\t\n") != NULL;
+            }
+
+            FontIndex::FontIndex()
+            {
+                nSignature      = 0;
+                bInitialized    = false;
+            }
+
+            FontIndex::~FontIndex()
+            {
+                drop();
+            }
+
+            char *FontIndex::make_key(size_t flags, const char *family)
+            {
+                // The key is the style selector followed by lower-case family name
+                const size_t len    = strlen(family);
+                char *key           = static_cast<char *>(malloc(len + 2));
+                if (key == NULL)
+                    return NULL;
+
+                key[0]              = '0' + char((flags & (FID_BOLD | FID_ITALIC)) / FID_BOLD);
+                for (size_t i=0; i<len; ++i)
+                    key[i + 1]          = char(tolower(uint8_t(family[i])));
+                key[len + 1]        = '\0';
+
+                return key;
+            }
+
+            FontIndex::font_info_t *FontIndex::make_info(const char *family, const char *path, const char *style, int weight, int slant)
+            {
+                const size_t family_len     = strlen(family) + 1;
+                const size_t path_len       = strlen(path) + 1;
+                const size_t style_len      = strlen(style) + 1;
+                const size_t szof           =
+                    sizeof(font_info_t) +
+                    family_len +
+                    path_len +
+                    style_len;
+
+                font_info_t *result = static_cast<font_info_t *>(malloc(szof));
+                if (result == NULL)
+                    return NULL;
+
+                char *ptr           = reinterpret_cast<char *>(&result[1]);
+                result->family      = ptr;
+                result->path        = &result->family[family_len];
+                result->style       = &result->path[path_len];
+                result->weight      = weight;
+                result->slant       = slant;
+
+                memcpy(result->family, family, family_len);
+                memcpy(result->path, path, path_len);
+                memcpy(result->style, style, style_len);
+
+                return result;
+            }
+
+            uint64_t FontIndex::config_signature()
+            {
+                uint64_t h          = 0xcbf29ce484222325ULL;
+
+                FcConfig *config    = FcConfigGetCurrent();
+                if (config == NULL)
+                    return h;
+
+                hash_files(&h, FcConfigGetConfigFiles(config));
+                hash_files(&h, FcConfigGetFontDirs(config));
+
+                return h;
+            }
+
+            status_t FontIndex::index_path(io::Path *path)
+            {
+                status_t res;
+                LSPString dir;
+
+                if ((system::get_env_var("XDG_CACHE_HOME", &dir) == STATUS_OK) && (!dir.is_empty()))
+                    res     = path->set(&dir);
+                else
+                {
+                    if ((res = system::get_env_var("HOME", &dir)) != STATUS_OK)
+                        return res;
+                    if ((res = path->set(&dir)) == STATUS_OK)
+                        res     = path->append_child(".cache");
+                }
+
+                if (res == STATUS_OK)
+                    res     = path->append_child("lsp-ws-lib");
+                if (res == STATUS_OK)
+                    res     = path->append_child("font-index");
+
+                return res;
+            }
+
+            bool FontIndex::put(const char *key, font_info_t *info)
+            {
+                font_info_t *old    = NULL;
+                if (!vFonts.put(key, info, &old))
+                {
+                    free(info);
+                    return false;
+                }
+                if (old != NULL)
+                    free(old);
+
+                return true;
+            }
+
+            status_t FontIndex::build()
+            {
+                // Lookup system font faces
+                FcPattern *pattern = FcPatternCreate();
+                if (pattern == NULL)
+                    return STATUS_NO_MEM;
+                lsp_finally { FcPatternDestroy(pattern); };
+
+                FcObjectSet *object_set = FcObjectSetBuild (FC_FAMILY, FC_STYLE, FC_SLANT, FC_WEIGHT, FC_FILE, NULL);
+                if (object_set == NULL)
+                    return STATUS_NO_MEM;
+                lsp_finally { FcObjectSetDestroy(object_set); };
+
+                FcFontSet *font_set = FcFontList(NULL, pattern, object_set);
+                if (font_set == NULL)
+                    return STATUS_NOT_FOUND;
+                lsp_finally { FcFontSetDestroy(font_set); };
+
+                // Rank of the selected preferred font for each style
+                int preferred[style_selectors];
+                for (size_t i=0; i<style_selectors; ++i)
+                    preferred[i]        = -1;
+
+                LSPString font_path;
+                for (int i=0; i<font_set->nfont; ++i)
+                {
+                    FcPattern *fp = font_set->fonts[i];
+
+                    // Obtain font parameters
+                    int weight = 0, slant = 0;
+                    FcChar8 *family = NULL, *path = NULL, *style = NULL;
+                    if (FcPatternGetInteger(fp, FC_WEIGHT, 0, &weight) != FcResultMatch)
+                        continue;
+                    if (FcPatternGetInteger(fp, FC_SLANT, 0, &slant) != FcResultMatch)
+                        continue;
+                    if (FcPatternGetString(fp, FC_FAMILY, 0, &family) != FcResultMatch)
+                        continue;
+                    if (FcPatternGetString(fp, FC_FILE, 0, &path) != FcResultMatch)
+                        continue;
+                    if (!font_path.set_native(reinterpret_cast<const char *>(path)))
+                        continue;
+                    if (FcPatternGetString(fp, FC_STYLE, 0, &style) != FcResultMatch)
+                        continue;
+
+                    const char *s_family    = reinterpret_cast<const char *>(family);
+                    const char *s_path      = reinterpret_cast<const char *>(path);
+                    const char *s_style     = reinterpret_cast<const char *>(style);
+
+                    // Compute the style selector
+                    size_t flags            = 0;
+                    if (weight >= FC_WEIGHT_MEDIUM)
+                        flags                  |= FID_BOLD;
+                    if ((slant == FC_SLANT_ITALIC) || (slant == FC_SLANT_OBLIQUE))
+                        flags                  |= FID_ITALIC;
+
+                    // The last font of the family matching the style wins
+                    char *key               = make_key(flags, s_family);
+                    if (key == NULL)
+                        return STATUS_NO_MEM;
+                    lsp_finally { free(key); };
+
+                    font_info_t *info       = make_info(s_family, s_path, s_style, weight, slant);
+                    if ((info == NULL) || (!put(key, info)))
+                        return STATUS_NO_MEM;
+
+                    // The first font with the highest preference is the default one
+                    const int rank          = preferred_index(s_family);
+                    int *selected           = &preferred[flags / FID_BOLD];
+                    if ((rank < 0) || ((*selected >= 0) && (rank >= *selected)))
+                        continue;
+                    *selected               = rank;
+
+                    key[1]                  = '\0';
+                    info                    = make_info(s_family, s_path, s_style, weight, slant);
+                    if ((info == NULL) || (!put(key, info)))
+                        return STATUS_NO_MEM;
+                }
+
+                lsp_trace("Built font index of %d entries from %d system fonts", int(vFonts.size()), int(font_set->nfont));
+
+                return STATUS_OK;
+            }
+
+            status_t FontIndex::load(const io::Path *path)
+            {
+                FILE *fd = fopen(path->as_native(), "rb");
+                if (fd == NULL)
+                    return STATUS_NOT_FOUND;
+                lsp_finally { fclose(fd); };
+
+                // Read the whole file
+                if (fseek(fd, 0, SEEK_END) != 0)
+                    return STATUS_IO_ERROR;
+                const long size = ftell(fd);
+                if (size <= 0)
+                    return STATUS_CORRUPTED;
+                if (fseek(fd, 0, SEEK_SET) != 0)
+                    return STATUS_IO_ERROR;
+
+                char *data      = static_cast<char *>(malloc(size + 1));
+                if (data == NULL)
+                    return STATUS_NO_MEM;
+                lsp_finally { free(data); };
+                if (fread(data, 1, size, fd) != size_t(size))
+                    return STATUS_IO_ERROR;
+                data[size]      = '\0';
+
+                // Check the header: the index is valid only for the same fontconfig configuration
+                char header[64];
+                snprintf(header, sizeof(header), "%s %016llx", index_header, (unsigned long long)(nSignature));
+
+                char *next      = strchr(data, '\n');
+                if (next == NULL)
+                    return STATUS_CORRUPTED;
+                *(next++)       = '\0';
+                if (strcmp(data, header) != 0)
+                    return STATUS_CORRUPTED;
+
+                // Parse records: key, family, path, style, weight and slant separated by tabs
+                for (char *line = next; *line != '\0'; line = next)
+                {
+                    if ((next = strchr(line, '\n')) == NULL)
+                        return STATUS_CORRUPTED;
+                    *(next++)       = '\0';
+
+                    char *fields[index_fields];
+                    size_t n        = 0;
+                    for (char *p = line; (p != NULL) && (n < index_fields); ++n)
+                    {
+                        fields[n]       = p;
+                        if ((p = strchr(p, '\t')) != NULL)
+                            *(p++)          = '\0';
+                    }
+                    if (n < index_fields)
+                        return STATUS_CORRUPTED;
+
+                    font_info_t *info   = make_info(fields[1], fields[2], fields[3], atoi(fields[4]), atoi(fields[5]));
+                    if ((info == NULL) || (!put(fields[0], info)))
+                        return STATUS_NO_MEM;
+                }
+
+                return STATUS_OK;
+            }
+
+            status_t FontIndex::save(const io::Path *path)
+            {
+                status_t res = path->mkparent(true);
+                if ((res != STATUS_OK) && (res != STATUS_ALREADY_EXISTS))
+                    return res;
+
+                lltl::parray<char> keys;
+                if (!vFonts.keys(&keys))
+                    return STATUS_NO_MEM;
+
+                // Write to temporary file and replace the index atomically
+                LSPString tmp;
+                FILE *fd = create_temp_file(&tmp, path);
+                if (fd == NULL)
+                    return STATUS_IO_ERROR;
+
+                fprintf(fd, "%s %016llx\n", index_header, (unsigned long long)(nSignature));
+                for (size_t i=0, n=keys.size(); i<n; ++i)
+                {
+                    const char *key         = keys.uget(i);
+                    const font_info_t *info = vFonts.get(key);
+                    if ((info == NULL) || (has_separators(key)) ||
+                        (has_separators(info->family)) || (has_separators(info->path)) || (has_separators(info->style)))
+                        continue;
+
+                    fprintf(fd, "%s\t%s\t%s\t%s\t%d\t%d\n",
+                        key, info->family, info->path, info->style, info->weight, info->slant);
+                }
+
+                const bool failed = ferror(fd) != 0;
+                if ((fclose(fd) != 0) || (failed) || (rename(tmp.get_native(), path->as_native()) != 0))
+                {
+                    remove(tmp.get_native());
+                    return STATUS_IO_ERROR;
+                }
+
+                return STATUS_OK;
+            }
+
+            void FontIndex::init()
+            {
+                bInitialized        = true;
+                nSignature          = config_signature();
+
+                // Try to load persisted index first
+                io::Path path;
+                const bool persistent   = index_path(&path) == STATUS_OK;
+                if ((persistent) && (load(&path) == STATUS_OK))
+                {
+                    lsp_trace("Loaded font index of %d entries from %s", int(vFonts.size()), path.as_native());
+                    return;
+                }
+
+                // Build the index and persist it
+                drop();
+                if (build() != STATUS_OK)
+                {
+                    drop();
+                    return;
+                }
+                if (persistent)
+                    save(&path);
+            }
+
+            void FontIndex::drop()
+            {
+                lltl::parray<font_info_t> fonts;
+                if (vFonts.values(&fonts))
+                {
+                    for (size_t i=0, n=fonts.size(); i<n; ++i)
+                        free(fonts.uget(i));
+                }
+                vFonts.flush();
+            }
+
+            const FontIndex::font_info_t *FontIndex::find(const char *family, size_t flags)
+            {
+                if (!bInitialized)
+                    init();
+
+                char *key = make_key(flags, (family != NULL) ? family : "");
+                if (key == NULL)
+                    return NULL;
+                lsp_finally { free(key); };
+
+                return vFonts.get(key);
+            }
+
+            void FontIndex::clear()
+            {
+                drop();
+                bInitialized        = false;
+            }
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
@@ -22,7 +22,7 @@
 #ifdef USE_LIBFREETYPE
 
 #include <lsp-plug.in/common/debug.h>
-#include <lsp-plug.in/io/InFileStream.h>
+#include <lsp-plug.in/io/Path.h>
 #include <lsp-plug.in/stdlib/string.h>
 
 #include <private/freetype/FontManager.h>
@@ -35,189 +35,12 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
-#include <fontconfig/fontconfig.h>
-
 namespace lsp
 {
     namespace ws
     {
         namespace ft
         {
-            static const char * const preferred_fonts[] =
-            {
-                "Noto Sans",
-                "Open Sans",
-                "FreeSans",
-                "Bitstream Vera Sans",
-                "DejaVu Sans",
-                "Verdana",
-                "Arial",
-                "Albany AMT",
-                "Luxi Sans",
-                "Nimbus Sans L",
-                "Nimbus Sans",
-                "Helvetica",
-                "Lucida Sans Unicode",
-                "BPG Glaho International",
-                "Tahoma",
-                NULL
-            };
-
-            static int preferred_index(const FcChar8 *face)
-            {
-                for (size_t i=0; ; ++i)
-                {
-                    const char *family = preferred_fonts[i];
-                    if (family == NULL)
-                        return -1;
-                    if (strcasecmp(family, reinterpret_cast<const char *>(face)) == 0)
-                        return i;
-                }
-
-                return -1;
-            }
-
-            typedef struct font_info_t
-            {
-                char *family;
-                char *path;
-                char *style;
-                int weight;
-                int slant;
-            } font_info_t;
-
-            static font_info_t *select_best_font(const face_id_t *id)
-            {
-                font_info_t info;
-                info.family         = NULL;
-                info.path           = NULL;
-                info.style          = NULL;
-                info.weight         = 0;
-                info.slant          = 0;
-
-                int index           = -1;
-                const char *font_family  = ((id->name != NULL) && (strlen(id->name) > 0)) ? id->name : NULL;
-
-                // Cleanup FontConfig state on exit
-//                lsp_finally { FcFini(); };
-
-                // Lookup system font faces and add to list
-                FcPattern *pattern = FcPatternCreate();
-                if (pattern == NULL)
-                    return NULL;
-                lsp_finally { FcPatternDestroy(pattern); };
-
-                FcObjectSet *object_set = FcObjectSetBuild (FC_FAMILY, FC_STYLE, FC_SLANT, FC_WEIGHT, FC_FILE, NULL);
-                if (object_set == NULL)
-                    return NULL;
-                lsp_finally { FcObjectSetDestroy(object_set); };
-
-                FcFontSet *font_set = FcFontList(NULL, pattern, object_set);
-                if (font_set == NULL)
-                    return NULL;
-                lsp_finally { FcFontSetDestroy(font_set); };
-
-                LSPString font_path;
-                size_t found = 0;
-                for (int i=0; i<font_set->nfont; ++i)
-                {
-                    FcPattern *fp = font_set->fonts[i];
-
-                    // Check weight
-                    int weight = 0;
-                    if (FcPatternGetInteger(fp, FC_WEIGHT, 0, &weight) != FcResultMatch)
-                        continue;
-
-                    if (id->flags & FID_BOLD)
-                    {
-                        if (weight < FC_WEIGHT_MEDIUM)
-                            continue;
-                    }
-                    else if (weight >= FC_WEIGHT_MEDIUM)
-                        continue;
-
-                    // Check slant
-                    int slant = 0;
-                    if (FcPatternGetInteger(fp, FC_SLANT, 0, &slant) != FcResultMatch)
-                        continue;
-                    if (id->flags & FID_ITALIC)
-                    {
-                        if ((slant != FC_SLANT_ITALIC) && (slant != FC_SLANT_OBLIQUE))
-                            continue;
-                    }
-                    else if ((slant == FC_SLANT_ITALIC) || (slant == FC_SLANT_OBLIQUE))
-                        continue;
-
-                    // Validate family match
-                    FcChar8* family = NULL;
-                    if (FcPatternGetString(fp, FC_FAMILY, 0, &family) != FcResultMatch)
-                        continue;
-                    if (font_family == NULL)
-                    {
-                        int new_index       = preferred_index(family);
-                        if (new_index < 0)
-                            continue;
-                        else if ((index >= 0) && (new_index >= index))
-                            continue;
-                        index               = new_index;
-                    }
-                    else if ((strcasecmp(reinterpret_cast<const char *>(family), font_family)) != 0)
-                        continue;
-
-                    // Path
-                    FcChar8* path = NULL;
-                    if (FcPatternGetString(fp, FC_FILE, 0, &path) != FcResultMatch)
-                        continue;
-                    if (!font_path.set_native(reinterpret_cast<const char *>(path)))
-                        continue;
-
-                    // Style
-                    FcChar8* style = NULL;
-                    if (FcPatternGetString(fp, FC_STYLE, 0, &style) != FcResultMatch)
-                        continue;
-
-                    // Set font parameters
-                    info.family         = reinterpret_cast<char *>(family);
-                    info.path           = reinterpret_cast<char *>(path);
-                    info.style          = reinterpret_cast<char *>(style);
-                    info.weight         = weight;
-                    info.slant          = slant;
-
-                    ++found;
-                    if (index == 0)
-                        break;
-                }
-
-                if (found <= 0)
-                    return NULL;
-
-                // Allocate the result
-                const size_t family_len     = strlen(info.family) + 1;
-                const size_t path_len       = strlen(info.path) + 1;
-                const size_t style_len      = strlen(info.style) + 1;
-                const size_t szof           =
-                    sizeof(font_info_t) +
-                    family_len +
-                    path_len +
-                    style_len;
-
-                font_info_t *result = static_cast<font_info_t *>(malloc(szof));
-                if (result == NULL)
-                    return NULL;
-
-                char *ptr           = reinterpret_cast<char *>(&result[1]);
-                result->family      = ptr;
-                result->path        = &result->family[family_len];
-                result->style       = &result->path[path_len];
-
-                memcpy(result->family, info.family, family_len);
-                memcpy(result->path, info.path, path_len);
-                memcpy(result->style, info.style, style_len);
-
-                return result;
-            }
-
-
             FontManager::FontManager()
             {
                 nCacheSize      = 0;
@@ -228,6 +51,7 @@ namespace lsp
                 nGlyphHits      = 0;
                 nGlyphMisses    = 0;
                 nGlyphRemoval   = 0;
+                nSerial         = 0;
             }
 
             FontManager::~FontManager()
@@ -264,6 +88,19 @@ namespace lsp
                 lsp_trace("  Glyph hits:     %ld", long(nGlyphHits));
                 lsp_trace("  Glyph misses:   %ld", long(nGlyphMisses));
                 lsp_trace("  Glyph removal:  %ld", long(nGlyphRemoval));
+                lsp_trace("  Text memory:    %ld", long(sTextCache.size()));
+                lsp_trace("  Text hits:      %ld", long(sTextCache.hits()));
+                lsp_trace("  Text misses:    %ld", long(sTextCache.misses()));
+                lsp_trace("  Disk hits:      %ld", long(sDiskCache.hits()));
+                lsp_trace("  Disk misses:    %ld", long(sDiskCache.misses()));
+
+                // Stop the background rasterization and release the requests
+                sPrefetcher.stop();
+                sync_prefetched();
+
+                // Persist glyphs rendered by this font manager
+                sDiskCache.flush();
+                sDiskCache.close();
 
                 // Destroy the state
                 clear();
@@ -277,7 +114,10 @@ namespace lsp
                 if (face == NULL)
                     return;
                 if ((--face->references) <= 0)
+                {
+                    invalidate_face(face);
                     destroy_face(sLibrary, face);
+                }
             }
 
             bool FontManager::add_font_face(lltl::darray<font_entry_t> *entries, const char *name, face_t *face)
@@ -303,12 +143,12 @@ namespace lsp
                 if (!sLibrary.initialized())
                     return STATUS_BAD_STATE;
 
-                io::InFileStream ifs;
-                status_t res    = ifs.open(path);
-                if (res == STATUS_OK)
-                    res         = add(name, &ifs);
-                status_t res2   = ifs.close();
-                return (res == STATUS_OK) ? res2 : res;
+                io::Path tmp;
+                status_t res    = tmp.set(path);
+                if (res != STATUS_OK)
+                    return res;
+
+                return add(name, &tmp);
             }
 
             status_t FontManager::add(const char *name, const io::Path *path)
@@ -316,12 +156,14 @@ namespace lsp
                 if (!sLibrary.initialized())
                     return STATUS_BAD_STATE;
 
-                io::InFileStream ifs;
-                status_t res    = ifs.open(path);
-                if (res == STATUS_OK)
-                    res         = add(name, &ifs);
-                status_t res2   = ifs.close();
-                return (res == STATUS_OK) ? res2 : res;
+                status_t res;
+                lltl::parray<face_t> faces;
+
+                // Load font faces
+                if ((res = load_face(&faces, sLibrary, path)) != STATUS_OK)
+                    return res;
+
+                return add_faces(name, &faces);
             }
 
             status_t FontManager::add(const char *name, const LSPString *path)
@@ -329,12 +171,12 @@ namespace lsp
                 if (!sLibrary.initialized())
                     return STATUS_BAD_STATE;
 
-                io::InFileStream ifs;
-                status_t res    = ifs.open(path);
-                if (res == STATUS_OK)
-                    res         = add(name, &ifs);
-                status_t res2   = ifs.close();
-                return (res == STATUS_OK) ? res2 : res;
+                io::Path tmp;
+                status_t res    = tmp.set(path);
+                if (res != STATUS_OK)
+                    return res;
+
+                return add(name, &tmp);
             }
 
             status_t FontManager::add(const char *name, io::IInStream *is)
@@ -348,6 +190,14 @@ namespace lsp
                 // Load font faces
                 if ((res = load_face(&faces, sLibrary, is)) != STATUS_OK)
                     return res;
+
+                return add_faces(name, &faces);
+            }
+
+            status_t FontManager::add_faces(const char *name, lltl::parray<face_t> *loaded)
+            {
+                lltl::parray<face_t> faces;
+                faces.swap(loaded);
                 lsp_finally { destroy_faces(sLibrary, &faces); };
 
                 // Make list of faces
@@ -436,19 +286,28 @@ namespace lsp
                 if (face == NULL)
                     return;
 
-                // Remove all glyphs from LRU cache
-                glyph_t *glyph = face->cache.clear();
-                while (glyph != NULL)
+                // Remove all glyphs of the face from the cache
+                if (face->cache_size > 0)
                 {
-                    glyph_t *next   = glyph->cache_next;
-                    sLRU.remove(glyph);
-                    free_glyph(glyph);
-                    glyph           = next;
+                    glyph_t *glyph = sGlyphs.remove_face(face);
+                    while (glyph != NULL)
+                    {
+                        glyph_t *next   = glyph->cache_next;
+                        free_glyph(glyph);
+                        glyph           = next;
+                    }
+
+                    // Update counters
+                    nCacheSize         -= face->cache_size;
+                    face->cache_size    = 0;
+                    sAllocator.trim();
                 }
 
-                // Update counters
-                nCacheSize         -= face->cache_size;
-                face->cache_size    = 0;
+                // The face may be destroyed, so all laid out glyph runs should be invalidated
+                ++nSerial;
+
+                // Remove all rendered text
+                sTextCache.remove_face(face);
             }
 
             void FontManager::invalidate_faces(const char *name)
@@ -536,12 +395,35 @@ namespace lsp
                 if (!sLibrary.initialized())
                     return STATUS_BAD_STATE;
 
-                // Invalidate all faces
+                // Drop all rendered text
+                sTextCache.clear();
+
+                // Drop all glyphs at once
                 lltl::parray<face_t> fonts;
                 if (!vFontCache.values(&fonts))
                     return STATUS_NO_MEM;
-                vFontCache.flush();
 
+                glyph_t *glyph = sGlyphs.clear();
+                while (glyph != NULL)
+                {
+                    glyph_t *next   = glyph->cache_next;
+                    free_glyph(glyph);
+                    glyph           = next;
+                }
+                nCacheSize      = 0;
+                ++nSerial;
+                sAllocator.trim();
+                for (size_t i=0, n=fonts.size(); i<n; ++i)
+                    fonts.uget(i)->cache_size   = 0;
+                for (size_t i=0, n=vFaces.size(); i<n; ++i)
+                {
+                    font_entry_t *entry = vFaces.uget(i);
+                    if (entry != NULL)
+                        entry->face->cache_size     = 0;
+                }
+
+                // Invalidate all faces
+                vFontCache.flush();
                 for (size_t i=0, n=fonts.size(); i<n; ++i)
                 {
                     face_t *face = fonts.uget(i);
@@ -574,7 +456,7 @@ namespace lsp
                     }
                 }
                 vAliases.flush();
-                sLRU.clear();
+                sFontIndex.clear();
 
                 return STATUS_OK;
             }
@@ -587,55 +469,58 @@ namespace lsp
                     return;
                 size_t cache_size = lsp_min(nMinCacheSize, nMaxCacheSize);
 
+                // Glyphs referenced by laid out glyph runs are going to be removed
+                ++nSerial;
                 while (nCacheSize > cache_size)
                 {
-                    // Remove glyph from LRU cache
-                    glyph_t *glyph      = sLRU.remove_last();
+                    // Remove the glyph which was not used recently
+                    glyph_t *glyph      = sGlyphs.evict();
                     if (glyph == NULL)
                         break;
 
-                    // Remove glyph from the face's cache
+                    // Update cache statistics
                     face_t *face        = glyph->face;
-                    if (face->cache.remove(glyph))
-                    {
-                        ++nGlyphRemoval;
-                        face->cache_size   -= glyph->szof;
-                        nCacheSize         -= glyph->szof;
-                    }
+                    ++nGlyphRemoval;
+                    face->cache_size   -= glyph->szof;
+                    nCacheSize         -= glyph->szof;
 
                     // Free the glyph data
                     free_glyph(glyph);
                 }
+
+                // Return memory of empty slabs to the system
+                sAllocator.trim();
             }
 
             glyph_t *FontManager::get_glyph(face_t *face, lsp_wchar_t ch)
             {
                 // Try to obtain glyph from cache
-                glyph_t *glyph  = face->cache.get(ch);
+                glyph_t *glyph  = sGlyphs.get(face, ch);
                 if (glyph != NULL)
                 {
                     ++nGlyphHits;
-                    return sLRU.touch(glyph); // Move glyph to the beginning of the LRU cache
+                    return glyph;
                 }
                 ++nGlyphMisses;
 
-                // There was no glyph present, create new glyph
-                glyph           = render_glyph(sLibrary, face, ch);
+                // There was no glyph present, try to load it from disk or render new glyph
+                glyph           = sDiskCache.load(face, ch, &sAllocator);
                 if (glyph == NULL)
-                    return NULL;
-
-                // Add glyph to the face cache
-                if (face->cache.put(glyph))
                 {
-                    // Call the garbage collector to collect the garbage
-                    gc();
+                    glyph           = render_glyph(sLibrary, face, ch, &sAllocator);
+                    if (glyph == NULL)
+                        return NULL;
+                    sDiskCache.store(glyph);
+                }
 
+                // Add glyph to the cache
+                if (sGlyphs.put(glyph))
+                {
                     // Update cache statistics
                     face->cache_size   += glyph->szof;
                     nCacheSize         += glyph->szof;
 
-                    // Add glyph to the LRU cache
-                    return sLRU.add_first(glyph);
+                    return glyph;
                 }
 
                 // Failed to add glyph
@@ -643,6 +528,120 @@ namespace lsp
                 return NULL;
             }
 
+            void FontManager::sync_prefetched()
+            {
+                Prefetcher::job_t *job = sPrefetcher.poll();
+                if (job == NULL)
+                    return;
+
+                for ( ; job != NULL; job = sPrefetcher.poll())
+                {
+                    // The face referenced only by the job has been removed, it's glyphs are not needed
+                    face_t *face        = job->face;
+                    const bool alive    = face->references > 1;
+
+                    for (size_t i=0, n=job->glyphs.size(); i<n; ++i)
+                    {
+                        // The glyph could be rendered by get_glyph() in the meantime
+                        glyph_t *glyph      = job->glyphs.uget(i);
+                        if ((!alive) || (sGlyphs.contains(face, glyph->codepoint)))
+                        {
+                            free_glyph(glyph);
+                            continue;
+                        }
+
+                        // The worker allocates glyphs in the heap, move them to the slabs
+                        glyph_t *moved      = sAllocator.move(glyph);
+                        if (moved == NULL)
+                        {
+                            free_glyph(glyph);
+                            continue;
+                        }
+                        glyph               = moved;
+                        if (!sGlyphs.put(glyph))
+                        {
+                            free_glyph(glyph);
+                            continue;
+                        }
+
+                        face->cache_size   += glyph->szof;
+                        nCacheSize         += glyph->szof;
+                        sDiskCache.store(glyph);
+                    }
+                    job->glyphs.flush();
+
+                    Prefetcher::destroy_job(job);
+                    dereference(face);
+                }
+            }
+
+            status_t FontManager::prefetch(const Font *f, lsp_wchar_t first, lsp_wchar_t last)
+            {
+                if (!sLibrary.initialized())
+                    return STATUS_BAD_STATE;
+                if (first > last)
+                    return STATUS_INVALID_VALUE;
+
+                face_t *face    = select_font_face(f);
+                if (face == NULL)
+                    return STATUS_NOT_FOUND;
+
+                Prefetcher::job_t *job = Prefetcher::create_job(face);
+                if (job == NULL)
+                    return STATUS_NO_MEM;
+                lsp_finally { Prefetcher::destroy_job(job); };
+
+                // Render only glyphs missing in the cache
+                for (lsp_wchar_t ch = first; ; ++ch)
+                {
+                    if (!sGlyphs.contains(face, ch))
+                    {
+                        if (!job->chars.add(&ch))
+                            return STATUS_NO_MEM;
+                    }
+                    if (ch == last)
+                        break;
+                }
+                if (job->chars.is_empty())
+                    return STATUS_OK;
+
+                // Submit the job, it holds the reference to the face until it is consumed
+                ++face->references;
+                status_t res    = sPrefetcher.submit(job);
+                if (res != STATUS_OK)
+                {
+                    --face->references;
+                    return res;
+                }
+                job             = NULL;
+
+                return STATUS_OK;
+            }
+
+            status_t FontManager::set_disk_cache(const io::Path *path)
+            {
+                if (!sLibrary.initialized())
+                    return STATUS_BAD_STATE;
+
+                // Persist glyphs of the previous cache
+                sDiskCache.flush();
+                sDiskCache.close();
+                if (path == NULL)
+                    return STATUS_OK;
+
+                // The rasterization result depends on the FreeType version
+                FT_Int major = 0, minor = 0, patch = 0;
+                sLibrary.version(&major, &minor, &patch);
+                const uint32_t version  = (uint32_t(major) << 16) | (uint32_t(minor) << 8) | uint32_t(patch);
+
+                return sDiskCache.open(path, version);
+            }
+
+            status_t FontManager::flush_disk_cache()
+            {
+                return sDiskCache.flush();
+            }
+
             void FontManager::set_cache_limits(size_t min, size_t max)
             {
                 size_t old_size             = nMaxCacheSize;
@@ -669,6 +668,11 @@ namespace lsp
                 return old_size;
             }
 
+            size_t FontManager::set_text_cache_size(size_t size)
+            {
+                return sTextCache.set_max_size(size);
+            }
+
             void FontManager::clear_cache_stats()
             {
                 nFaceHits                   = 0;
@@ -676,6 +680,8 @@ namespace lsp
                 nGlyphHits                  = 0;
                 nGlyphMisses                = 0;
                 nGlyphRemoval               = 0;
+                sTextCache.clear_stats();
+                sDiskCache.clear_stats();
             }
 
             face_t *FontManager::lookup_face(const face_id_t *id)
@@ -703,10 +709,9 @@ namespace lsp
                     return face;
 
                 status_t res;
-                font_info_t *info = select_best_font(id);
+                const FontIndex::font_info_t *info = sFontIndex.find(id->name, id->flags);
                 if (info == NULL)
                     return NULL;
-                lsp_finally { free(info); };
 
                 lsp_trace("Registering font id=\"%s\", family=%s, style=%s, weight=%d, slant=%d, path=%s",
                     id->name, info->family, info->style, info->weight, info->slant, info->path);
@@ -719,6 +724,12 @@ namespace lsp
 
             face_t *FontManager::select_font_face(const Font *f)
             {
+                // Collect glyphs rendered in background and shrink the glyph cache. The glyph cache
+                // is not shrinked while the text is being laid out, so the glyphs remain valid until
+                // the next call of the font manager.
+                sync_prefetched();
+                gc();
+
                 // Walk through aliases and get the real face name
                 const char *name = f->name();
                 if (name == NULL)
@@ -875,6 +886,125 @@ namespace lsp
                 return true;
             }
 
+            bool FontManager::build_run(face_t *face, GlyphRun *run, const LSPString *text, ssize_t first, ssize_t last)
+            {
+                run->vGlyphs.clear();
+                run->pFace          = face;
+                run->nSerial        = nSerial;
+                run->nSkew          = 0;
+                bzero(&run->sRange, sizeof(run->sRange));
+                if (first >= last)
+                    return true;
+
+                if (activate_face(sLibrary, face) != STATUS_OK)
+                    return false;
+
+                const size_t count  = last - first;
+                glyph_pos_t *vp     = run->vGlyphs.add_n(count);
+                if (vp == NULL)
+                    return false;
+
+                // Access the characters directly if the range lies within the string
+                const lsp_wchar_t *chars = ((first >= 0) && (size_t(last) <= text->length())) ?
+                    &text->characters()[first] : NULL;
+
+                ssize_t x_bearing   = 0;
+                ssize_t y_bearing   = 0;
+                ssize_t y_max       = 0;
+                ssize_t x           = 0;
+
+                for (size_t i=0; i<count; ++i)
+                {
+                    const lsp_wchar_t ch = (chars != NULL) ? chars[i] : text->char_at(first + i);
+                    glyph_t *glyph      = get_glyph(face, ch);
+                    if (glyph == NULL)
+                    {
+                        run->vGlyphs.clear();
+                        return false;
+                    }
+
+                    if (i == 0)
+                    {
+                        x_bearing           = glyph->x_bearing;
+                        y_bearing           = glyph->y_bearing;
+                        y_max               = glyph->bitmap.height - glyph->y_bearing;
+                    }
+                    else
+                    {
+                        y_bearing           = lsp_max(y_bearing, glyph->y_bearing);
+                        y_max               = lsp_max(y_max, glyph->bitmap.height - glyph->y_bearing);
+                    }
+
+                    glyph_pos_t *pos    = &vp[i];
+                    pos->glyph          = glyph;
+                    pos->x              = x + glyph->x_bearing;
+                    pos->y              = -glyph->y_bearing;
+
+                    x                  += f26p6_ceil_to_int(glyph->x_advance);
+                }
+
+                // Output the result
+                const ssize_t width = x - x_bearing;
+                const ssize_t height= y_max + y_bearing;
+                text_range_t *tp    = &run->sRange;
+
+                tp->x_bearing       = x_bearing;
+                tp->y_bearing       = -y_bearing;
+                tp->width           = width;
+                tp->height          = height;
+                tp->x_advance       = width + x_bearing;
+                tp->y_advance       = y_max + y_bearing;
+                run->nSkew          = (height * face->matrix.xy) / 0x10000;
+
+                return true;
+            }
+
+            dsp::bitmap_t *FontManager::composite(const GlyphRun *run)
+            {
+                const text_range_t *tp  = &run->sRange;
+                dsp::bitmap_t *bitmap   = create_bitmap(tp->width + run->nSkew, tp->height);
+                if (bitmap == NULL)
+                    return NULL;
+
+                const glyph_pos_t *vp   = run->vGlyphs.array();
+                for (size_t i=0, n=run->vGlyphs.size(); i<n; ++i)
+                {
+                    const glyph_pos_t *pos  = &vp[i];
+                    const glyph_t *glyph    = pos->glyph;
+                    const ssize_t cx        = pos->x - tp->x_bearing;
+                    const ssize_t cy        = pos->y - tp->y_bearing;
+
+                    switch (glyph->format)
+                    {
+                        case FMT_1_BPP:
+                            dsp::bitmap_max_b1b8(bitmap, &glyph->bitmap, cx, cy);
+                            break;
+                        case FMT_2_BPP:
+                            dsp::bitmap_max_b2b8(bitmap, &glyph->bitmap, cx, cy);
+                            break;
+                        case FMT_4_BPP:
+                            dsp::bitmap_max_b4b8(bitmap, &glyph->bitmap, cx, cy);
+                            break;
+                        case FMT_8_BPP:
+                        default:
+                            dsp::bitmap_max_b8b8(bitmap, &glyph->bitmap, cx, cy);
+                            break;
+                    }
+                }
+
+                return bitmap;
+            }
+
+            void FontManager::emit(const GlyphRun *run, glyph_callback_t cb, void *arg)
+            {
+                const glyph_pos_t *vp   = run->vGlyphs.array();
+                for (size_t i=0, n=run->vGlyphs.size(); i<n; ++i)
+                {
+                    const glyph_pos_t *pos  = &vp[i];
+                    cb(arg, pos->glyph, pos->x, pos->y);
+                }
+            }
+
             bool FontManager::get_text_parameters(const Font *f, text_range_t *tp, const LSPString *text, ssize_t first, ssize_t last)
             {
                 if ((text == NULL) || (first > last))
@@ -902,44 +1032,25 @@ namespace lsp
                 if (tp == NULL)
                     return true;
 
-                if (activate_face(sLibrary, face) != STATUS_OK)
-                    return false;
-
                 // Estimate the text parameters
-                lsp_wchar_t ch      = text->char_at(first);
-                glyph_t *glyph      = get_glyph(face, ch);
-                if (glyph == NULL)
+                if (!build_run(face, &sRun, text, first, last))
                     return false;
+                *tp                 = sRun.sRange;
 
-                ssize_t x_bearing   = glyph->x_bearing;
-                ssize_t y_bearing   = glyph->y_bearing;
-                ssize_t y_max       = glyph->bitmap.height - glyph->y_bearing;
-                ssize_t x           = f26p6_ceil_to_int(glyph->x_advance);
-
-                for (ssize_t i = first+1; i<last; ++i)
-                {
-                    ch                  = text->char_at(i);
-                    glyph               = get_glyph(face, ch);
-                    if (glyph == NULL)
-                        return false;
-
-                    y_bearing           = lsp_max(y_bearing, glyph->y_bearing);
-                    y_max               = lsp_max(y_max, glyph->bitmap.height - glyph->y_bearing);
-                    x                  += f26p6_ceil_to_int(glyph->x_advance);
-                }
+                return true;
+            }
 
-                // Output the result
-                ssize_t width       = x - x_bearing;
-                ssize_t height      = y_max + y_bearing;
+            bool FontManager::layout_text(const Font *f, GlyphRun *run, const LSPString *text, ssize_t first, ssize_t last)
+            {
+                if ((run == NULL) || (text == NULL) || (first > last))
+                    return false;
 
-                tp->x_bearing       = x_bearing;
-                tp->y_bearing       = -y_bearing;
-                tp->width           = width;
-                tp->height          = height;
-                tp->x_advance       = width + x_bearing;
-                tp->y_advance       = y_max + y_bearing;
+                // Select the font face
+                face_t *face        = select_font_face(f);
+                if (face == NULL)
+                    return false;
 
-                return true;
+                return build_run(face, run, text, first, last);
             }
 
             dsp::bitmap_t *FontManager::render_text(const Font *f, text_range_t *tp, const LSPString *text, ssize_t first, ssize_t last)
@@ -951,83 +1062,77 @@ namespace lsp
                 face_t *face        = select_font_face(f);
                 if (face == NULL)
                     return NULL;
-                if (activate_face(sLibrary, face) != STATUS_OK)
-                    return NULL;
 
-                // Estimate the text parameters
-                lsp_wchar_t ch      = text->char_at(first);
-                glyph_t *glyph      = get_glyph(face, ch);
-                if (glyph == NULL)
-                    return NULL;
+                // Lookup the text cache
+                const bool cacheable        = (first >= 0) && (size_t(last) <= text->length());
+                const lsp_wchar_t *chars    = (cacheable) ? &text->characters()[first] : NULL;
+                const size_t length         = last - first;
+                const uint32_t hash         = (cacheable) ? TextCache::hash(face, chars, length) : 0;
+                if (cacheable)
+                {
+                    const TextCache::text_t *t  = sTextCache.get(hash, face, chars, length);
+                    if (t != NULL)
+                    {
+                        if (tp != NULL)
+                            *tp                 = t->range;
+                        return reference_bitmap(t->bitmap);
+                    }
+                }
 
-                ssize_t x_bearing   = glyph->x_bearing;
-                ssize_t y_bearing   = glyph->y_bearing;
-                ssize_t y_max       = glyph->bitmap.height - glyph->y_bearing;
-                ssize_t x           = f26p6_ceil_to_int(glyph->x_advance);
+                // Lay out and render the text
+                if (!build_run(face, &sRun, text, first, last))
+                    return NULL;
+                dsp::bitmap_t *bitmap   = composite(&sRun);
+                if (bitmap == NULL)
+                    return NULL;
 
-                for (ssize_t i = first+1; i<last; ++i)
-                {
-                    ch                  = text->char_at(i);
-                    glyph               = get_glyph(face, ch);
-                    if (glyph == NULL)
-                        return NULL;
+                if (tp != NULL)
+                    *tp                 = sRun.sRange;
 
-                    y_bearing           = lsp_max(y_bearing, glyph->y_bearing);
-                    y_max               = lsp_max(y_max, glyph->bitmap.height - glyph->y_bearing);
-                    x                  += f26p6_ceil_to_int(glyph->x_advance);
-                }
+                // Store the rendered text in the cache
+                if (cacheable)
+                    sTextCache.put(hash, face, chars, length, bitmap, &sRun.sRange);
 
-                // Allocate the bitmap
-                ssize_t width       = x - x_bearing;
-                ssize_t height      = y_max + y_bearing;
+                return bitmap;
+            }
 
-                dsp::bitmap_t *bitmap   = create_bitmap(width + (height * face->matrix.xy) / 0x10000, height);
-                if (bitmap == NULL)
+            dsp::bitmap_t *FontManager::render_text(const GlyphRun *run)
+            {
+                if ((run == NULL) || (run->vGlyphs.is_empty()) || (!is_valid(run)))
                     return NULL;
 
-                // Render the contents to the bitmap
-                x                   = 0;
-                for (ssize_t i = first; i<last; ++i)
-                {
-                    ch                  = text->char_at(i);
-                    glyph               = get_glyph(face, ch);
-                    if (glyph == NULL)
-                        return NULL;
+                return composite(run);
+            }
 
-                    ssize_t cx          = x - x_bearing + glyph->x_bearing;
-                    ssize_t cy          = y_bearing - glyph->y_bearing;
+            bool FontManager::render_glyphs(const Font *f, text_range_t *tp, const LSPString *text, ssize_t first, ssize_t last,
+                glyph_callback_t cb, void *arg)
+            {
+                if ((text == NULL) || (first >= last))
+                    return false;
 
-                    switch (glyph->format)
-                    {
-                        case FMT_1_BPP:
-                            dsp::bitmap_max_b1b8(bitmap, &glyph->bitmap, cx, cy);
-                            break;
-                        case FMT_2_BPP:
-                            dsp::bitmap_max_b2b8(bitmap, &glyph->bitmap, cx, cy);
-                            break;
-                        case FMT_4_BPP:
-                            dsp::bitmap_max_b4b8(bitmap, &glyph->bitmap, cx, cy);
-                            break;
-                        case FMT_8_BPP:
-                        default:
-                            dsp::bitmap_max_b8b8(bitmap, &glyph->bitmap, cx, cy);
-                            break;
-                    }
+                // Select the font face
+                face_t *face        = select_font_face(f);
+                if (face == NULL)
+                    return false;
 
-                    x                  += f26p6_ceil_to_int(glyph->x_advance);
-                }
+                // Lay out the text and pass glyphs to the callback
+                if (!build_run(face, &sRun, text, first, last))
+                    return false;
+                emit(&sRun, cb, arg);
 
                 if (tp != NULL)
-                {
-                    tp->x_bearing       = x_bearing;
-                    tp->y_bearing       = -y_bearing;
-                    tp->width           = width;
-                    tp->height          = height;
-                    tp->x_advance       = width + x_bearing;
-                    tp->y_advance       = y_max + y_bearing;
-                }
+                    *tp                 = sRun.sRange;
 
-                return bitmap;
+                return true;
+            }
+
+            bool FontManager::render_glyphs(const GlyphRun *run, glyph_callback_t cb, void *arg)
+            {
+                if ((run == NULL) || (!is_valid(run)))
+                    return false;
+
+                emit(run, cb, arg);
+                return true;
             }
         } /* namespace ft */
     } /* namespace ws */
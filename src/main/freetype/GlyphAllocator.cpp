@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/freetype/GlyphAllocator.h>
+
+#ifdef PLATFORM_POSIX
+    #include <sys/mman.h>
+#endif /* PLATFORM_POSIX */
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            const size_t GlyphAllocator::vClassSize[GlyphAllocator::CLASSES] =
+            {
+                0x80, 0xc0, 0x100, 0x180, 0x200, 0x300, 0x400, 0x600, 0x800, 0xc00, 0x1000
+            };
+
+            static void *map_memory(size_t size)
+            {
+            #ifdef PLATFORM_POSIX
+                // Anonymous mapping is returned to the system immediately on release
+                void *ptr = ::mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                return (ptr != MAP_FAILED) ? ptr : NULL;
+            #else
+                return malloc(size);
+            #endif /* PLATFORM_POSIX */
+            }
+
+            static void unmap_memory(void *ptr, size_t size)
+            {
+            #ifdef PLATFORM_POSIX
+                ::munmap(ptr, size);
+            #else
+                free(ptr);
+            #endif /* PLATFORM_POSIX */
+            }
+
+            GlyphAllocator::GlyphAllocator()
+            {
+                for (size_t i=0; i<CLASSES; ++i)
+                {
+                    vPartial[i]         = NULL;
+                    vFull[i]            = NULL;
+                }
+                pLarge              = NULL;
+                nUsed               = 0;
+                nReserved           = 0;
+                nSlabs              = 0;
+            }
+
+            GlyphAllocator::~GlyphAllocator()
+            {
+                // Glyphs should be released before the allocator
+                for (size_t i=0; i<CLASSES; ++i)
+                {
+                    while (vPartial[i] != NULL)
+                        destroy_slab(&vPartial[i], vPartial[i]);
+                    while (vFull[i] != NULL)
+                        destroy_slab(&vFull[i], vFull[i]);
+                }
+                while (pLarge != NULL)
+                    destroy_slab(&pLarge, pLarge);
+
+                nUsed               = 0;
+            }
+
+            size_t GlyphAllocator::size_class(size_t size)
+            {
+                for (size_t i=0; i<CLASSES; ++i)
+                    if (size <= vClassSize[i])
+                        return i;
+                return CLASSES;
+            }
+
+            inline void GlyphAllocator::unlink(glyph_slab_t **list, glyph_slab_t *slab)
+            {
+                if (slab->prev != NULL)
+                    slab->prev->next    = slab->next;
+                else
+                    *list               = slab->next;
+                if (slab->next != NULL)
+                    slab->next->prev    = slab->prev;
+
+                slab->prev          = NULL;
+                slab->next          = NULL;
+            }
+
+            inline void GlyphAllocator::link_first(glyph_slab_t **list, glyph_slab_t *slab)
+            {
+                slab->prev          = NULL;
+                slab->next          = *list;
+                if (*list != NULL)
+                    (*list)->prev       = slab;
+                *list               = slab;
+            }
+
+            inline void GlyphAllocator::link_last(glyph_slab_t **list, glyph_slab_t *slab)
+            {
+                glyph_slab_t *last  = *list;
+                if (last == NULL)
+                {
+                    link_first(list, slab);
+                    return;
+                }
+                while (last->next != NULL)
+                    last                = last->next;
+
+                slab->prev          = last;
+                slab->next          = NULL;
+                last->next          = slab;
+            }
+
+            glyph_slab_t *GlyphAllocator::create_slab(size_t sclass, size_t size)
+            {
+                const size_t szof_hdr   = align_size(sizeof(glyph_slab_t), DEFAULT_ALIGN);
+                const size_t to_alloc   = (sclass < CLASSES) ? SLAB_SIZE : szof_hdr + size;
+
+                uint8_t *ptr            = static_cast<uint8_t *>(map_memory(to_alloc));
+                if (ptr == NULL)
+                    return NULL;
+
+                glyph_slab_t *slab      = reinterpret_cast<glyph_slab_t *>(ptr);
+                slab->owner             = this;
+                slab->prev              = NULL;
+                slab->next              = NULL;
+                slab->free              = NULL;
+                slab->sclass            = sclass;
+                slab->used              = 0;
+                slab->capacity          = (sclass < CLASSES) ? (SLAB_SIZE - szof_hdr) / vClassSize[sclass] : 1;
+                slab->allocated         = 0;
+                slab->size              = to_alloc;
+                slab->data              = &ptr[szof_hdr];
+
+                nReserved              += to_alloc;
+                ++nSlabs;
+
+                return slab;
+            }
+
+            void GlyphAllocator::destroy_slab(glyph_slab_t **list, glyph_slab_t *slab)
+            {
+                unlink(list, slab);
+
+                nReserved              -= slab->size;
+                --nSlabs;
+                unmap_memory(slab, slab->size);
+            }
+
+            glyph_t *GlyphAllocator::allocate(size_t size)
+            {
+                const size_t sclass     = size_class(size);
+                glyph_slab_t *slab      = NULL;
+                uint8_t *ptr            = NULL;
+                size_t szof             = 0;
+
+                if (sclass < CLASSES)
+                {
+                    // Obtain the slab with free slots
+                    glyph_slab_t **list     = &vPartial[sclass];
+                    if ((slab = *list) == NULL)
+                    {
+                        if ((slab = create_slab(sclass, vClassSize[sclass])) == NULL)
+                            return NULL;
+                        link_first(list, slab);
+                    }
+
+                    // Take released slot first, then take the next untouched slot
+                    szof                    = vClassSize[sclass];
+                    if (slab->free != NULL)
+                    {
+                        ptr                     = slab->free;
+                        slab->free              = *reinterpret_cast<uint8_t **>(ptr);
+                    }
+                    else
+                        ptr                     = &slab->data[(slab->allocated++) * szof];
+
+                    // Move the full slab out of the list of slabs with free slots
+                    if ((++slab->used) >= slab->capacity)
+                    {
+                        unlink(list, slab);
+                        link_first(&vFull[sclass], slab);
+                    }
+                }
+                else
+                {
+                    // The glyph is too large, allocate dedicated slab
+                    if ((slab = create_slab(sclass, size)) == NULL)
+                        return NULL;
+                    link_first(&pLarge, slab);
+
+                    szof                    = size;
+                    ptr                     = slab->data;
+                    slab->used              = 1;
+                    slab->allocated         = 1;
+                }
+
+                glyph_t *glyph          = reinterpret_cast<glyph_t *>(ptr);
+                glyph->slab             = slab;
+                glyph->szof             = szof;
+                nUsed                  += szof;
+
+                return glyph;
+            }
+
+            glyph_t *GlyphAllocator::move(glyph_t *glyph)
+            {
+                if (glyph->slab != NULL)
+                    return glyph;
+
+                // Allocate the glyph with the same bitmap size
+                const size_t bytes      = size_t(glyph->bitmap.stride) * glyph->bitmap.height;
+                glyph_t *res            = allocate(sizeof(glyph_t) + DEFAULT_ALIGN + bytes);
+                if (res == NULL)
+                    return NULL;
+
+                // Copy the glyph
+                glyph_slab_t *slab      = res->slab;
+                const size_t szof       = res->szof;
+                *res                    = *glyph;
+                res->slab               = slab;
+                res->szof               = szof;
+                res->bitmap.data        = align_ptr(&reinterpret_cast<uint8_t *>(res)[sizeof(glyph_t)], DEFAULT_ALIGN);
+                memcpy(res->bitmap.data, glyph->bitmap.data, bytes);
+
+                free(glyph);
+
+                return res;
+            }
+
+            void GlyphAllocator::release(glyph_t *glyph)
+            {
+                if (glyph == NULL)
+                    return;
+
+                glyph_slab_t *slab      = glyph->slab;
+                if (slab != NULL)
+                    slab->owner->release_slot(glyph);
+                else
+                    free(glyph);
+            }
+
+            void GlyphAllocator::release_slot(glyph_t *glyph)
+            {
+                glyph_slab_t *slab      = glyph->slab;
+                nUsed                  -= glyph->szof;
+
+                // Dedicated slab is released immediately
+                if (slab->sclass >= CLASSES)
+                {
+                    destroy_slab(&pLarge, slab);
+                    return;
+                }
+
+                // Add slot to the list of released slots
+                uint8_t *ptr            = reinterpret_cast<uint8_t *>(glyph);
+                *reinterpret_cast<uint8_t **>(ptr) = slab->free;
+                slab->free              = ptr;
+
+                // Full slab now has free slot
+                glyph_slab_t **list     = &vPartial[slab->sclass];
+                if ((slab->used--) >= slab->capacity)
+                {
+                    unlink(&vFull[slab->sclass], slab);
+                    link_first(list, slab);
+                }
+
+                // Empty slabs are kept at the end of the list to be released by trim()
+                if ((slab->used == 0) && (slab->next != NULL))
+                {
+                    unlink(list, slab);
+                    link_last(list, slab);
+                }
+            }
+
+            size_t GlyphAllocator::trim()
+            {
+                const size_t reserved   = nReserved;
+
+                for (size_t i=0; i<CLASSES; ++i)
+                {
+                    for (glyph_slab_t *slab = vPartial[i]; slab != NULL; )
+                    {
+                        glyph_slab_t *next      = slab->next;
+                        if (slab->used == 0)
+                            destroy_slab(&vPartial[i], slab);
+                        slab                    = next;
+                    }
+                }
+
+                return reserved - nReserved;
+            }
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
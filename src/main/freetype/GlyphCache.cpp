@@ -21,6 +21,9 @@
 
 #ifdef USE_LIBFREETYPE
 
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/stdlib/string.h>
+
 #include <private/freetype/GlyphCache.h>
 
 namespace lsp
@@ -33,190 +36,274 @@ namespace lsp
             {
                 nSize       = 0;
                 nCap        = 0;
-                vBins       = NULL;
+                nHand       = 0;
+                pData       = NULL;
+                vFaces      = NULL;
+                vCodes      = NULL;
+                vGlyphs     = NULL;
+                vRefs       = NULL;
             }
 
             GlyphCache::~GlyphCache()
             {
                 nSize       = 0;
                 nCap        = 0;
-                if (vBins != NULL)
+                nHand       = 0;
+                if (pData != NULL)
                 {
-                    free(vBins);
-                    vBins       = NULL;
+                    free(pData);
+                    pData       = NULL;
                 }
+                vFaces      = NULL;
+                vCodes      = NULL;
+                vGlyphs     = NULL;
+                vRefs       = NULL;
             }
 
-            bool GlyphCache::put(glyph_t *glyph)
+            inline size_t GlyphCache::hash(const face_t *face, lsp_wchar_t codepoint)
+            {
+                const uint32_t f    = uint32_t(reinterpret_cast<uintptr_t>(face) >> 4);
+                return (f * 0x9e3779b1) ^ (codepoint * 0x85ebca6b);
+            }
+
+            ssize_t GlyphCache::index_of(const face_t *face, lsp_wchar_t codepoint) const
+            {
+                if (nSize == 0)
+                    return -1;
+
+                const size_t mask   = nCap - 1;
+                for (size_t i = hash(face, codepoint) & mask; vGlyphs[i] != NULL; i = (i + 1) & mask)
+                {
+                    if ((vCodes[i] == codepoint) && (vFaces[i] == face))
+                        return i;
+                }
+
+                return -1;
+            }
+
+            void GlyphCache::remove_at(size_t index)
             {
-                bin_t *bin      = (vBins != NULL) ? &vBins[glyph->codepoint & (nCap - 1)] : NULL;
-                if (bin != NULL)
+                // Backward shift deletion: move the following glyphs of the probe sequence
+                // to the released slot to keep all probe sequences continuous
+                const size_t mask   = nCap - 1;
+                for (size_t j = (index + 1) & mask; vGlyphs[j] != NULL; j = (j + 1) & mask)
                 {
-                    // Ensure that glyph is not present
-                    for (glyph_t *g = bin->data; g != NULL; g = g->cache_next)
-                        if (g->codepoint == glyph->codepoint)
-                            return false;
+                    const size_t k      = hash(vFaces[j], vCodes[j]) & mask;
+                    const bool keep     = (index <= j) ?
+                        ((index < k) && (k <= j)) :
+                        ((index < k) || (k <= j));
+                    if (keep)
+                        continue;
+
+                    vFaces[index]       = vFaces[j];
+                    vCodes[index]       = vCodes[j];
+                    vGlyphs[index]      = vGlyphs[j];
+                    vRefs[index]        = vRefs[j];
+                    index               = j;
                 }
 
-                // Need to grow?
-                if (nSize >= (nCap << 2))
+                vFaces[index]       = NULL;
+                vCodes[index]       = 0;
+                vGlyphs[index]      = NULL;
+                vRefs[index]        = 0;
+                --nSize;
+            }
+
+            bool GlyphCache::rehash(size_t cap)
+            {
+                // Allocate new table
+                const size_t szof_faces = align_size(cap * sizeof(const face_t *), DEFAULT_ALIGN);
+                const size_t szof_glyphs= align_size(cap * sizeof(glyph_t *), DEFAULT_ALIGN);
+                const size_t szof_codes = align_size(cap * sizeof(lsp_wchar_t), DEFAULT_ALIGN);
+                const size_t szof_refs  = cap * sizeof(uint8_t);
+
+                uint8_t *data           = static_cast<uint8_t *>(malloc(szof_faces + szof_glyphs + szof_codes + szof_refs));
+                if (data == NULL)
+                    return false;
+                bzero(data, szof_faces + szof_glyphs + szof_codes + szof_refs);
+
+                uint8_t *ptr            = data;
+                const face_t **faces    = reinterpret_cast<const face_t **>(ptr);
+                ptr                    += szof_faces;
+                glyph_t **glyphs        = reinterpret_cast<glyph_t **>(ptr);
+                ptr                    += szof_glyphs;
+                lsp_wchar_t *codes      = reinterpret_cast<lsp_wchar_t *>(ptr);
+                ptr                    += szof_codes;
+                uint8_t *refs           = ptr;
+
+                // Migrate glyphs
+                const size_t mask       = cap - 1;
+                for (size_t i=0; i<nCap; ++i)
                 {
-                    if (!grow())
+                    if (vGlyphs[i] == NULL)
+                        continue;
+
+                    size_t j                = hash(vFaces[i], vCodes[i]) & mask;
+                    while (glyphs[j] != NULL)
+                        j                       = (j + 1) & mask;
+
+                    faces[j]                = vFaces[i];
+                    codes[j]                = vCodes[i];
+                    glyphs[j]               = vGlyphs[i];
+                    refs[j]                 = vRefs[i];
+                }
+
+                // Replace the table
+                if (pData != NULL)
+                    free(pData);
+
+                pData                   = data;
+                vFaces                  = faces;
+                vCodes                  = codes;
+                vGlyphs                 = glyphs;
+                vRefs                   = refs;
+                nCap                    = cap;
+                nHand                   = 0;
+
+                return true;
+            }
+
+            bool GlyphCache::put(glyph_t *glyph)
+            {
+                const face_t *face      = glyph->face;
+                const lsp_wchar_t cp    = glyph->codepoint;
+
+                // Ensure that glyph is not present
+                if (index_of(face, cp) >= 0)
+                    return false;
+
+                // Keep the load factor not greater than 1/2
+                if (((nSize + 1) << 1) > nCap)
+                {
+                    if (!rehash((nCap > 0) ? nCap << 1 : MIN_CAPACITY))
                         return false;
-                    bin      = (vBins != NULL) ? &vBins[glyph->codepoint & (nCap - 1)] : NULL;
                 }
 
-                // Add item to the bin
-                glyph->cache_next   = bin->data;
-                bin->data           = glyph;
-                ++bin->size;
+                // Add glyph to the table, new glyph has a second chance
+                const size_t mask       = nCap - 1;
+                size_t i                = hash(face, cp) & mask;
+                while (vGlyphs[i] != NULL)
+                    i                       = (i + 1) & mask;
+
+                vFaces[i]               = face;
+                vCodes[i]               = cp;
+                vGlyphs[i]              = glyph;
+                vRefs[i]                = 1;
                 ++nSize;
 
                 return true;
             }
 
-            glyph_t *GlyphCache::get(lsp_wchar_t codepoint)
+            glyph_t *GlyphCache::get(const face_t *face, lsp_wchar_t codepoint)
             {
-                bin_t *bin      = (vBins != NULL) ? &vBins[codepoint & (nCap - 1)] : NULL;
-                if (bin == NULL)
+                const ssize_t index     = index_of(face, codepoint);
+                if (index < 0)
                     return NULL;
 
-                // Find the corresponding glyph
-                for (glyph_t *g = bin->data; g != NULL; g = g->cache_next)
-                    if (g->codepoint == codepoint)
-                        return g;
+                vRefs[index]            = 1;
+                return vGlyphs[index];
+            }
 
-                return NULL;
+            bool GlyphCache::contains(const face_t *face, lsp_wchar_t codepoint) const
+            {
+                return index_of(face, codepoint) >= 0;
             }
 
             bool GlyphCache::remove(glyph_t *glyph)
             {
-                // Get the bin
-                bin_t *bin      = (vBins != NULL) ? &vBins[glyph->codepoint & (nCap - 1)] : NULL;
-                if (bin == NULL)
+                const ssize_t index     = index_of(glyph->face, glyph->codepoint);
+                if ((index < 0) || (vGlyphs[index] != glyph))
                     return false;
 
-                // Scan the list
-                for (glyph_t **pcurr = &bin->data; *pcurr != NULL; )
-                {
-                    glyph_t *curr = *pcurr;
-                    if (curr == glyph)
-                    {
-                        *pcurr              = curr->cache_next;
-                        curr->cache_next    = NULL;
-                        --bin->size;
-                        --nSize;
-                        return true;
-                    }
-                    pcurr   = &curr->cache_next;
-                }
-
-                return false;
+                remove_at(index);
+                return true;
             }
 
-            glyph_t *GlyphCache::clear()
+            glyph_t *GlyphCache::evict()
             {
-                if (vBins == NULL)
+                if (nSize == 0)
                     return NULL;
 
-                glyph_t *root   = NULL;
-
-                for (size_t i=0; i<nCap; ++i)
+                // Each glyph is visited at most twice: first time to clear the reference bit
+                const size_t mask       = nCap - 1;
+                while (true)
                 {
-                    // Get the next bin, ensure that it contains data
-                    bin_t *bin      = &vBins[i];
-                    if (bin->data == NULL)
+                    const size_t index      = nHand;
+                    glyph_t *glyph          = vGlyphs[index];
+                    if (glyph == NULL)
+                    {
+                        nHand                   = (nHand + 1) & mask;
                         continue;
+                    }
+                    if (vRefs[index])
+                    {
+                        vRefs[index]            = 0;
+                        nHand                   = (nHand + 1) & mask;
+                        continue;
+                    }
 
-                    // Walk through the list and find last item
-                    glyph_t *curr       = bin->data;
-                    while (curr->cache_next != NULL)
-                        curr    = curr->cache_next;
-
-                    // Link the list of removed glyphs
-                    curr->cache_next    = root;
-                    root                = bin->data;
+                    // The hand stays at the same position since the next glyph may be shifted here
+                    remove_at(index);
+                    glyph->cache_next       = NULL;
+                    return glyph;
                 }
-
-                // Cleanup all data
-                nSize       = 0;
-                nCap        = 0;
-
-                // Cleanup bins
-                free(vBins);
-                vBins       = NULL;
-
-                return root;
             }
 
-            bool GlyphCache::grow()
+            glyph_t *GlyphCache::remove_face(const face_t *face)
             {
-                bin_t *xbin, *ybin;
-                size_t ncap, mask;
+                glyph_t *root           = NULL;
 
-                // No previous allocations?
-                if (nCap == 0)
+                for (size_t i=0; i<nCap; )
                 {
-                    xbin            = static_cast<bin_t *>(::malloc(0x10 * sizeof(bin_t)));
-                    if (xbin == NULL)
-                        return false; // Very bad things?
-
-                    nCap            = 0x10;
-                    vBins           = xbin;
-                    for (size_t i=0; i<nCap; ++i, ++xbin)
+                    glyph_t *glyph          = vGlyphs[i];
+                    if ((glyph == NULL) || (vFaces[i] != face))
                     {
-                        xbin->size      = 0;
-                        xbin->data      = NULL;
+                        ++i;
+                        continue;
                     }
 
-                    return true;
+                    // Check the same slot again since the next glyph may be shifted here
+                    remove_at(i);
+                    glyph->cache_next       = root;
+                    root                    = glyph;
                 }
 
-                // Twice increase the capacity of hash
-                ncap            = nCap << 1;
-                xbin            = static_cast<bin_t *>(::realloc(vBins, ncap * sizeof(bin_t)));
-                if (xbin == NULL)
-                    return false; // Very bad things?
+                return root;
+            }
 
-                // Now we need to split data
-                mask            = (ncap - 1) ^ (nCap - 1); // mask indicates the bit which has been set
-                vBins           = xbin;
-                ybin            = &xbin[nCap];
+            glyph_t *GlyphCache::clear()
+            {
+                glyph_t *root           = NULL;
 
-                for (size_t i=0; i<nCap; ++i, ++xbin, ++ybin)
+                for (size_t i=0; i<nCap; ++i)
                 {
-                    // There is no data in ybin by default
-                    ybin->size      = 0;
-                    ybin->data      = 0;
+                    glyph_t *glyph          = vGlyphs[i];
+                    if (glyph == NULL)
+                        continue;
 
-                    // Migrate items from xbin list to ybin list
-                    for (glyph_t **pcurr = &xbin->data; *pcurr != NULL; )
-                    {
-                        glyph_t *curr   = *pcurr;
-                        if (curr->codepoint & mask)
-                        {
-                            *pcurr              = curr->cache_next;
-                            curr->cache_next    = ybin->data;
-                            ybin->data          = curr;
-                            --xbin->size;
-                            ++ybin->size;
-                        }
-                        else
-                            pcurr               = &curr->cache_next;
-                    }
+                    glyph->cache_next       = root;
+                    root                    = glyph;
                 }
 
-                // Split success
-                nCap            = ncap;
+                // Cleanup all data
+                nSize                   = 0;
+                nCap                    = 0;
+                nHand                   = 0;
+                if (pData != NULL)
+                {
+                    free(pData);
+                    pData                   = NULL;
+                }
+                vFaces                  = NULL;
+                vCodes                  = NULL;
+                vGlyphs                 = NULL;
+                vRefs                   = NULL;
 
-                return true;
+                return root;
             }
 
-
         } /* namespace ft */
     } /* namespace ws */
 } /* namespace lsp */
 
 #endif /* USE_LIBFREETYPE */
-
-
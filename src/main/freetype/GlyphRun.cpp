@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/freetype/GlyphRun.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            GlyphRun::GlyphRun()
+            {
+                pFace               = NULL;
+                nSerial             = 0;
+                nSkew               = 0;
+                bzero(&sRange, sizeof(sRange));
+            }
+
+            GlyphRun::~GlyphRun()
+            {
+                vGlyphs.flush();
+            }
+
+            void GlyphRun::clear()
+            {
+                vGlyphs.flush();
+                pFace               = NULL;
+                nSerial             = 0;
+                nSkew               = 0;
+                bzero(&sRange, sizeof(sRange));
+            }
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
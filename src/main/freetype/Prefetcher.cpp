@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/freetype/Prefetcher.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            Prefetcher::Prefetcher()
+            {
+                pThread                 = NULL;
+                for (size_t i=0; i<JOBS_MAX; ++i)
+                    vDone[i]                = NULL;
+                atomic_store(&nTail, 0);
+                nHead                   = 0;
+                nJobs                   = 0;
+            }
+
+            Prefetcher::~Prefetcher()
+            {
+                stop();
+
+                // Drop all jobs that were not consumed
+                for (job_t *job; (job = poll()) != NULL; )
+                    destroy_job(job);
+            }
+
+            Prefetcher::job_t *Prefetcher::create_job(face_t *face)
+            {
+                job_t *job              = new job_t;
+                if (job == NULL)
+                    return NULL;
+
+                job->face               = face;
+                job->data               = face->font->data;
+                job->size               = face->font->size;
+                job->index              = face->ft_face->face_index;
+                job->flags              = face->flags;
+                job->h_size             = face->h_size;
+                job->v_size             = face->v_size;
+                job->matrix             = face->matrix;
+
+                return job;
+            }
+
+            void Prefetcher::destroy_job(job_t *job)
+            {
+                if (job == NULL)
+                    return;
+
+                for (size_t i=0, n=job->glyphs.size(); i<n; ++i)
+                    free_glyph(job->glyphs.uget(i));
+                job->glyphs.flush();
+                job->chars.flush();
+
+                delete job;
+            }
+
+            status_t Prefetcher::submit(job_t *job)
+            {
+                if (nJobs >= JOBS_MAX)
+                    return STATUS_OVERFLOW;
+
+                // Start the worker thread
+                if (pThread == NULL)
+                {
+                    status_t res = sLibrary.init();
+                    if (res != STATUS_OK)
+                        return res;
+
+                    ipc::Thread *thread = new ipc::Thread(execute, this);
+                    if (thread == NULL)
+                    {
+                        sLibrary.destroy();
+                        return STATUS_NO_MEM;
+                    }
+
+                    pThread             = thread;
+                    if ((res = thread->start()) != STATUS_OK)
+                    {
+                        pThread             = NULL;
+                        delete thread;
+                        sLibrary.destroy();
+                        return res;
+                    }
+                }
+
+                // Enqueue the job
+                sLock.lock();
+                lsp_finally { sLock.unlock(); };
+
+                if (!vPending.add(job))
+                    return STATUS_NO_MEM;
+                ++nJobs;
+                sLock.notify();
+
+                return STATUS_OK;
+            }
+
+            Prefetcher::job_t *Prefetcher::poll()
+            {
+                // The ring can not overflow since the number of outstanding jobs is limited
+                if (nHead == atomic_load(&nTail))
+                    return NULL;
+
+                job_t *job              = vDone[nHead % JOBS_MAX];
+                vDone[nHead % JOBS_MAX] = NULL;
+                ++nHead;
+                --nJobs;
+
+                return job;
+            }
+
+            void Prefetcher::stop()
+            {
+                if (pThread == NULL)
+                    return;
+
+                // Terminate the thread, it completes all pending jobs without rendering
+                {
+                    sLock.lock();
+                    lsp_finally { sLock.unlock(); };
+
+                    pThread->cancel();
+                    sLock.notify_all();
+                }
+
+                // Wait until thread has terminated
+                pThread->join();
+                delete pThread;
+                pThread             = NULL;
+
+                sLibrary.destroy();
+            }
+
+            status_t Prefetcher::execute(void *arg)
+            {
+                Prefetcher * const self = static_cast<Prefetcher *>(arg);
+                return self->run();
+            }
+
+            status_t Prefetcher::run()
+            {
+                while (true)
+                {
+                    // Wait for the next job
+                    job_t *job  = NULL;
+                    {
+                        sLock.lock();
+                        lsp_finally { sLock.unlock(); };
+
+                        while ((job = vPending.shift()) == NULL)
+                        {
+                            if (ipc::Thread::is_cancelled())
+                                return STATUS_OK;
+                            sLock.wait();
+                        }
+                    }
+
+                    // Render glyphs and pass the job back to the owner
+                    if (!ipc::Thread::is_cancelled())
+                        render(job);
+                    complete(job);
+                }
+            }
+
+            void Prefetcher::render(job_t *job)
+            {
+                FT_Open_Args args;
+                FT_Face ft_face;
+
+                // Open own instance of the face, FreeType objects can not be shared between threads
+                args.flags          = FT_OPEN_MEMORY;
+                args.memory_base    = job->data;
+                args.memory_size    = job->size;
+                args.pathname       = NULL;
+                args.stream         = NULL;
+                args.driver         = NULL;
+                args.num_params     = 0;
+                args.params         = NULL;
+
+                if (sLibrary.open_face(&args, job->index, &ft_face) != FT_Err_Ok)
+                    return;
+                lsp_finally { sLibrary.done_face(ft_face); };
+
+                face_t face;
+                face.references     = 0;
+                face.cache_size     = 0;
+                face.ft_face        = ft_face;
+                face.ft_size        = NULL;
+                face.font           = NULL;
+                face.flags          = job->flags;
+                face.h_size         = job->h_size;
+                face.v_size         = job->v_size;
+                face.matrix         = job->matrix;
+                face.height         = 0;
+                face.ascent         = 0;
+                face.descent        = 0;
+                lsp_finally { sLibrary.done_size(face.ft_size); };
+
+                if (activate_face(sLibrary, &face) != STATUS_OK)
+                    return;
+
+                // Render glyphs
+                for (size_t i=0, n=job->chars.size(); i<n; ++i)
+                {
+                    if (ipc::Thread::is_cancelled())
+                        break;
+
+                    // Do not waste the cache for characters missing in the font
+                    const lsp_wchar_t ch    = *job->chars.uget(i);
+                    if (sLibrary.get_char_index(ft_face, ch) == 0)
+                        continue;
+
+                    glyph_t *glyph          = render_glyph(sLibrary, &face, ch, NULL);
+                    if (glyph == NULL)
+                        continue;
+
+                    glyph->face             = job->face;
+                    if (!job->glyphs.add(glyph))
+                    {
+                        free_glyph(glyph);
+                        break;
+                    }
+                }
+            }
+
+            void Prefetcher::complete(job_t *job)
+            {
+                // Only the worker writes the tail, only the owner reads the slots behind the tail
+                const uatomic_t tail    = atomic_load(&nTail);
+                vDone[tail % JOBS_MAX]  = job;
+                atomic_store(&nTail, tail + 1);
+            }
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/freetype/bitmap.h>
+#include <private/freetype/TextCache.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            TextCache::TextCache(size_t max_size):
+                sCache(BINS, max_size, destroy)
+            {
+            }
+
+            TextCache::~TextCache()
+            {
+                clear();
+            }
+
+            uint32_t TextCache::hash(const face_t *face, const lsp_wchar_t *text, size_t length)
+            {
+                // FNV-1a over the face pointer and characters
+                const uintptr_t fp  = reinterpret_cast<uintptr_t>(face);
+                uint32_t h          = 0x811c9dc5;
+
+                h                   = (h ^ uint32_t(fp)) * 0x01000193;
+                h                   = (h ^ uint32_t(uint64_t(fp) >> 32)) * 0x01000193;
+                for (size_t i=0; i<length; ++i)
+                    h                   = (h ^ uint32_t(text[i])) * 0x01000193;
+                h                   = (h ^ uint32_t(length)) * 0x01000193;
+
+                return h;
+            }
+
+            bool TextCache::match(const lru_item_t *item, const void *key)
+            {
+                const text_t *t     = reinterpret_cast<const text_t *>(item);
+                const key_t *k      = static_cast<const key_t *>(key);
+
+                return (t->face == k->face) &&
+                    (t->length == k->length) &&
+                    (memcmp(t->text, k->text, k->length * sizeof(lsp_wchar_t)) == 0);
+            }
+
+            void TextCache::destroy(lru_item_t *item)
+            {
+                text_t *t           = reinterpret_cast<text_t *>(item);
+                free_bitmap(t->bitmap);
+                free(t);
+            }
+
+            const TextCache::text_t *TextCache::get(uint32_t hash, const face_t *face, const lsp_wchar_t *text, size_t length)
+            {
+                key_t key;
+                key.face                = face;
+                key.text                = text;
+                key.length              = length;
+
+                return reinterpret_cast<const text_t *>(sCache.get(hash, match, &key));
+            }
+
+            bool TextCache::put(
+                uint32_t hash, const face_t *face, const lsp_wchar_t *text, size_t length,
+                dsp::bitmap_t *bitmap, const text_range_t *range)
+            {
+                // Estimate the size of the record
+                const size_t szof_hdr   = align_size(sizeof(text_t), DEFAULT_ALIGN);
+                const size_t szof_text  = length * sizeof(lsp_wchar_t);
+                const size_t szof_bmp   = sizeof(dsp::bitmap_t) + size_t(bitmap->stride) * bitmap->height;
+                const size_t to_alloc   = szof_hdr + szof_text;
+                const size_t size       = to_alloc + szof_bmp;
+
+                // Free space for the new text
+                if (!sCache.reserve(size))
+                    return false;
+
+                // Allocate the record
+                uint8_t *ptr            = static_cast<uint8_t *>(malloc(to_alloc));
+                if (ptr == NULL)
+                    return false;
+
+                text_t *t               = reinterpret_cast<text_t *>(ptr);
+                t->item.hnext           = NULL;
+                t->item.prev            = NULL;
+                t->item.next            = NULL;
+                t->item.hash            = hash;
+                t->item.size            = size;
+                t->face                 = face;
+                t->length               = uint32_t(length);
+                t->bitmap               = reference_bitmap(bitmap);
+                t->range                = *range;
+                t->text                 = reinterpret_cast<lsp_wchar_t *>(&ptr[szof_hdr]);
+
+                memcpy(t->text, text, szof_text);
+
+                // Link the record
+                if (!sCache.insert(&t->item))
+                {
+                    destroy(&t->item);
+                    return false;
+                }
+
+                return true;
+            }
+
+            void TextCache::remove_face(const face_t *face)
+            {
+                for (lru_item_t *item = sCache.first(); item != NULL; )
+                {
+                    lru_item_t *next    = item->next;
+                    if (reinterpret_cast<const text_t *>(item)->face == face)
+                        sCache.remove(item);
+                    item                = next;
+                }
+            }
+
+            void TextCache::clear()
+            {
+                sCache.clear();
+            }
+
+            size_t TextCache::set_max_size(size_t max_size)
+            {
+                return sCache.set_max_size(max_size);
+            }
+
+            void TextCache::clear_stats()
+            {
+                sCache.clear_stats();
+            }
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
@@ -20,6 +20,7 @@
  */
 
 #include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/atomic.h>
 #include <lsp-plug.in/common/types.h>
 #include <lsp-plug.in/stdlib/string.h>
 
@@ -41,6 +42,12 @@ namespace lsp
     {
         namespace ft
         {
+            typedef struct shared_bitmap_t
+            {
+                dsp::bitmap_t       bitmap;         // The bitmap, should be the first field
+                uatomic_t           references;     // Number of references
+            } shared_bitmap_t;
+
             LSP_HIDDEN_MODIFIER
             size_t compute_bitmap_stride(size_t width)
             {
@@ -55,18 +62,21 @@ namespace lsp
             dsp::bitmap_t *create_bitmap(size_t width, size_t height)
             {
                 size_t stride       = compute_bitmap_stride(width);
-                size_t szof_bitmap  = sizeof(dsp::bitmap_t) + DEFAULT_ALIGN;
+                size_t szof_bitmap  = sizeof(shared_bitmap_t) + DEFAULT_ALIGN;
                 size_t buf_size     = stride * height;
 
                 uint8_t *ptr        = static_cast<uint8_t *>(malloc(buf_size + szof_bitmap));
                 if (ptr == NULL)
                     return NULL;
 
-                dsp::bitmap_t *b    = reinterpret_cast<dsp::bitmap_t *>(ptr);
+                shared_bitmap_t *sb = reinterpret_cast<shared_bitmap_t *>(ptr);
+                sb->references      = 1;
+
+                dsp::bitmap_t *b    = &sb->bitmap;
                 b->width            = width;
                 b->height           = height;
                 b->stride           = stride;
-                b->data             = align_ptr(&ptr[sizeof(dsp::bitmap_t)], DEFAULT_ALIGN);
+                b->data             = align_ptr(&ptr[sizeof(shared_bitmap_t)], DEFAULT_ALIGN);
 
                 bzero(b->data, buf_size);
 
@@ -74,10 +84,25 @@ namespace lsp
             }
 
             LSP_HIDDEN_MODIFIER
-            void free_bitmap(dsp::bitmap_t *bitmap)
+            dsp::bitmap_t *reference_bitmap(dsp::bitmap_t *bitmap)
             {
                 if (bitmap != NULL)
-                    free(bitmap);
+                {
+                    shared_bitmap_t *sb = reinterpret_cast<shared_bitmap_t *>(bitmap);
+                    atomic_add(&sb->references, 1);
+                }
+                return bitmap;
+            }
+
+            LSP_HIDDEN_MODIFIER
+            void free_bitmap(dsp::bitmap_t *bitmap)
+            {
+                if (bitmap == NULL)
+                    return;
+
+                shared_bitmap_t *sb = reinterpret_cast<shared_bitmap_t *>(bitmap);
+                if (atomic_add(&sb->references, -1) == 1)
+                    free(sb);
             }
 
         } /* namespace ft */
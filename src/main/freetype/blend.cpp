@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/stdlib/math.h>
+
+#include <private/freetype/blend.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            static constexpr size_t UNPACK_CHUNK    = 0x100;    // Number of pixels unpacked at once
+
+            static inline uint32_t color_byte(float c)
+            {
+                return uint32_t(lsp_limit(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+
+            static inline uint32_t div_255(uint32_t v)
+            {
+                v          += 0x80;
+                return (v + (v >> 8)) >> 8;
+            }
+
+            /**
+             * Multiply all four channels of the pixel by k/255 with rounding. Two channels
+             * are processed by one multiplication, each channel has 16 bits of headroom.
+             */
+            static inline uint32_t scale_pixel(uint32_t p, uint32_t k)
+            {
+                uint32_t rb         = (p & 0x00ff00ff) * k + 0x00800080;
+                uint32_t ag         = ((p >> 8) & 0x00ff00ff) * k + 0x00800080;
+                rb                  = ((rb + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+                ag                  = (ag + ((ag >> 8) & 0x00ff00ff)) & 0xff00ff00;
+
+                return rb | ag;
+            }
+
+            static inline uint32_t blend_pixel(uint32_t d, uint32_t s)
+            {
+                // Premultiplied OVER operation, the sum can not overflow any channel
+                return s + scale_pixel(d, 0xff - (s >> 24));
+            }
+
+            static void unpack_b1(uint8_t *dst, const uint8_t *src, size_t sx, size_t count)
+            {
+                size_t i            = 0;
+
+                // Unaligned head
+                for ( ; (i < count) && (sx & 0x7); ++i, ++sx)
+                    dst[i]              = ((src[sx >> 3] >> (7 - (sx & 7))) & 0x1) * 0xff;
+
+                // Whole bytes
+                for (const uint8_t *s = &src[sx >> 3]; (i + 8) <= count; i += 8, sx += 8, ++s)
+                {
+                    const uint32_t v    = *s;
+                    dst[i]              = ((v >> 7) & 0x1) * 0xff;
+                    dst[i + 1]          = ((v >> 6) & 0x1) * 0xff;
+                    dst[i + 2]          = ((v >> 5) & 0x1) * 0xff;
+                    dst[i + 3]          = ((v >> 4) & 0x1) * 0xff;
+                    dst[i + 4]          = ((v >> 3) & 0x1) * 0xff;
+                    dst[i + 5]          = ((v >> 2) & 0x1) * 0xff;
+                    dst[i + 6]          = ((v >> 1) & 0x1) * 0xff;
+                    dst[i + 7]          = (v & 0x1) * 0xff;
+                }
+
+                // Tail
+                for ( ; i < count; ++i, ++sx)
+                    dst[i]              = ((src[sx >> 3] >> (7 - (sx & 7))) & 0x1) * 0xff;
+            }
+
+            static void unpack_b2(uint8_t *dst, const uint8_t *src, size_t sx, size_t count)
+            {
+                for (size_t i=0; i<count; ++i, ++sx)
+                    dst[i]              = ((src[sx >> 2] >> ((3 - (sx & 3)) << 1)) & 0x3) * 0x55;
+            }
+
+            static void unpack_b4(uint8_t *dst, const uint8_t *src, size_t sx, size_t count)
+            {
+                for (size_t i=0; i<count; ++i, ++sx)
+                    dst[i]              = ((src[sx >> 1] >> ((1 - (sx & 1)) << 2)) & 0xf) * 0x11;
+            }
+
+            uint32_t premultiply_color(float r, float g, float b, float a)
+            {
+                const uint32_t ka   = color_byte(a);
+
+                return
+                    (ka << 24) |
+                    (div_255(color_byte(r) * ka) << 16) |
+                    (div_255(color_byte(g) * ka) << 8) |
+                    div_255(color_byte(b) * ka);
+            }
+
+            void blend_a8_argb32(uint32_t *dst, const uint8_t *cov, uint32_t color, size_t count)
+            {
+                if ((color >> 24) == 0xff)
+                {
+                    // Opaque colour: fully covered pixels are just replaced
+                    for (size_t i=0; i<count; ++i)
+                    {
+                        const uint32_t k    = cov[i];
+                        if (k == 0xff)
+                            dst[i]              = color;
+                        else if (k != 0)
+                            dst[i]              = blend_pixel(dst[i], scale_pixel(color, k));
+                    }
+                }
+                else
+                {
+                    for (size_t i=0; i<count; ++i)
+                    {
+                        const uint32_t k    = cov[i];
+                        if (k != 0)
+                            dst[i]              = blend_pixel(dst[i], scale_pixel(color, k));
+                    }
+                }
+            }
+
+            bool blend_glyph(
+                uint8_t *data, size_t stride, const glyph_t *glyph, ssize_t x, ssize_t y,
+                ssize_t l, ssize_t t, ssize_t r, ssize_t b, uint32_t color)
+            {
+                const dsp::bitmap_t *bm = &glyph->bitmap;
+
+                // Clip the glyph
+                const ssize_t cl    = lsp_max(x, l);
+                const ssize_t ct    = lsp_max(y, t);
+                const ssize_t cr    = lsp_min(x + ssize_t(bm->width), r);
+                const ssize_t cb    = lsp_min(y + ssize_t(bm->height), b);
+                if ((cl >= cr) || (ct >= cb))
+                    return false;
+                if ((color >> 24) == 0)
+                    return true;
+
+                const size_t sx     = cl - x;
+                const size_t count  = cr - cl;
+
+                // 8-bit glyphs are blended directly, other formats are unpacked to 8 bits by chunks
+                uint8_t buf[UNPACK_CHUNK];
+                for (ssize_t row=ct; row<cb; ++row)
+                {
+                    uint32_t *dst       = reinterpret_cast<uint32_t *>(&data[row * stride]) + cl;
+                    const uint8_t *src  = &bm->data[(row - y) * bm->stride];
+
+                    if (glyph->format == FMT_8_BPP)
+                    {
+                        blend_a8_argb32(dst, &src[sx], color, count);
+                        continue;
+                    }
+
+                    for (size_t off=0; off < count; off += UNPACK_CHUNK)
+                    {
+                        const size_t n      = lsp_min(count - off, UNPACK_CHUNK);
+                        switch (glyph->format)
+                        {
+                            case FMT_1_BPP:
+                                unpack_b1(buf, src, sx + off, n);
+                                break;
+                            case FMT_2_BPP:
+                                unpack_b2(buf, src, sx + off, n);
+                                break;
+                            case FMT_4_BPP:
+                            default:
+                                unpack_b4(buf, src, sx + off, n);
+                                break;
+                        }
+                        blend_a8_argb32(&dst[off], buf, color, n);
+                    }
+                }
+
+                return true;
+            }
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBFREETYPE */
@@ -23,15 +23,21 @@
 
 #include <lsp-plug.in/common/alloc.h>
 #include <lsp-plug.in/common/debug.h>
-#include <lsp-plug.in/common/new.h>
 #include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/io/InFileStream.h>
 #include <lsp-plug.in/io/OutMemoryStream.h>
 #include <lsp-plug.in/stdlib/stdlib.h>
 
 #include <private/freetype/face.h>
-#include <private/freetype/glyph.h>
 #include <private/freetype/types.h>
 
+#ifdef PLATFORM_POSIX
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif /* PLATFORM_POSIX */
+
 namespace lsp
 {
     namespace ws
@@ -45,7 +51,14 @@ namespace lsp
 
                 lsp_trace("Dealocated font data %p, size=%d, content=%p", font, int(font->size), font->data);
 
+            #ifdef PLATFORM_POSIX
+                if (font->mapped)
+                    ::munmap(font->data, font->size);
+                else
+                    free(font->data);
+            #else
                 free(font->data);
+            #endif /* PLATFORM_POSIX */
 
                 font->size          = 0;
                 font->data          = NULL;
@@ -71,21 +84,54 @@ namespace lsp
                 font->references    = 1;
                 font->size          = os.size();
                 font->data          = os.release();
+                font->mapped        = false;
+                font->mtime         = 0;
+                font->hash          = 0;
 
                 lsp_trace("Allocated font data %p, size=%d, content=%p", font, int(font->size), font->data);
 
                 return font;
             }
 
-            LSP_HIDDEN_MODIFIER
-            status_t load_face(lltl::parray<face_t> *faces, library_t & ft, io::IInStream *is)
+        #ifdef PLATFORM_POSIX
+            static font_t *map_font_data(const char *path)
             {
-                // Create the font data
-                font_t *data        = create_font_data(is);
-                if (data == NULL)
-                    return STATUS_NO_MEM;
-                lsp_finally { release_font_data(data); };
+                int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+                if (fd < 0)
+                    return NULL;
+                lsp_finally { ::close(fd); };
+
+                struct stat st;
+                if ((::fstat(fd, &st) != 0) || (!S_ISREG(st.st_mode)) || (st.st_size <= 0))
+                    return NULL;
 
+                // Map the file read-only, the mapping remains valid after closing the descriptor
+                void *addr = ::mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                if (addr == MAP_FAILED)
+                    return NULL;
+
+                font_t *font = static_cast<font_t *>(malloc(sizeof(font_t)));
+                if (font == NULL)
+                {
+                    ::munmap(addr, st.st_size);
+                    return NULL;
+                }
+
+                font->references    = 1;
+                font->size          = st.st_size;
+                font->data          = static_cast<uint8_t *>(addr);
+                font->mapped        = true;
+                font->mtime         = int64_t(st.st_mtime);
+                font->hash          = 0;
+
+                lsp_trace("Mapped font data %p, size=%d, content=%p, path=%s", font, int(font->size), font->data, path);
+
+                return font;
+            }
+        #endif /* PLATFORM_POSIX */
+
+            static status_t load_font_faces(lltl::parray<face_t> *faces, library_t & ft, font_t *data)
+            {
                 // Estimate the number of faces
                 FT_Open_Args args;
                 FT_Face ft_face;
@@ -139,6 +185,7 @@ namespace lsp
                     face->references    = 0;
                     face->cache_size    = 0;
                     face->ft_face       = ft_face;
+                    face->ft_size       = NULL;
                     face->font          = data;
                     face->flags         = (ft_face->style_flags & FT_STYLE_FLAG_BOLD) ? FID_BOLD : 0;
                     if (ft_face->style_flags & FT_STYLE_FLAG_ITALIC)
@@ -150,8 +197,6 @@ namespace lsp
                     face->ascent        = 0;
                     face->descent       = 0;
 
-                    new (reinterpret_cast<void *>(&face->cache), inplace_new_tag_t()) GlyphCache();
-
                     // Cleanup the pointer to avoid face destruction
                     ++face->font->references;
                     ft_face             = NULL;
@@ -168,6 +213,40 @@ namespace lsp
                 return STATUS_OK;
             }
 
+            LSP_HIDDEN_MODIFIER
+            status_t load_face(lltl::parray<face_t> *faces, library_t & ft, io::IInStream *is)
+            {
+                // Create the font data
+                font_t *data        = create_font_data(is);
+                if (data == NULL)
+                    return STATUS_NO_MEM;
+                lsp_finally { release_font_data(data); };
+
+                return load_font_faces(faces, ft, data);
+            }
+
+            LSP_HIDDEN_MODIFIER
+            status_t load_face(lltl::parray<face_t> *faces, library_t & ft, const io::Path *path)
+            {
+            #ifdef PLATFORM_POSIX
+                // Try to map the font file into memory
+                font_t *data        = map_font_data(path->as_native());
+                if (data != NULL)
+                {
+                    lsp_finally { release_font_data(data); };
+                    return load_font_faces(faces, ft, data);
+                }
+            #endif /* PLATFORM_POSIX */
+
+                // Read the font file into memory
+                io::InFileStream ifs;
+                status_t res    = ifs.open(path);
+                if (res == STATUS_OK)
+                    res         = load_face(faces, ft, &ifs);
+                status_t res2   = ifs.close();
+                return (res == STATUS_OK) ? res2 : res;
+            }
+
             LSP_HIDDEN_MODIFIER
             face_t *clone_face(library_t & ft, face_t *src)
             {
@@ -192,6 +271,7 @@ namespace lsp
                 face->references    = 0;
                 face->cache_size    = 0;
                 face->ft_face       = src->ft_face;
+                face->ft_size       = NULL;
                 face->font          = src->font;
                 face->flags         = src->flags;
 
@@ -201,8 +281,6 @@ namespace lsp
                 face->ascent        = 0;
                 face->descent       = 0;
 
-                new (reinterpret_cast<void *>(&face->cache), inplace_new_tag_t()) GlyphCache();
-
                 // Cleanup the pointer to avoid face destruction
                 ++face->font->references;
                 src                 = NULL;
@@ -224,7 +302,12 @@ namespace lsp
                 if (face == NULL)
                     return;
 
-                // Remove freetype face reference
+                // Remove freetype size object and face reference
+                if (face->ft_size != NULL)
+                {
+                    ft.done_size(face->ft_size);
+                    face->ft_size   = NULL;
+                }
                 if (face->ft_face != NULL)
                 {
                     ft.done_face(face->ft_face);
@@ -238,16 +321,6 @@ namespace lsp
                     face->font      = NULL;
                 }
 
-                // Drop all glyphs in the cache
-                glyph_t *glyph  = face->cache.clear();
-                while (glyph != NULL)
-                {
-                    glyph_t *next   = glyph->cache_next;
-                    free_glyph(glyph);
-                    glyph           = next;
-                }
-                face->cache.~GlyphCache();
-
                 // Free memory allocated by the face
                 free(face);
             }
@@ -258,17 +331,34 @@ namespace lsp
                 FT_Error error;
                 FT_Face ft_face     = face->ft_face;
 
-                // Select the font size
-                if ((error = FT_Set_Char_Size(ft_face, face->h_size, face->v_size, 0, 0)) != FT_Err_Ok)
-                    return STATUS_UNKNOWN_ERR;
+                if (face->ft_size == NULL)
+                {
+                    // Allocate the size object and scale the face only once
+                    FT_Size size        = NULL;
+                    if ((error = ft.new_size(ft_face, &size)) != FT_Err_Ok)
+                        return STATUS_UNKNOWN_ERR;
+                    if (((error = ft.activate_size(size)) != FT_Err_Ok) ||
+                        ((error = ft.set_char_size(ft_face, face->h_size, face->v_size, 0, 0)) != FT_Err_Ok))
+                    {
+                        ft.done_size(size);
+                        return STATUS_UNKNOWN_ERR;
+                    }
+                    face->ft_size       = size;
+                }
+                else if (ft_face->size != face->ft_size)
+                {
+                    // Switch the shared face to the size of this face
+                    if ((error = ft.activate_size(face->ft_size)) != FT_Err_Ok)
+                        return STATUS_UNKNOWN_ERR;
+                }
 
                 // Set transformation matrix
                 ft.set_transform(ft_face, &face->matrix, NULL);
 
                 // Update the font metrics for the face
-                face->height        = ft_face->size->metrics.height;
-                face->ascent        = ft_face->size->metrics.ascender;
-                face->descent       = ft_face->size->metrics.descender;
+                face->height        = face->ft_size->metrics.height;
+                face->ascent        = face->ft_size->metrics.ascender;
+                face->descent       = face->ft_size->metrics.descender;
 
                 return STATUS_OK;
             }
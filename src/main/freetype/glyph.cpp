@@ -28,6 +28,7 @@
 
 #include <private/freetype/bitmap.h>
 #include <private/freetype/glyph.h>
+#include <private/freetype/GlyphAllocator.h>
 #include <private/freetype/face.h>
 
 namespace lsp
@@ -36,7 +37,7 @@ namespace lsp
     {
         namespace ft
         {
-            static glyph_t *make_glyph_data(face_t *face, FT_GlyphSlot glyph, lsp_wchar_t ch)
+            static glyph_t *make_glyph_data(face_t *face, FT_GlyphSlot glyph, lsp_wchar_t ch, GlyphAllocator *alloc)
             {
                 // Obtain bitmap and pixel format
                 FT_Bitmap *bitmap   = &glyph->bitmap;
@@ -65,17 +66,24 @@ namespace lsp
                 size_t bytes        = bitmap->rows * stride;
                 size_t to_alloc     = szof_glyph + bytes;
 
-                uint8_t *buf        = static_cast<uint8_t *>(malloc(to_alloc));
-                if (buf == NULL)
-                    return NULL;
-                glyph_t *res        = reinterpret_cast<glyph_t *>(buf);
+                glyph_t *res        = NULL;
+                if (alloc != NULL)
+                {
+                    if ((res = alloc->allocate(to_alloc)) == NULL)
+                        return NULL;
+                }
+                else
+                {
+                    if ((res = static_cast<glyph_t *>(malloc(to_alloc))) == NULL)
+                        return NULL;
+                    res->slab           = NULL;
+                    res->szof           = to_alloc;
+                }
+                uint8_t *buf        = reinterpret_cast<uint8_t *>(res);
 
-                res->lru_prev       = NULL;
-                res->lru_next       = NULL;
                 res->cache_next     = NULL;
                 res->face           = face;
                 res->codepoint      = ch;
-                res->szof           = to_alloc;
                 res->width          = glyph->metrics.width;
                 res->height         = glyph->metrics.height;
                 res->x_advance      = glyph->advance.x;
@@ -111,7 +119,7 @@ namespace lsp
             }
 
             LSP_HIDDEN_MODIFIER
-            glyph_t *render_regular_glyph(library_t & ft, face_t *face, FT_UInt glyph_index, lsp_wchar_t ch)
+            glyph_t *render_regular_glyph(library_t & ft, face_t *face, FT_UInt glyph_index, lsp_wchar_t ch, GlyphAllocator *alloc)
             {
                 // Load glyph
                 size_t load_flags   = (face->flags & FID_ANTIALIAS) ? FT_LOAD_DEFAULT : FT_LOAD_MONOCHROME;
@@ -124,11 +132,11 @@ namespace lsp
                 if (ft.render_glyph(glyph, render_mode) != FT_Err_Ok)
                     return NULL;
 
-                return make_glyph_data(face, glyph, ch);
+                return make_glyph_data(face, glyph, ch, alloc);
             }
 
             LSP_HIDDEN_MODIFIER
-            glyph_t *render_bold_glyph(library_t & ft, face_t *face, FT_UInt glyph_index, lsp_wchar_t ch)
+            glyph_t *render_bold_glyph(library_t & ft, face_t *face, FT_UInt glyph_index, lsp_wchar_t ch, GlyphAllocator *alloc)
             {
                 // Load glyph
                 size_t load_flags   = (face->flags & FID_ANTIALIAS) ? FT_LOAD_DEFAULT : FT_LOAD_MONOCHROME;
@@ -153,20 +161,20 @@ namespace lsp
                         return NULL;
                 }
 
-                return make_glyph_data(face, glyph, ch);
+                return make_glyph_data(face, glyph, ch, alloc);
             }
 
             LSP_HIDDEN_MODIFIER
-            glyph_t *render_glyph(library_t & ft, face_t *face, lsp_wchar_t ch)
+            glyph_t *render_glyph(library_t & ft, face_t *face, lsp_wchar_t ch, GlyphAllocator *alloc)
             {
                 // Obtain the glyph index
                 const FT_UInt glyph_index = ft.get_char_index(face->ft_face, ch);
 
                 // Render the glyph
                 if ((face->flags & FID_BOLD) && (!(face->ft_face->style_flags & FT_STYLE_FLAG_BOLD)))
-                    return render_bold_glyph(ft, face, glyph_index, ch);
+                    return render_bold_glyph(ft, face, glyph_index, ch, alloc);
 
-                return render_regular_glyph(ft, face, glyph_index, ch);
+                return render_regular_glyph(ft, face, glyph_index, ch, alloc);
             }
 
             LSP_HIDDEN_MODIFIER
@@ -175,7 +183,7 @@ namespace lsp
                 if (glyph == NULL)
                     return;
 
-                free(glyph);
+                GlyphAllocator::release(glyph);
             }
         } /* namespace ft */
     } /* namespace ws */
@@ -73,6 +73,10 @@ namespace lsp
                     pDone_Face          = func(FT_Done_Face); \
                     pReference_Face     = func(FT_Reference_Face); \
                     pSet_Transform      = func(FT_Set_Transform); \
+                    pSet_Char_Size      = func(FT_Set_Char_Size); \
+                    pNew_Size           = func(FT_New_Size); \
+                    pDone_Size          = func(FT_Done_Size); \
+                    pActivate_Size      = func(FT_Activate_Size); \
                     pLoad_Glyph         = func(FT_Load_Glyph); \
                     pBitmap_Embolden    = func(FT_Bitmap_Embolden); \
                     pOutline_Embolden   = func(FT_Outline_Embolden); \
@@ -217,6 +221,26 @@ namespace lsp
                 return pSet_Transform(face, matrix, delta);
             }
 
+            FT_Error library_t::set_char_size(FT_Face face, FT_F26Dot6 width, FT_F26Dot6 height, FT_UInt h_res, FT_UInt v_res)
+            {
+                return pSet_Char_Size(face, width, height, h_res, v_res);
+            }
+
+            FT_Error library_t::new_size(FT_Face face, FT_Size *size)
+            {
+                return pNew_Size(face, size);
+            }
+
+            FT_Error library_t::done_size(FT_Size size)
+            {
+                return (size != NULL) ? pDone_Size(size) : FT_Err_Ok;
+            }
+
+            FT_Error library_t::activate_size(FT_Size size)
+            {
+                return pActivate_Size(size);
+            }
+
             FT_Error library_t::load_glyph(FT_Face face, FT_UInt glyph_index, FT_Int32 load_flags)
             {
                 return pLoad_Glyph(face, glyph_index, load_flags);
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/types.h>
+
+#include <private/freetype/tmpfile.h>
+
+#ifdef PLATFORM_WINDOWS
+    #include <process.h>
+#else
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif /* PLATFORM_WINDOWS */
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace ft
+        {
+            static uatomic_t temp_file_counter  = 0;
+
+            FILE *create_temp_file(LSPString *name, const io::Path *path)
+            {
+            #ifdef PLATFORM_WINDOWS
+                const unsigned long pid = (unsigned long)(_getpid());
+            #else
+                const unsigned long pid = (unsigned long)(getpid());
+            #endif /* PLATFORM_WINDOWS */
+
+                for (size_t attempt=0; attempt < 16; ++attempt)
+                {
+                    char suffix[64];
+                    const unsigned long id  = (unsigned long)(atomic_add(&temp_file_counter, 1));
+                    snprintf(suffix, sizeof(suffix), ".%lu.%lu.tmp", pid, id);
+                    if (!name->set_native(path->as_native()))
+                        return NULL;
+                    if (!name->append_ascii(suffix))
+                        return NULL;
+
+                #ifdef PLATFORM_WINDOWS
+                    return fopen(name->get_native(), "wb");
+                #else
+                    // Do not re-use the file left by the crashed process with the same PID
+                    int h = ::open(name->get_native(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+                    if (h >= 0)
+                    {
+                        FILE *fd = fdopen(h, "wb");
+                        if (fd != NULL)
+                            return fd;
+                        ::close(h);
+                        remove(name->get_native());
+                        return NULL;
+                    }
+                    if (errno != EEXIST)
+                        return NULL;
+                #endif /* PLATFORM_WINDOWS */
+                }
+
+                return NULL;
+            }
+
+        } /* namespace ft */
+    } /* namespace ws */
+} /* namespace lsp */
@@ -899,6 +899,17 @@ namespace lsp
                 buf.count              -= lsp_min(count, buf.count);
             };
 
+            const void *Batch::index_at(uint32_t position) const
+            {
+                const batch_ibuffer_t & buf   = pCurrent->indices;
+                if (buf.szof > sizeof(uint16_t))
+                    return &buf.u32[position];
+                else if (buf.szof > sizeof(uint8_t))
+                    return &buf.u16[position];
+
+                return &buf.u8[position];
+            }
+
             index_format_t Batch::index_format() const
             {
                 const batch_ibuffer_t & buf   = pCurrent->indices;
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/gl/GeometryCache.h>
+
+#ifdef LSP_PLUGINS_USE_OPENGL
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/gl/Stats.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace gl
+        {
+            GeometryCache::GeometryCache(size_t max_size):
+                sCache(BINS, max_size, destroy)
+            {
+                for (size_t i=0; i<RECENT; ++i)
+                    vRecent[i]          = 0;
+
+                nRecent                 = 0;
+            }
+
+            GeometryCache::~GeometryCache()
+            {
+                clear();
+            }
+
+            uint32_t GeometryCache::hash(const float *coords, size_t count, float width)
+            {
+                // FNV-1a over 32-bit words
+                const uint32_t *p   = reinterpret_cast<const uint32_t *>(coords);
+                const size_t n      = count * 2;
+                uint32_t h          = 0x811c9dc5;
+
+                for (size_t i=0; i<n; ++i)
+                    h                   = (h ^ p[i]) * 0x01000193;
+
+                uint32_t w;
+                memcpy(&w, &width, sizeof(w));
+                h                   = (h ^ w) * 0x01000193;
+                h                   = (h ^ uint32_t(count)) * 0x01000193;
+
+                return h;
+            }
+
+            bool GeometryCache::match(const lru_item_t *item, const void *key)
+            {
+                const geometry_t *g = reinterpret_cast<const geometry_t *>(item);
+                const key_t *k      = static_cast<const key_t *>(key);
+
+                return (g->count == k->count) &&
+                    (g->width == k->width) &&
+                    (memcmp(g->coords, k->coords, k->count * 2 * sizeof(float)) == 0);
+            }
+
+            void GeometryCache::destroy(lru_item_t *item)
+            {
+                free(item);
+            }
+
+            const GeometryCache::geometry_t *GeometryCache::get(uint32_t hash, const float *coords, size_t count, float width)
+            {
+                key_t key;
+                key.coords              = coords;
+                key.count               = count;
+                key.width               = width;
+
+                const geometry_t *g     = reinterpret_cast<const geometry_t *>(sCache.get(hash, match, &key));
+                if (g == NULL)
+                {
+                    OPENGL_INC_STATS(geometry_miss);
+                    return NULL;
+                }
+
+                OPENGL_INC_STATS(geometry_hit);
+                return g;
+            }
+
+            bool GeometryCache::admit(uint32_t hash)
+            {
+                for (size_t i=0; i<RECENT; ++i)
+                {
+                    if (vRecent[i] == hash)
+                    {
+                        vRecent[i]          = 0;
+                        return true;
+                    }
+                }
+
+                vRecent[nRecent]    = hash;
+                nRecent             = (nRecent + 1) % RECENT;
+                return false;
+            }
+
+            bool GeometryCache::put(
+                uint32_t hash, const float *coords, size_t count, float width, const clip_rect_t & rect,
+                const vertex_t *v, size_t nv,
+                const void *indices, index_format_t format, uint32_t vi, size_t ni)
+            {
+                // Estimate the size of geometry
+                const size_t szof_hdr   = align_size(sizeof(geometry_t), DEFAULT_ALIGN);
+                const size_t szof_crd   = align_size(count * 2 * sizeof(float), DEFAULT_ALIGN);
+                const size_t szof_vtx   = align_size(nv * sizeof(vertex_t), DEFAULT_ALIGN);
+                const size_t szof_idx   = ni * sizeof(uint32_t);
+                const size_t to_alloc   = szof_hdr + szof_crd + szof_vtx + szof_idx;
+
+                // Free space for the new geometry
+                if (!sCache.reserve(to_alloc))
+                    return false;
+
+                // Allocate geometry
+                uint8_t *ptr            = static_cast<uint8_t *>(malloc(to_alloc));
+                if (ptr == NULL)
+                    return false;
+
+                geometry_t *g           = reinterpret_cast<geometry_t *>(ptr);
+                g->item.hnext           = NULL;
+                g->item.prev            = NULL;
+                g->item.next            = NULL;
+                g->item.hash            = hash;
+                g->item.size            = to_alloc;
+                g->count                = uint32_t(count);
+                g->width                = width;
+                g->nvertices            = uint32_t(nv);
+                g->nindices             = uint32_t(ni);
+                g->rect                 = rect;
+                g->coords               = reinterpret_cast<float *>(&ptr[szof_hdr]);
+                g->vertices             = reinterpret_cast<vertex_t *>(&ptr[szof_hdr + szof_crd]);
+                g->indices              = reinterpret_cast<uint32_t *>(&ptr[szof_hdr + szof_crd + szof_vtx]);
+
+                // Copy data
+                memcpy(g->coords, coords, count * 2 * sizeof(float));
+                memcpy(g->vertices, v, nv * sizeof(vertex_t));
+
+                switch (format)
+                {
+                    case INDEX_FMT_U8:
+                    {
+                        const uint8_t *src = static_cast<const uint8_t *>(indices);
+                        for (size_t i=0; i<ni; ++i)
+                            g->indices[i]       = uint32_t(src[i]) - vi;
+                        break;
+                    }
+                    case INDEX_FMT_U16:
+                    {
+                        const uint16_t *src = static_cast<const uint16_t *>(indices);
+                        for (size_t i=0; i<ni; ++i)
+                            g->indices[i]       = uint32_t(src[i]) - vi;
+                        break;
+                    }
+                    case INDEX_FMT_U32:
+                    default:
+                    {
+                        const uint32_t *src = static_cast<const uint32_t *>(indices);
+                        for (size_t i=0; i<ni; ++i)
+                            g->indices[i]       = src[i] - vi;
+                        break;
+                    }
+                }
+
+                // Link geometry
+                if (!sCache.insert(&g->item))
+                {
+                    free(g);
+                    return false;
+                }
+
+                return true;
+            }
+
+            void GeometryCache::clear()
+            {
+                sCache.clear();
+            }
+
+        } /* namespace gl */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* LSP_PLUGINS_USE_OPENGL */
@@ -26,7 +26,9 @@
 #include <private/gl/IContext.h>
 #include <private/glx/Context.h>
 
+#include <lsp-plug.in/common/alloc.h>
 #include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/stdlib/string.h>
 
 namespace lsp
 {
@@ -75,6 +77,14 @@ namespace lsp
                 nCommandsId         = 0;
                 nCommandsSize       = 0;
                 nCommandsProcessor  = GL_NONE;
+
+                for (size_t i=0; i<UNPACK_BUFFERS; ++i)
+                {
+                    vUnpackIds[i]       = GL_NONE;
+                    vUnpackSizes[i]     = 0;
+                }
+                nUnpackIndex        = 0;
+                bUnpackBound        = false;
             }
 
             IContext::~IContext()
@@ -188,6 +198,17 @@ namespace lsp
 
             void IContext::destroy()
             {
+                // Free all pixel unpack buffers
+                end_unpack();
+                for (size_t i=0; i<UNPACK_BUFFERS; ++i)
+                {
+                    if (vUnpackIds[i] == GL_NONE)
+                        continue;
+                    pVtbl->glDeleteBuffers(1, &vUnpackIds[i]);
+                    vUnpackIds[i]       = GL_NONE;
+                    vUnpackSizes[i]     = 0;
+                }
+
                 // Free all framebuffers
                 vGcFramebuffers.flush();
                 if (vFramebuffers.size() > 0)
@@ -476,6 +497,66 @@ namespace lsp
                 pVtbl->glBindTexture(tex_kind, GL_NONE);
             }
 
+            const void *IContext::begin_unpack(const void *buf, size_t size)
+            {
+                // Use client memory for small images or if buffer mapping is not supported
+                if ((buf == NULL) || (size < UNPACK_THRESHOLD))
+                    return buf;
+                if ((pVtbl->glMapBufferRange == NULL) || (pVtbl->glUnmapBuffer == NULL))
+                    return buf;
+
+                // Obtain next buffer from the ring
+                const size_t index  = nUnpackIndex;
+                GLuint buffer_id    = vUnpackIds[index];
+                if (buffer_id == GL_NONE)
+                {
+                    pVtbl->glGenBuffers(1, &buffer_id);
+                    if (buffer_id == GL_NONE)
+                        return buf;
+                    vUnpackIds[index]   = buffer_id;
+                    vUnpackSizes[index] = 0;
+                }
+
+                // Grow buffer if needed
+                pVtbl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer_id);
+                if (vUnpackSizes[index] < size)
+                {
+                    const size_t capacity   = align_size(size, UNPACK_THRESHOLD);
+                    pVtbl->glBufferData(GL_PIXEL_UNPACK_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+                    vUnpackSizes[index]     = capacity;
+                }
+
+                // Copy data to the buffer, invalidation allows driver to avoid waiting for previous transfer
+                void *dst = pVtbl->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+                if (dst == NULL)
+                {
+                    pVtbl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_NONE);
+                    return buf;
+                }
+                memcpy(dst, buf, size);
+                if (!pVtbl->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER))
+                {
+                    pVtbl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_NONE);
+                    return buf;
+                }
+
+                // Move to the next buffer in the ring
+                nUnpackIndex        = (index + 1) % UNPACK_BUFFERS;
+                bUnpackBound        = true;
+
+                // Pixel data is now addressed as an offset in the bound buffer
+                return NULL;
+            }
+
+            void IContext::end_unpack()
+            {
+                if (!bUnpackBound)
+                    return;
+
+                pVtbl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_NONE);
+                bUnpackBound        = false;
+            }
+
         } /* namespace gl */
     } /* namespace ws */
 } /* namespace lsp */
@@ -28,6 +28,8 @@
 #include <lsp-plug.in/stdlib/math.h>
 #include <lsp-plug.in/ws/ISurface.h>
 
+#include <private/gl/extrude.h>
+#include <private/gl/Stats.h>
 #include <private/gl/Texture.h>
 
 namespace lsp
@@ -73,6 +75,8 @@ namespace lsp
             // ----------------------------------------------------------------------------
             Renderer::Renderer(gl::IContext * gl_context):
                 pGLContext(safe_acquire(gl_context)),
+                pActive(NULL),
+                nStreak(0),
                 sThread(execute, this),
                 sTextAllocator(pGLContext),
                 sBatch(&sAllocator)
@@ -150,7 +154,7 @@ namespace lsp
                 return self->run();
             }
 
-            SurfaceContext *Renderer::poll()
+            SurfaceContext *Renderer::poll(bool wait)
             {
                 sLock.lock();
                 lsp_finally { sLock.unlock(); };
@@ -161,7 +165,31 @@ namespace lsp
                     if (sThread.cancelled())
                         return NULL;
 
-                    SurfaceContext * surface = sQueue.shift(); // Already acquired by queue
+                    // Prefer surfaces that target the drawable the context is already bound to.
+                    // This keeps the relative order of surfaces for each drawable but avoids
+                    // switching the context back and forth between windows. To not starve other
+                    // windows, at most MAX_STREAK surfaces can be taken ahead of the oldest one.
+                    SurfaceContext * surface = NULL;
+                    if ((pActive != NULL) && (nStreak < MAX_STREAK))
+                    {
+                        for (size_t i=0, n=sQueue.size(); i<n; ++i)
+                        {
+                            SurfaceContext * const s = sQueue.uget(i);
+                            if (s->drawable() == pActive)
+                            {
+                                surface = s; // Already acquired by queue
+                                sQueue.remove(i);
+                                nStreak = (i > 0) ? nStreak + 1 : 0;
+                                break;
+                            }
+                        }
+                    }
+                    if (surface == NULL)
+                    {
+                        surface = sQueue.shift(); // Already acquired by queue
+                        nStreak = 0;
+                    }
+
                     if (surface != NULL)
                     {
                         sViewport.nLeft     = 0;
@@ -172,6 +200,9 @@ namespace lsp
                         return surface;
                     }
 
+                    if (!wait)
+                        return NULL;
+
                     sLock.wait();
                 }
             }
@@ -257,8 +288,33 @@ namespace lsp
                 if (!surface->valid())
                     return STATUS_SKIP;
 
-                // Activate OpenGL context
-                return pGLContext->activate(surface->drawable());
+                // Do not re-activate context if the target drawable has not changed
+                ws::IDrawable * const drawable = surface->drawable();
+                if (drawable == pActive)
+                {
+                    OPENGL_INC_STATS(context_reuse);
+                    return STATUS_OK;
+                }
+
+                // Deactivate context for previous drawable and activate for the new one
+                release_context();
+                status_t res = pGLContext->activate(drawable);
+                if (res != STATUS_OK)
+                    return res;
+
+                OPENGL_INC_STATS(context_switch);
+                pActive         = safe_acquire(drawable);
+
+                return STATUS_OK;
+            }
+
+            void Renderer::release_context()
+            {
+                if (pActive == NULL)
+                    return;
+
+                pGLContext->deactivate();
+                safe_release(pActive);
             }
 
             status_t Renderer::run()
@@ -267,8 +323,18 @@ namespace lsp
                 status_t res;
 
                 // Do a loop while there are jobs to do
-                while ((surface = poll()) != NULL)
+                while (true)
                 {
+                    // Try to fetch the next surface without blocking. If the queue is empty,
+                    // deactivate the context before going to sleep.
+                    if ((surface = poll(false)) == NULL)
+                    {
+                        release_context();
+                        OPENGL_OUTPUT_STATS(false);
+                        if ((surface = poll(true)) == NULL)
+                            break;
+                    }
+
                     // Remove context from the queue and release it on the end of loop
                     lsp_finally
                     {
@@ -287,7 +353,6 @@ namespace lsp
                     // Notify context about start of the rendering
                     lsp_finally {
                         sBatch.clear();
-                        pGLContext->deactivate();
                         sAllocator.perform_gc();
                         sTextAllocator.clear();
                     };
@@ -310,6 +375,9 @@ namespace lsp
                         lsp_trace("Render failed with error code=%d", int(res));
                 }
 
+                // Release the context
+                release_context();
+
                 // Flush queue
                 {
                     sLock.lock();
@@ -1084,7 +1152,7 @@ namespace lsp
                                 return status_t(-res);
                             lsp_finally{ sBatch.end(); };
 
-                            wire_polyline(size_t(res), x, y, action.width, action.count);
+                            wire_cached_polyline(size_t(res), NULL, action.data, action.width, action.count);
                         }
                         else
                         {
@@ -1101,7 +1169,7 @@ namespace lsp
                                     return status_t(-res);
                                 lsp_finally{ sBatch.end(); };
 
-                                wire_polyline(size_t(res), rect, x, y, action.width, action.count);
+                                wire_cached_polyline(size_t(res), &rect, action.data, action.width, action.count);
                                 limit_rect(rect, surface);
                             }
 
@@ -1686,168 +1754,17 @@ namespace lsp
             template <class T>
             inline void Renderer::wire_polyline(vertex_t * & vertices, T * & indices, T vi, uint32_t ci, const float *x, const float *y, float width, size_t n)
             {
-                vertex_t *v     = vertices;
-                T *iv           = indices;
-                lsp_finally
-                {
-                    vertices        = v;
-                    indices         = iv;
-                };
-
-                size_t i;
-                float dx, dy, d;
-                float kd, ndx, ndy;
-
-                // Find first not short segment
-                width          *= 0.5f;
-                size_t si       = 0;
-                for (i = 1; i < n; ++i)
-                {
-                    dx              = x[i] - x[si];
-                    dy              = y[i] - y[si];
-                    d               = dx*dx + dy*dy;
-                    if (d > 1e-10f)
-                        break;
-                }
-                if (i >= n)
-                    return;
-
-                // Draw first segment
-                kd              = width / sqrtf(d);
-                ndx             = -dy * kd;
-                ndy             = dx * kd;
-
-                ADD_VERTEX(v, ci, x[i] + ndx, y[i] + ndy);
-                ADD_VERTEX(v, ci, x[i] - ndx, y[i] - ndy);
-                ADD_VERTEX(v, ci, x[si] - ndx, y[si] - ndy);
-                ADD_VERTEX(v, ci, x[si] + ndx, y[si] + ndy);
-
-                ADD_HRECTANGLE(iv, vi, vi + 1, vi + 2, vi + 3);
-                si                  = i++;
-
-                // Draw the rest segments
-                for (; i < n; ++i)
-                {
-                    dx              = x[i] - x[si];
-                    dy              = y[i] - y[si];
-                    d               = dx*dx + dy*dy;
-                    if (d > 1e-10f)
-                    {
-                        kd              = width / sqrtf(d);
-                        ndx             = -dy * kd;
-                        ndy             = dx * kd;
-
-                        ADD_VERTEX(v, ci, x[i] + ndx, y[i] + ndy);
-                        ADD_VERTEX(v, ci, x[i] - ndx, y[i] - ndy);
-                        ADD_VERTEX(v, ci, x[si] - ndx, y[si] - ndy);
-                        ADD_VERTEX(v, ci, x[si] + ndx, y[si] + ndy);
-
-                        ADD_HRECTANGLE(iv, vi + 4, vi + 5, vi + 6, vi + 7);
-                        ADD_HRECTANGLE(iv, vi, vi + 6, vi + 1, vi + 7);
-
-                        si              = i;
-                        vi             += 4;
-                    }
-                }
+                extrude_polyline<T>(vertices, indices, vi, ci, x, y, width, n);
             }
 
             template <class T>
             inline void Renderer::wire_polyline(vertex_t * & vertices, T * & indices, T vi, uint32_t ci, clip_rect_t &rect, const float *x, const float *y, float width, size_t n)
             {
-                vertex_t *v     = vertices;
-                T *iv           = indices;
-                lsp_finally
-                {
-                    vertices        = v;
-                    indices         = iv;
-                };
-
-                size_t i;
-                float dx, dy, d;
-                float kd, ndx, ndy;
-                float px, py;
-
-                // Find first not short segment
-                width          *= 0.5f;
-                size_t si       = 0;
-                for (i = 1; i < n; ++i)
-                {
-                    dx              = x[i] - x[si];
-                    dy              = y[i] - y[si];
-                    d               = dx*dx + dy*dy;
-                    if (d > 1e-10f)
-                        break;
-                }
-                if (i >= n)
-                    return;
+                const vertex_t *v = vertices;
+                wire_polyline<T>(vertices, indices, vi, ci, x, y, width, n);
 
-                // Draw first segment
-                kd              = width / sqrtf(d);
-                ndx             = -dy * kd;
-                ndy             = dx * kd;
-
-                px              = x[i] + ndx;
-                py              = y[i] + ndy;
-                extend_rect(rect, px, py);
-                ADD_VERTEX(v, ci, px, py);
-
-                px              = x[i] - ndx;
-                py              = y[i] - ndy;
-                extend_rect(rect, px, py);
-                ADD_VERTEX(v, ci, px, py);
-
-                px              = x[si] - ndx;
-                py              = y[si] - ndy;
-                extend_rect(rect, px, py);
-                ADD_VERTEX(v, ci, px, py);
-
-                px              = x[si] + ndx;
-                py              = y[si] + ndy;
-                extend_rect(rect, px, py);
-                ADD_VERTEX(v, ci, px, py);
-
-                ADD_HRECTANGLE(iv, vi, vi + 1, vi + 2, vi + 3);
-                si                  = i++;
-
-                // Draw the rest segments
-                for (; i < n; ++i)
-                {
-                    dx              = x[i] - x[si];
-                    dy              = y[i] - y[si];
-                    d               = dx*dx + dy*dy;
-                    if (d > 1e-10f)
-                    {
-                        kd              = width / sqrtf(d);
-                        ndx             = -dy * kd;
-                        ndy             = dx * kd;
-
-                        px              = x[i] + ndx;
-                        py              = y[i] + ndy;
-                        extend_rect(rect, px, py);
-                        ADD_VERTEX(v, ci, px, py);
-
-                        px              = x[i] - ndx;
-                        py              = y[i] - ndy;
-                        extend_rect(rect, px, py);
-                        ADD_VERTEX(v, ci, px, py);
-
-                        px              = x[si] - ndx;
-                        py              = y[si] - ndy;
-                        extend_rect(rect, px, py);
-                        ADD_VERTEX(v, ci, px, py);
-
-                        px              = x[si] + ndx;
-                        py              = y[si] + ndy;
-                        extend_rect(rect, px, py);
-                        ADD_VERTEX(v, ci, px, py);
-
-                        ADD_HRECTANGLE(iv, vi + 4, vi + 5, vi + 6, vi + 7);
-                        ADD_HRECTANGLE(iv, vi, vi + 6, vi + 1, vi + 7);
-
-                        si              = i;
-                        vi             += 4;
-                    }
-                }
+                for ( ; v < vertices; ++v)
+                    extend_rect(rect, v->x, v->y);
             }
 
             void Renderer::wire_polyline(uint32_t ci, clip_rect_t & rect, const float *x, const float *y, float width, size_t n)
@@ -1964,6 +1881,132 @@ namespace lsp
                 }
             }
 
+            void Renderer::wire_cached_polyline(uint32_t ci, clip_rect_t *rect, const float *coords, float width, size_t n)
+            {
+                const float * const x = coords;
+                const float * const y = &coords[n];
+
+                // Do not cache small polylines, it is cheaper to generate them
+                if (n < GeometryCache::MIN_POINTS)
+                {
+                    if (rect != NULL)
+                        wire_polyline(ci, *rect, x, y, width, n);
+                    else
+                        wire_polyline(ci, x, y, width, n);
+                    return;
+                }
+
+                // Lookup the cache
+                const uint32_t hash = GeometryCache::hash(coords, n, width);
+                const GeometryCache::geometry_t *g = sGeometry.get(hash, coords, n, width);
+                if (g != NULL)
+                {
+                    replay_geometry(ci, rect, g);
+                    return;
+                }
+
+                // Generate geometry without caching if it was not seen recently
+                if (!sGeometry.admit(hash))
+                {
+                    if (rect != NULL)
+                        wire_polyline(ci, *rect, x, y, width, n);
+                    else
+                        wire_polyline(ci, x, y, width, n);
+                    return;
+                }
+
+                // Generate geometry and put it to the cache
+                clip_rect_t bounds;
+                bounds.left         = x[0];
+                bounds.top          = y[0];
+                bounds.right        = x[0];
+                bounds.bottom       = y[0];
+
+                const uint32_t vi   = sBatch.next_vertex_index();
+                const uint32_t ii   = sBatch.next_index_position();
+                wire_polyline(ci, bounds, x, y, width, n);
+                const uint32_t nv   = sBatch.next_vertex_index() - vi;
+                const uint32_t ni   = sBatch.next_index_position() - ii;
+
+                if (nv > 0)
+                {
+                    sGeometry.put(
+                        hash, coords, n, width, bounds,
+                        sBatch.vertex_at(vi), nv,
+                        sBatch.index_at(ii), sBatch.index_format(), vi, ni);
+
+                    if (rect != NULL)
+                    {
+                        extend_rect(*rect, bounds.left, bounds.top);
+                        extend_rect(*rect, bounds.right, bounds.bottom);
+                    }
+                }
+            }
+
+            void Renderer::replay_geometry(uint32_t ci, clip_rect_t *rect, const GeometryCache::geometry_t *g)
+            {
+                const size_t nv     = g->nvertices;
+                const size_t ni     = g->nindices;
+                if (nv == 0)
+                    return;
+
+                // Copy vertices
+                const uint32_t vi   = sBatch.next_vertex_index();
+                vertex_t *v         = sBatch.add_vertices(nv);
+                if (v == NULL)
+                    return;
+
+                const vertex_t *sv  = g->vertices;
+                for (size_t i=0; i<nv; ++i)
+                {
+                    v[i]                = sv[i];
+                    v[i].cmd            = ci;
+                }
+
+                // Copy indices
+                void *iv_raw        = sBatch.add_indices(ni, vi + nv - 1);
+                if (iv_raw == NULL)
+                {
+                    sBatch.release_vertices(nv);
+                    return;
+                }
+
+                const uint32_t *si  = g->indices;
+                switch (sBatch.index_format())
+                {
+                    case INDEX_FMT_U8:
+                    {
+                        uint8_t *iv         = static_cast<uint8_t *>(iv_raw);
+                        for (size_t i=0; i<ni; ++i)
+                            iv[i]               = uint8_t(si[i] + vi);
+                        break;
+                    }
+                    case INDEX_FMT_U16:
+                    {
+                        uint16_t *iv        = static_cast<uint16_t *>(iv_raw);
+                        for (size_t i=0; i<ni; ++i)
+                            iv[i]               = uint16_t(si[i] + vi);
+                        break;
+                    }
+                    case INDEX_FMT_U32:
+                    {
+                        uint32_t *iv        = static_cast<uint32_t *>(iv_raw);
+                        for (size_t i=0; i<ni; ++i)
+                            iv[i]               = si[i] + vi;
+                        break;
+                    }
+                    default:
+                        break;
+                }
+
+                // Update bounding rectangle
+                if (rect != NULL)
+                {
+                    extend_rect(*rect, g->rect.left, g->rect.top);
+                    extend_rect(*rect, g->rect.right, g->rect.bottom);
+                }
+            }
+
             void Renderer::wire_arc(uint32_t ci, float x, float y, float r, float a1, float a2, float width)
             {
                 // Compute parameters
@@ -50,6 +50,12 @@ namespace lsp
                 vertex_realloc  = 0;
                 index_alloc     = 0;
                 index_realloc   = 0;
+                context_switch  = 0;
+                context_reuse   = 0;
+                upload_direct   = 0;
+                upload_buffered = 0;
+                geometry_hit    = 0;
+                geometry_miss   = 0;
             }
 
             void output_stats(bool immediate)
@@ -64,13 +70,19 @@ namespace lsp
                         "indices=[alloc=%d, realloc=%d], "
                         "vertices=[alloc=%d, realloc=%d], "
                         "commands=[alloc=%d, realloc=%d], "
-                        "surface=[alloc=%d, free=%d]",
+                        "surface=[alloc=%d, free=%d], "
+                        "context=[switch=%d, reuse=%d], "
+                        "upload=[direct=%d, buffered=%d], "
+                        "geometry=[hit=%d, miss=%d]",
                         int(gl_stats.batch_alloc), int(gl_stats.batch_free),
                         int(gl_stats.draw_alloc), int(gl_stats.draw_free), int(gl_stats.draw_acquire), int(gl_stats.draw_release),
                         int(gl_stats.index_alloc), int(gl_stats.index_realloc),
                         int(gl_stats.vertex_alloc), int(gl_stats.vertex_realloc),
                         int(gl_stats.cmd_alloc), int(gl_stats.cmd_realloc),
-                        int(gl_stats.surface_alloc), int(gl_stats.surface_free));
+                        int(gl_stats.surface_alloc), int(gl_stats.surface_free),
+                        int(gl_stats.context_switch), int(gl_stats.context_reuse),
+                        int(gl_stats.upload_direct), int(gl_stats.upload_buffered),
+                        int(gl_stats.geometry_hit), int(gl_stats.geometry_miss));
                     stat_time       = ctime;
                 }
             }
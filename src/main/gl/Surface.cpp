@@ -30,6 +30,7 @@
 #include <cairo/cairo.h>
 #include <cairo/cairo-xlib.h>
 
+#include <private/decimation.h>
 #include <private/freetype/FontManager.h>
 #include <private/gl/Batch.h>
 #include <private/gl/Gradient.h>
@@ -638,6 +639,20 @@ namespace lsp
                 return res;
             }
 
+            inline float *Surface::decimate_coords(const float *x, const float *y, size_t & n)
+            {
+                float *res = static_cast<float *>(malloc(n * 2 * sizeof(float)));
+                if (res == NULL)
+                    return NULL;
+
+                // Decimate and pack Y coordinates right after X coordinates
+                const size_t count  = ws::decimate_poly(res, &res[n], x, y, n);
+                memmove(&res[count], &res[n], count * sizeof(float));
+                n                   = count;
+
+                return res;
+            }
+
             void Surface::fill_poly(const Color & c, const float *x, const float *y, size_t n)
             {
                 if (!pSurface->is_drawing())
@@ -695,7 +710,7 @@ namespace lsp
                 if (!pSurface->is_drawing())
                     return;
 
-                float * coords   = copy_coords(x, y, n);
+                float * coords   = (ws::need_decimation(x, n)) ? decimate_coords(x, y, n) : copy_coords(x, y, n);
                 if (coords == NULL)
                     return;
                 lsp_finally {
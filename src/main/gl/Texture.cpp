@@ -23,6 +23,7 @@
 
 #ifdef LSP_PLUGINS_USE_OPENGL
 
+#include <private/gl/Stats.h>
 #include <private/gl/Texture.h>
 #include <lsp-plug.in/common/debug.h>
 
@@ -71,6 +72,25 @@ namespace lsp
                 return result;
             }
 
+            const void *Texture::begin_upload(const void *buf, size_t width, size_t height, size_t stride, size_t pixel_size)
+            {
+                if ((buf == NULL) || (height == 0))
+                    return buf;
+
+                // Do not read the tail of the last row which may be out of the buffer
+                const size_t size   = stride * (height - 1) + width * pixel_size;
+                const void *data    = pContext->begin_unpack(buf, size);
+
+            #ifdef TRACE_OPENGL_STATS
+                if (data != buf)
+                    OPENGL_INC_STATS(upload_buffered);
+                else
+                    OPENGL_INC_STATS(upload_direct);
+            #endif /* TRACE_OPENGL_STATS */
+
+                return data;
+            }
+
             GLuint Texture::allocate_texture()
             {
                 if (nTextureId != 0)
@@ -129,9 +149,11 @@ namespace lsp
                 if (num_of_pixels != width)
                     vtbl->glPixelStorei(GL_UNPACK_ROW_LENGTH, num_of_pixels);
 
+                const void *data = begin_upload(buf, width, height, stride, pixel_size);
                 vtbl->glBindTexture(GL_TEXTURE_2D, texture_id);
-                vtbl->glTexImage2D(GL_TEXTURE_2D, 0, int_format, width, height, 0, tex_format, GL_UNSIGNED_BYTE, buf);
+                vtbl->glTexImage2D(GL_TEXTURE_2D, 0, int_format, width, height, 0, tex_format, GL_UNSIGNED_BYTE, data);
                 vtbl->glBindTexture(GL_TEXTURE_2D, GL_NONE);
+                pContext->end_unpack();
 
                 if (num_of_pixels != width)
                     vtbl->glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
@@ -186,12 +208,15 @@ namespace lsp
                 vtbl->glPixelStorei(GL_UNPACK_ROW_LENGTH, stride / pixel_size);
                 lsp_finally { vtbl->glPixelStorei(GL_UNPACK_ROW_LENGTH, 0); };
 
+                const void *data = begin_upload(buf, width, height, stride, pixel_size);
+                lsp_finally { pContext->end_unpack(); };
+
                 if (vtbl->glTextureSubImage2D)
-                    vtbl->glTextureSubImage2D(nTextureId, 0, x, y, width, height, tex_format, GL_UNSIGNED_BYTE, buf);
+                    vtbl->glTextureSubImage2D(nTextureId, 0, x, y, width, height, tex_format, GL_UNSIGNED_BYTE, data);
                 else
                 {
                     vtbl->glBindTexture(GL_TEXTURE_2D, nTextureId);
-                    vtbl->glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, tex_format, GL_UNSIGNED_BYTE, buf);
+                    vtbl->glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, tex_format, GL_UNSIGNED_BYTE, data);
                     vtbl->glBindTexture(GL_TEXTURE_2D, GL_NONE);
                 }
 
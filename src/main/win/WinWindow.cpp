@@ -450,19 +450,31 @@ namespace lsp
                     {
                         PAINTSTRUCT ps;
 
+                        // Render the area reported by the system, empty area means the whole window
+                        BeginPaint(hWindow, &ps);
                         ue.nType                = UIE_REDRAW;
                         ue.nLeft                = ps.rcPaint.left;
                         ue.nTop                 = ps.rcPaint.top;
                         ue.nWidth               = ps.rcPaint.right - ps.rcPaint.left;
                         ue.nHeight              = ps.rcPaint.bottom - ps.rcPaint.top;
-
-                        // Render and re-render if the surface is invalid
-                        BeginPaint(hWindow, &ps);
+                        if ((ue.nWidth <= 0) || (ue.nHeight <= 0))
+                        {
+                            ue.nLeft                = 0;
+                            ue.nTop                 = 0;
+                            ue.nWidth               = sSize.nWidth;
+                            ue.nHeight              = sSize.nHeight;
+                        }
                         handle_event(&ue);
                         EndPaint(hWindow, &ps);
 
+                        // Re-render the whole window if the surface is invalid
                         if (!pSurface->valid())
                         {
+                            ue.nLeft                = 0;
+                            ue.nTop                 = 0;
+                            ue.nWidth               = sSize.nWidth;
+                            ue.nHeight              = sSize.nHeight;
+
                             BeginPaint(hWindow, &ps);
                             handle_event(&ue);
                             EndPaint(hWindow, &ps);
@@ -882,6 +894,23 @@ namespace lsp
                 return STATUS_OK;
             }
 
+            status_t WinWindow::invalidate(const rectangle_t *r)
+            {
+                if (r == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if ((hWindow == NULL) || (!is_visible()))
+                    return STATUS_BAD_STATE;
+
+                RECT rect;
+                rect.left       = r->nLeft;
+                rect.top        = r->nTop;
+                rect.right      = r->nLeft + r->nWidth;
+                rect.bottom     = r->nTop + r->nHeight;
+
+                InvalidateRect(hWindow, &rect, FALSE);
+                return STATUS_OK;
+            }
+
             void *WinWindow::handle()
             {
                 return reinterpret_cast<void *>(hWindow);
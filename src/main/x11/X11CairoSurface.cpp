@@ -21,14 +21,23 @@
 
 #if defined(USE_LIBX11) && defined(USE_LIBCAIRO)
 
+#include <lsp-plug.in/common/alloc.h>
 #include <lsp-plug.in/common/types.h>
 #include <lsp-plug.in/common/debug.h>
 #include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/string.h>
 
 #include <cairo/cairo.h>
 #include <cairo/cairo-xlib.h>
+#ifdef CAIRO_HAS_TEE_SURFACE
+    #include <cairo/cairo-tee.h>
+#endif /* CAIRO_HAS_TEE_SURFACE */
+#include <sys/ipc.h>
+#include <sys/shm.h>
 
+#include <private/decimation.h>
 #include <private/freetype/FontManager.h>
+#include <private/freetype/blend.h>
 #include <private/x11/X11CairoGradient.h>
 #include <private/x11/X11CairoSurface.h>
 #include <private/x11/X11Display.h>
@@ -52,14 +61,48 @@ namespace lsp
                 return CAIRO_ANTIALIAS_DEFAULT;
             }
 
-            X11CairoSurface::X11CairoSurface(X11Display *dpy, Drawable drawable, Visual *visual, size_t width, size_t height):
-                ISurface(width, height, ST_XLIB)
+            void X11CairoSurface::init_state(X11Display *dpy)
             {
                 pDisplay        = dpy;
                 pCR             = NULL;
                 pFO             = NULL;
-                pRoot           = ::cairo_xlib_surface_create(dpy->x11display(), drawable, visual, width, height);
-                pSurface        = ::cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+                pRoot           = NULL;
+                pSurface        = NULL;
+                hDrawable       = None;
+                hGC             = None;
+                init_backing(&sBacking);
+                nStableFrames   = 0;
+                bShmPending     = false;
+                nDamage         = 0;
+                bRedrawPending  = false;
+                bRedrawActive   = false;
+                pRasterizer     = NULL;
+                pFrame          = NULL;
+                for (size_t i=0; i<BANDS_MAX; ++i)
+                {
+                    vRecording[i]       = NULL;
+                    vBands[i].self      = this;
+                    vBands[i].thread    = NULL;
+                    vBands[i].index     = i;
+                }
+                nBands          = 1;
+                pBandFrame      = NULL;
+                nBandJob        = 0;
+                nBandPending    = 0;
+                nBandTop        = 0;
+                nBandBottom     = 0;
+                nBandRows       = 0;
+                bBandStop       = false;
+                for (size_t i=0; i<SCALED_MAX; ++i)
+                {
+                    vScaled[i].surface  = NULL;
+                    vScaled[i].width    = 0;
+                    vScaled[i].height   = 0;
+                    vScaled[i].used     = 0;
+                }
+                nScaledUse      = 0;
+                nScaledWidth    = 0;
+                nScaledHeight   = 0;
                 fOriginX        = 0.0f;
                 fOriginY        = 0.0f;
 
@@ -68,37 +111,34 @@ namespace lsp
             #endif /* LSP_DEBUG */
             }
 
+            X11CairoSurface::X11CairoSurface(X11Display *dpy, Drawable drawable, Visual *visual, size_t width, size_t height):
+                ISurface(width, height, ST_XLIB)
+            {
+                init_state(dpy);
+                pRoot           = ::cairo_xlib_surface_create(dpy->x11display(), drawable, visual, width, height);
+                hDrawable       = drawable;
+
+                // Try to draw directly into the shared memory segment, fall back to regular image otherwise
+                if (alloc_backing(&sBacking, width, height))
+                    pSurface        = wrap_backing(&sBacking, width, height);
+                if (pSurface == NULL)
+                    pSurface        = ::cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+                damage(0, 0, width, height);
+            }
+
             X11CairoSurface::X11CairoSurface(X11Display *dpy, size_t width, size_t height):
                 ISurface(width, height, ST_IMAGE)
             {
-                pDisplay        = dpy;
-                pCR             = NULL;
-                pFO             = NULL;
-                pRoot           = NULL;
+                init_state(dpy);
                 pSurface        = ::cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-                fOriginX        = 0.0f;
-                fOriginY        = 0.0f;
-
-            #ifdef LSP_DEBUG
-                nNumClips       = 0;
-            #endif /* LSP_DEBUG */
             }
 
             X11CairoSurface::X11CairoSurface(X11Display *dpy, cairo_surface_t *surface, size_t width, size_t height):
                 ISurface(width, height, ST_SIMILAR)
             {
-                pDisplay        = dpy;
-                pCR             = NULL;
-                pFO             = NULL;
-                pRoot           = NULL;
+                init_state(dpy);
                 pSurface        = ::cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-                fOriginX        = 0.0f;
-                fOriginY        = 0.0f;
-
 //                pSurface        = ::cairo_surface_create_similar(surface, CAIRO_CONTENT_COLOR_ALPHA, width, height);
-            #ifdef LSP_DEBUG
-                nNumClips       = 0;
-            #endif /* LSP_DEBUG */
             }
 
             IDisplay *X11CairoSurface::display()
@@ -135,6 +175,13 @@ namespace lsp
 
             void X11CairoSurface::destroy_context(bool root)
             {
+                // Rasterizer should not access the surface anymore
+                if (root)
+                    stop_rasterizer();
+                else
+                    wait_frames(0);
+
+                drop_scaled();
                 if (pFO != NULL)
                 {
                     cairo_font_options_destroy(pFO);
@@ -150,6 +197,13 @@ namespace lsp
                     cairo_surface_destroy(pSurface);
                     pSurface        = NULL;
                 }
+                if (root)
+                    free_backing(&sBacking);
+                if ((hGC != None) && (root))
+                {
+                    ::XFreeGC(pDisplay->x11display(), hGC);
+                    hGC             = None;
+                }
                 if ((pRoot != NULL) && (root))
                 {
                     cairo_surface_destroy(pRoot);
@@ -157,6 +211,405 @@ namespace lsp
                 }
             }
 
+            void X11CairoSurface::init_backing(backing_t *b)
+            {
+                b->image            = NULL;
+                bzero(&b->shm, sizeof(b->shm));
+                b->shm.shmid        = -1;
+                b->attached         = false;
+                b->heap             = NULL;
+                b->data             = NULL;
+                b->stride           = 0;
+                b->width            = 0;
+                b->height           = 0;
+            }
+
+            bool X11CairoSurface::alloc_shm_backing(backing_t *b, size_t width, size_t height)
+            {
+                if (hDrawable == None)
+                    return false;
+                if (!pDisplay->shm_supported())
+                    return false;
+
+                // Shared memory image can be used only if it's pixel layout matches the cairo's one
+                Display *dpy        = pDisplay->x11display();
+                XWindowAttributes xwa;
+                if (!::XGetWindowAttributes(dpy, hDrawable, &xwa))
+                    return false;
+                if ((xwa.depth != 24) && (xwa.depth != 32))
+                    return false;
+                if ((xwa.visual->red_mask != 0xff0000) ||
+                    (xwa.visual->green_mask != 0xff00) ||
+                    (xwa.visual->blue_mask != 0xff))
+                    return false;
+
+                XImage *image       = ::XShmCreateImage(dpy, xwa.visual, xwa.depth, ZPixmap, NULL, &b->shm, width, height);
+                if (image == NULL)
+                    return false;
+            #ifdef ARCH_LE
+                const int byte_order    = LSBFirst;
+            #else
+                const int byte_order    = MSBFirst;
+            #endif /* ARCH_LE */
+                if ((image->bits_per_pixel != 32) || (image->byte_order != byte_order))
+                {
+                    ::XDestroyImage(image);
+                    return false;
+                }
+
+                // Allocate the shared memory segment
+                b->image            = image;
+                b->shm.shmid        = ::shmget(IPC_PRIVATE, image->bytes_per_line * image->height, IPC_CREAT | 0600);
+                if (b->shm.shmid < 0)
+                {
+                    free_backing(b);
+                    return false;
+                }
+                void *addr          = ::shmat(b->shm.shmid, NULL, 0);
+                if (addr == reinterpret_cast<void *>(-1))
+                {
+                    ::shmctl(b->shm.shmid, IPC_RMID, NULL);
+                    free_backing(b);
+                    return false;
+                }
+                b->shm.shmaddr      = static_cast<char *>(addr);
+                b->shm.readOnly     = False;
+                image->data         = b->shm.shmaddr;
+
+                // Attach the segment and mark it for removal: it will be released after the last detach
+                b->attached         = pDisplay->shm_attach(&b->shm);
+                ::shmctl(b->shm.shmid, IPC_RMID, NULL);
+                if (!b->attached)
+                {
+                    free_backing(b);
+                    return false;
+                }
+
+                // Create graphic context
+                if (hGC == None)
+                {
+                    hGC                 = ::XCreateGC(dpy, hDrawable, 0, NULL);
+                    if (hGC == None)
+                    {
+                        free_backing(b);
+                        return false;
+                    }
+                }
+
+                b->data             = reinterpret_cast<uint8_t *>(image->data);
+                b->stride           = image->bytes_per_line;
+                b->width            = width;
+                b->height           = height;
+
+                lsp_trace("Using MIT-SHM presentation for surface this=%p, size=%dx%d", this, int(width), int(height));
+
+                return true;
+            }
+
+            bool X11CairoSurface::alloc_backing(backing_t *b, size_t width, size_t height)
+            {
+                if ((width == 0) || (height == 0))
+                    return false;
+
+                // Round up the size to reuse the buffer while the window is being resized
+                width               = align_size(width, BACKING_STEP);
+                height              = align_size(height, BACKING_STEP);
+
+                // Try to draw directly into the shared memory segment, fall back to heap otherwise
+                if (alloc_shm_backing(b, width, height))
+                    return true;
+
+                const size_t stride = ::cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width);
+                uint8_t *heap       = static_cast<uint8_t *>(malloc(stride * height));
+                if (heap == NULL)
+                    return false;
+
+                b->heap             = heap;
+                b->data             = heap;
+                b->stride           = stride;
+                b->width            = width;
+                b->height           = height;
+
+                return true;
+            }
+
+            void X11CairoSurface::free_backing(backing_t *b)
+            {
+                if (b->image != NULL)
+                {
+                    Display *dpy        = pDisplay->x11display();
+                    if (b->attached)
+                    {
+                        ::XShmDetach(dpy, &b->shm);
+                        ::XSync(dpy, False);
+                        b->attached         = false;
+                        bShmPending         = false;
+                    }
+                    if (b->shm.shmaddr != NULL)
+                    {
+                        ::shmdt(b->shm.shmaddr);
+                        b->shm.shmaddr      = NULL;
+                    }
+                    b->shm.shmid        = -1;
+
+                    // Image data is owned by the shared memory segment
+                    b->image->data      = NULL;
+                    ::XDestroyImage(b->image);
+                    b->image            = NULL;
+                }
+                if (b->heap != NULL)
+                {
+                    free(b->heap);
+                    b->heap             = NULL;
+                }
+
+                b->data             = NULL;
+                b->stride           = 0;
+                b->width            = 0;
+                b->height           = 0;
+            }
+
+            cairo_surface_t *X11CairoSurface::wrap_backing(const backing_t *b, size_t width, size_t height)
+            {
+                cairo_surface_t *s  = ::cairo_image_surface_create_for_data(
+                    b->data, CAIRO_FORMAT_ARGB32, width, height, b->stride);
+                if (::cairo_surface_status(s) != CAIRO_STATUS_SUCCESS)
+                {
+                    ::cairo_surface_destroy(s);
+                    return NULL;
+                }
+
+                return s;
+            }
+
+            void X11CairoSurface::shrink_backing()
+            {
+                if ((sBacking.data == NULL) || (pSurface == NULL))
+                    return;
+                if ((align_size(nWidth, BACKING_STEP) >= sBacking.width) &&
+                    (align_size(nHeight, BACKING_STEP) >= sBacking.height))
+                    return;
+
+                // Back buffer should not be accessed by X server or rasterizer
+                wait_frames(0);
+                if (bShmPending)
+                {
+                    ::XSync(pDisplay->x11display(), False);
+                    bShmPending         = false;
+                }
+
+                // Allocate new back buffer and copy contents of the old one
+                backing_t b;
+                init_backing(&b);
+                if (!alloc_backing(&b, nWidth, nHeight))
+                    return;
+                cairo_surface_t *s  = wrap_backing(&b, nWidth, nHeight);
+                if (s == NULL)
+                {
+                    free_backing(&b);
+                    return;
+                }
+
+                ::cairo_surface_flush(pSurface);
+                for (size_t i=0; i<nHeight; ++i)
+                    memcpy(&b.data[i * b.stride], &sBacking.data[i * sBacking.stride], nWidth * sizeof(uint32_t));
+                ::cairo_surface_mark_dirty(s);
+
+                // Replace the back buffer
+                if (pCR != NULL)
+                {
+                    ::cairo_destroy(pCR);
+                    pCR                 = NULL;
+                }
+                ::cairo_surface_destroy(pSurface);
+                pSurface            = s;
+                free_backing(&sBacking);
+                sBacking            = b;
+
+                // XShmCreateImage() stores pointer to the segment descriptor in the image
+                if (sBacking.image != NULL)
+                    sBacking.image->obdata  = reinterpret_cast<char *>(&sBacking.shm);
+
+                lsp_trace("Shrinked back buffer this=%p, size=%dx%d", this, int(sBacking.width), int(sBacking.height));
+            }
+
+            void X11CairoSurface::add_damage(ssize_t l, ssize_t t, ssize_t r, ssize_t b)
+            {
+                l               = lsp_max(l, 0);
+                t               = lsp_max(t, 0);
+                r               = lsp_min(r, ssize_t(nWidth));
+                b               = lsp_min(b, ssize_t(nHeight));
+                if ((l >= r) || (t >= b))
+                    return;
+
+                // Merge with the box if the union does not cover more area than both boxes
+                const ssize_t area  = (r - l) * (b - t);
+                ssize_t best_cost   = 0;
+                size_t best         = nDamage;
+
+                for (size_t i=0; i<nDamage; ++i)
+                {
+                    damage_t *d         = &vDamage[i];
+                    const ssize_t ul    = lsp_min(d->l, l);
+                    const ssize_t ut    = lsp_min(d->t, t);
+                    const ssize_t ur    = lsp_max(d->r, r);
+                    const ssize_t ub    = lsp_max(d->b, b);
+                    const ssize_t cost  = (ur - ul) * (ub - ut) - (d->r - d->l) * (d->b - d->t) - area;
+
+                    if (cost <= 0)
+                    {
+                        d->l                = ul;
+                        d->t                = ut;
+                        d->r                = ur;
+                        d->b                = ub;
+                        return;
+                    }
+                    if ((best >= nDamage) || (cost < best_cost))
+                    {
+                        best                = i;
+                        best_cost           = cost;
+                    }
+                }
+
+                // Add new box if possible
+                if (nDamage < DAMAGE_MAX)
+                {
+                    damage_t *d         = &vDamage[nDamage++];
+                    d->l                = l;
+                    d->t                = t;
+                    d->r                = r;
+                    d->b                = b;
+                    return;
+                }
+
+                // Merge with the box that gives the least overhead
+                damage_t *d         = &vDamage[best];
+                d->l                = lsp_min(d->l, l);
+                d->t                = lsp_min(d->t, t);
+                d->r                = lsp_max(d->r, r);
+                d->b                = lsp_max(d->b, b);
+            }
+
+            void X11CairoSurface::damage(ssize_t left, ssize_t top, ssize_t width, ssize_t height)
+            {
+                if (nType == ST_XLIB)
+                    add_damage(left, top, left + width, top + height);
+            }
+
+            void X11CairoSurface::set_redraw_area(const ws::rectangle_t *r)
+            {
+                if (r != NULL)
+                    sRedraw         = *r;
+                bRedrawPending  = (r != NULL);
+            }
+
+            void X11CairoSurface::damage_user(double l, double t, double r, double b)
+            {
+                // Clip by the active clipping region
+                double cl, ct, cr, cb;
+                ::cairo_clip_extents(pCR, &cl, &ct, &cr, &cb);
+                l               = lsp_max(l, cl);
+                t               = lsp_max(t, ct);
+                r               = lsp_min(r, cr);
+                b               = lsp_min(b, cb);
+                if ((l >= r) || (t >= b))
+                    return;
+
+                // Translate to device coordinates
+                double x[4]     = { l, r, r, l };
+                double y[4]     = { t, t, b, b };
+                ::cairo_user_to_device(pCR, &x[0], &y[0]);
+                double dl       = x[0], dt = y[0], dr = x[0], db = y[0];
+                for (size_t i=1; i<4; ++i)
+                {
+                    ::cairo_user_to_device(pCR, &x[i], &y[i]);
+                    dl              = lsp_min(dl, x[i]);
+                    dt              = lsp_min(dt, y[i]);
+                    dr              = lsp_max(dr, x[i]);
+                    db              = lsp_max(db, y[i]);
+                }
+
+                // Extend by one pixel for anti-aliasing
+                add_damage(ssize_t(floor(dl)) - 1, ssize_t(floor(dt)) - 1, ssize_t(ceil(dr)) + 1, ssize_t(ceil(db)) + 1);
+            }
+
+            inline void X11CairoSurface::damage_path(double extra)
+            {
+                if (nType != ST_XLIB)
+                    return;
+
+                double l, t, r, b;
+                ::cairo_path_extents(pCR, &l, &t, &r, &b);
+                if ((l == r) && (t == b))
+                    return;
+                damage_user(l - extra, t - extra, r + extra, b + extra);
+            }
+
+            inline void X11CairoSurface::fill_path()
+            {
+                damage_path(0.0);
+                ::cairo_fill(pCR);
+            }
+
+            inline void X11CairoSurface::fill_path_preserve()
+            {
+                damage_path(0.0);
+                ::cairo_fill_preserve(pCR);
+            }
+
+            inline void X11CairoSurface::stroke_path()
+            {
+                damage_path(::cairo_get_line_width(pCR) * 0.5);
+                ::cairo_stroke(pCR);
+            }
+
+            inline void X11CairoSurface::paint()
+            {
+                if (nType == ST_XLIB)
+                {
+                    double l, t, r, b;
+                    ::cairo_clip_extents(pCR, &l, &t, &r, &b);
+                    damage_user(l, t, r, b);
+                }
+                ::cairo_paint(pCR);
+            }
+
+            inline void X11CairoSurface::paint_with_alpha(double alpha)
+            {
+                if (nType == ST_XLIB)
+                {
+                    double l, t, r, b;
+                    ::cairo_clip_extents(pCR, &l, &t, &r, &b);
+                    damage_user(l, t, r, b);
+                }
+                ::cairo_paint_with_alpha(pCR, alpha);
+            }
+
+            inline void X11CairoSurface::mask_surface(cairo_surface_t *s, double x, double y)
+            {
+                if (nType == ST_XLIB)
+                    damage_user(
+                        x, y,
+                        x + ::cairo_image_surface_get_width(s),
+                        y + ::cairo_image_surface_get_height(s));
+                ::cairo_mask_surface(pCR, s, x, y);
+            }
+
+            inline void X11CairoSurface::show_text(const char *text)
+            {
+                if (nType == ST_XLIB)
+                {
+                    double x, y;
+                    cairo_text_extents_t te;
+                    ::cairo_get_current_point(pCR, &x, &y);
+                    ::cairo_text_extents(pCR, text, &te);
+                    damage_user(
+                        x + te.x_bearing, y + te.y_bearing,
+                        x + te.x_bearing + te.width, y + te.y_bearing + te.height);
+                }
+                ::cairo_show_text(pCR, text);
+            }
+
             void X11CairoSurface::destroy()
             {
                 destroy_context(true);
@@ -169,12 +622,42 @@ namespace lsp
 
             status_t X11CairoSurface::resize(size_t width, size_t height)
             {
+                // Wait until all recorded frames are rasterized
+                wait_frames(0);
+
                 if (pRoot != NULL)
                     ::cairo_xlib_surface_set_size(pRoot, width, height);
 
                 // Create new surface and cairo
                 cairo_surface_t *s  = NULL;
-                if ((nType == ST_IMAGE) || (nType == ST_XLIB))
+                if (nType == ST_XLIB)
+                {
+                    nStableFrames       = 0;
+
+                    // Re-allocate the back buffer only if it is too small
+                    if ((sBacking.data == NULL) || (width > sBacking.width) || (height > sBacking.height))
+                    {
+                        destroy_context(false);
+                        free_backing(&sBacking);
+                        if (alloc_backing(&sBacking, width, height))
+                            lsp_trace("Allocated back buffer this=%p, size=%dx%d", this, int(sBacking.width), int(sBacking.height));
+                    }
+                    else if (bShmPending)
+                    {
+                        // X server may still read the back buffer
+                        ::XSync(pDisplay->x11display(), False);
+                        bShmPending         = false;
+                    }
+
+                    if (sBacking.data != NULL)
+                        s  = wrap_backing(&sBacking, width, height);
+                    if (s == NULL)
+                    {
+                        free_backing(&sBacking);
+                        s  = ::cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+                    }
+                }
+                else if (nType == ST_IMAGE)
                     s  = ::cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
                 else if (nType == ST_SIMILAR)
                     s  = ::cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
@@ -188,6 +671,8 @@ namespace lsp
                 pSurface            = s;
                 nWidth              = width;
                 nHeight             = height;
+                nDamage             = 0;
+                damage(0, 0, width, height);
 
                 return STATUS_OK;
             }
@@ -203,6 +688,7 @@ namespace lsp
                 X11CairoSurface *cs = static_cast<X11CairoSurface *>(s);
                 if (cs->pSurface == NULL)
                     return;
+                cs->wait_frames(0);
 
                 // Draw one surface on another
                 float sw = fabsf(sx * s->width()), sh = fabsf(sy * s->height());
@@ -214,23 +700,37 @@ namespace lsp
 
                 if ((sx != 1.0f) && (sy != 1.0f))
                 {
-                    if (sx < 0.0f)
-                        x       -= sx * s->width();
-                    if (sy < 0.0f)
-                        y       -= sy * s->height();
+                    // Try to use the downscaled copy of the surface instead of resampling
+                    const size_t cw         = size_t(sw + 0.5f);
+                    const size_t ch         = size_t(sh + 0.5f);
+                    cairo_surface_t *scaled = ((sx > 0.0f) && (sy > 0.0f)) ? cs->scaled_copy(cw, ch) : NULL;
 
-                    ::cairo_translate(pCR, x, y);
-                    ::cairo_scale(pCR, sx, sy);
-                    ::cairo_set_source_surface(pCR, cs->pSurface, 0.0f, 0.0f);
+                    if (scaled != NULL)
+                    {
+                        ::cairo_translate(pCR, x, y);
+                        ::cairo_scale(pCR, sw / cw, sh / ch);
+                        ::cairo_set_source_surface(pCR, scaled, 0.0f, 0.0f);
+                    }
+                    else
+                    {
+                        if (sx < 0.0f)
+                            x       -= sx * s->width();
+                        if (sy < 0.0f)
+                            y       -= sy * s->height();
+
+                        ::cairo_translate(pCR, x, y);
+                        ::cairo_scale(pCR, sx, sy);
+                        ::cairo_set_source_surface(pCR, cs->pSurface, 0.0f, 0.0f);
+                    }
                 }
                 else
                     ::cairo_set_source_surface(pCR, cs->pSurface, x, y);
 
                 // Draw the surface
                 if (a > 0.0f)
-                    ::cairo_paint_with_alpha(pCR, 1.0f - a);
+                    paint_with_alpha(1.0f - a);
                 else
-                    ::cairo_paint(pCR);
+                    paint();
             }
 
             void X11CairoSurface::draw_rotate(ISurface *s, float x, float y, float sx, float sy, float ra, float a)
@@ -243,113 +743,836 @@ namespace lsp
                 X11CairoSurface *cs = static_cast<X11CairoSurface *>(s);
                 if (cs->pSurface == NULL)
                     return;
+                cs->wait_frames(0);
+
+                // Uniform scaling commutes with rotation, so the downscaled copy can be used
+                const float sw          = sx * s->width();
+                const float sh          = sy * s->height();
+                const size_t cw         = size_t(sw + 0.5f);
+                const size_t ch         = size_t(sh + 0.5f);
+                cairo_surface_t *scaled = ((type != ST_XLIB) && (sx == sy) && (sx > 0.0f)) ? cs->scaled_copy(cw, ch) : NULL;
 
                 // Draw one surface on another
                 ::cairo_save(pCR);
                 ::cairo_translate(pCR, x, y);
-                ::cairo_scale(pCR, sx, sy);
-                ::cairo_rotate(pCR, ra);
-                ::cairo_set_source_surface(pCR, cs->pSurface, 0.0f, 0.0f);
+                if (scaled != NULL)
+                {
+                    ::cairo_rotate(pCR, ra);
+                    ::cairo_scale(pCR, sw / cw, sh / ch);
+                    ::cairo_set_source_surface(pCR, scaled, 0.0f, 0.0f);
+                }
+                else
+                {
+                    ::cairo_scale(pCR, sx, sy);
+                    ::cairo_rotate(pCR, ra);
+                    ::cairo_set_source_surface(pCR, cs->pSurface, 0.0f, 0.0f);
+                }
                 if (a > 0.0f)
-                    ::cairo_paint_with_alpha(pCR, 1.0f - a);
+                    paint_with_alpha(1.0f - a);
                 else
-                    ::cairo_paint(pCR);
+                    paint();
                 ::cairo_restore(pCR);
             }
 
+            cairo_surface_t *X11CairoSurface::scaled_copy(size_t width, size_t height)
+            {
+                // The copy is useful only for downscaling
+                if ((width == 0) || (height == 0) || (width > nWidth) || (height > nHeight))
+                    return NULL;
+                if ((width == nWidth) && (height == nHeight))
+                    return NULL;
+
+                // Lookup for the copy, select the unused or least recently used slot
+                scaled_t *slot      = &vScaled[0];
+                for (size_t i=0; i<SCALED_MAX; ++i)
+                {
+                    scaled_t *sc        = &vScaled[i];
+                    if ((sc->surface != NULL) && (sc->width == width) && (sc->height == height))
+                    {
+                        sc->used            = ++nScaledUse;
+                        return sc->surface;
+                    }
+                    if ((slot->surface != NULL) && ((sc->surface == NULL) || (sc->used < slot->used)))
+                        slot                = sc;
+                }
+
+                // Create the copy only if the same size has been requested twice in a row,
+                // animated scaling should not pay for rendering of the copies
+                if ((nScaledWidth != width) || (nScaledHeight != height))
+                {
+                    nScaledWidth        = width;
+                    nScaledHeight       = height;
+                    return NULL;
+                }
+
+                cairo_surface_t *cs = ::cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+                if (::cairo_surface_status(cs) != CAIRO_STATUS_SUCCESS)
+                {
+                    ::cairo_surface_destroy(cs);
+                    return NULL;
+                }
+
+                cairo_t *cr         = ::cairo_create(cs);
+                if (::cairo_status(cr) != CAIRO_STATUS_SUCCESS)
+                {
+                    ::cairo_destroy(cr);
+                    ::cairo_surface_destroy(cs);
+                    return NULL;
+                }
+
+                ::cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+                ::cairo_scale(cr, double(width) / double(nWidth), double(height) / double(nHeight));
+                ::cairo_set_source_surface(cr, pSurface, 0.0, 0.0);
+                ::cairo_paint(cr);
+                ::cairo_destroy(cr);
+                ::cairo_surface_flush(cs);
+
+                // Replace the slot
+                if (slot->surface != NULL)
+                    ::cairo_surface_destroy(slot->surface);
+                slot->surface       = cs;
+                slot->width         = width;
+                slot->height        = height;
+                slot->used          = ++nScaledUse;
+
+                return cs;
+            }
+
+            void X11CairoSurface::drop_scaled()
+            {
+                for (size_t i=0; i<SCALED_MAX; ++i)
+                {
+                    scaled_t *sc        = &vScaled[i];
+                    if (sc->surface != NULL)
+                    {
+                        ::cairo_surface_destroy(sc->surface);
+                        sc->surface         = NULL;
+                    }
+                }
+                nScaledWidth        = 0;
+                nScaledHeight       = 0;
+            }
+
             void X11CairoSurface::draw_raw(
                 const void *data, size_t width, size_t height, size_t stride,
                 float x, float y, float sx, float sy, float a)
             {
-                if (pCR == NULL)
+                if (pCR == NULL)
+                    return;
+
+                cairo_surface_t *cs = cairo_image_surface_create_for_data(
+                    static_cast<unsigned char *>(const_cast<void *>(data)),
+                    CAIRO_FORMAT_ARGB32,
+                    width, height, stride);
+                if (cs == NULL)
+                    return;
+                lsp_finally { cairo_surface_destroy(cs); };
+
+                // Draw one surface on another
+                ::cairo_save(pCR);
+                lsp_finally { ::cairo_restore(pCR); };
+
+                if ((sx != 1.0f) && (sy != 1.0f))
+                {
+                    if (sx < 0.0f)
+                        x       -= sx * width;
+                    if (sy < 0.0f)
+                        y       -= sy * height;
+
+                    ::cairo_translate(pCR, x, y);
+                    ::cairo_scale(pCR, sx, sy);
+                    ::cairo_set_source_surface(pCR, cs, 0.0f, 0.0f);
+                }
+                else
+                    ::cairo_set_source_surface(pCR, cs, x, y);
+
+                // Draw the surface
+                if (a > 0.0f)
+                    paint_with_alpha(1.0f - a);
+                else
+                    paint();
+            }
+
+            void X11CairoSurface::setup_context(cairo_antialias_t aa)
+            {
+                // Initialize settings
+                ::cairo_identity_matrix(pCR);
+                ::cairo_set_antialias(pCR, aa);
+                ::cairo_set_line_join(pCR, CAIRO_LINE_JOIN_BEVEL);
+                ::cairo_set_tolerance(pCR, 0.5);
+
+                // Apply redraw area
+                if (bRedrawActive)
+                {
+                    ::cairo_rectangle(pCR, sRedraw.nLeft, sRedraw.nTop, sRedraw.nWidth, sRedraw.nHeight);
+                    ::cairo_clip(pCR);
+                    ::cairo_new_path(pCR);
+                }
+
+                // Restore clipping stack of the recorded frame
+                for (size_t i=0, n=vClips.size(); i<n; ++i)
+                {
+                    const clip_t *c = vClips.uget(i);
+                    cairo_matrix_t matrix;
+                    ::cairo_matrix_init_translate(&matrix, c->ox, c->oy);
+                    ::cairo_set_matrix(pCR, &matrix);
+
+                    ::cairo_save(pCR);
+                    ::cairo_rectangle(pCR, c->x, c->y, c->w, c->h);
+                    ::cairo_clip(pCR);
+                    ::cairo_new_path(pCR);
+                }
+
+                // Restore drawing origin
+                cairo_matrix_t matrix;
+                ::cairo_matrix_init_translate(&matrix, fOriginX, fOriginY);
+                ::cairo_set_matrix(pCR, &matrix);
+            }
+
+            void X11CairoSurface::begin()
+            {
+                // Force end() call
+                end();
+
+                // Surface is going to be redrawn, downscaled copies become invalid
+                drop_scaled();
+
+                // Release excess memory of the back buffer when resizing has settled
+                if ((nType == ST_XLIB) && (nStableFrames < BACKING_SHRINK_FRAMES))
+                {
+                    if ((++nStableFrames) >= BACKING_SHRINK_FRAMES)
+                        shrink_backing();
+                }
+
+                // Apply redraw area
+                bRedrawActive   = bRedrawPending;
+                bRedrawPending  = false;
+
+                if (pRasterizer != NULL)
+                {
+                    // Limit the number of frames queued for rasterization
+                    wait_frames(ASYNC_FRAMES - 1);
+
+                    // Start recording of the new frame
+                    vClips.clear();
+                    if ((pFrame = new frame_t) == NULL)
+                        return;
+                    pFrame->ndamage     = 0;
+                    if (!begin_segment(CAIRO_ANTIALIAS_FAST))
+                    {
+                        destroy_frame(pFrame);
+                        pFrame              = NULL;
+                        return;
+                    }
+                }
+                else
+                {
+                    // Wait until X server completes reading of the shared memory segment
+                    if (bShmPending)
+                    {
+                        ::XSync(pDisplay->x11display(), False);
+                        bShmPending     = false;
+                    }
+
+                    // Create cairo objects
+                    if (pCR == NULL)
+                    {
+                        if ((pCR = ::cairo_create(pSurface)) == NULL)
+                            return;
+                    }
+
+                    setup_context(CAIRO_ANTIALIAS_FAST);
+                }
+
+                if (pFO == NULL)
+                {
+                    if ((pFO = ::cairo_font_options_create()) == NULL)
+                        return;
+                }
+
+            #ifdef LSP_DEBUG
+                nNumClips       = 0;
+            #endif /* LSP_DEBUG */
+            }
+
+            void X11CairoSurface::end()
+            {
+                if (pCR == NULL)
+                    return;
+
+                // Copies made while the surface was being drawn may be incomplete
+                drop_scaled();
+
+            #ifdef LSP_DEBUG
+                if (nNumClips > 0)
+                    lsp_error("Mismatching number of clip_begin() and clip_end() calls");
+            #endif /* LSP_DEBUG */
+
+                // Pass the recorded frame to the rasterizer
+                if (pRasterizer != NULL)
+                {
+                    end_segment();
+                    bRedrawActive       = false;
+                    if (pFrame == NULL)
+                        return;
+
+                    // Image surfaces do not track damage, rasterize them entirely
+                    if (nType != ST_XLIB)
+                        add_damage(0, 0, nWidth, nHeight);
+
+                    for (size_t i=0; i<nDamage; ++i)
+                        pFrame->damage[i]   = vDamage[i];
+                    pFrame->ndamage     = nDamage;
+                    nDamage             = 0;
+
+                    sFrameLock.lock();
+                    lsp_finally { sFrameLock.unlock(); };
+
+                    if (!vFrames.add(pFrame))
+                        destroy_frame(pFrame);
+                    pFrame              = NULL;
+                    sFrameLock.notify_all();
+                    return;
+                }
+
+                // Reset redraw area
+                if (bRedrawActive)
+                {
+                    ::cairo_reset_clip(pCR);
+                    bRedrawActive   = false;
+                }
+
+                ::cairo_surface_flush(pSurface);
+
+                // Copy only damaged areas
+                lsp_finally { nDamage = 0; };
+                present(vDamage, nDamage, false);
+            }
+
+            void X11CairoSurface::present(const damage_t *damage, size_t count, bool sync)
+            {
+                if (count == 0)
+                    return;
+
+                // Put shared memory image directly to the drawable
+                if (sBacking.image != NULL)
+                {
+                    Display *dpy    = pDisplay->x11display();
+                    for (size_t i=0; i<count; ++i)
+                    {
+                        const damage_t *d = &damage[i];
+                        ::XShmPutImage(dpy, hDrawable, hGC, sBacking.image, d->l, d->t, d->l, d->t, d->r - d->l, d->b - d->t, False);
+                    }
+
+                    // Synchronous presentation waits until X server reads the segment,
+                    // otherwise the wait is deferred until the next begin() call
+                    if (sync)
+                        ::XSync(dpy, False);
+                    else
+                    {
+                        ::XFlush(dpy);
+                        bShmPending     = true;
+                    }
+                    return;
+                }
+
+                // Copy back surface to front surface if it is present
+                if (pRoot != NULL)
+                {
+                    cairo_t *cr = ::cairo_create(pRoot);
+                    if (cr == NULL)
+                        return;
+                    lsp_finally {
+                        cairo_destroy(cr);
+                    };
+
+                    for (size_t i=0; i<count; ++i)
+                    {
+                        const damage_t *d = &damage[i];
+                        ::cairo_rectangle(cr, d->l, d->t, d->r - d->l, d->b - d->t);
+                    }
+                    ::cairo_clip(cr);
+                    ::cairo_set_source_surface(cr, pSurface, 0, 0);
+                    ::cairo_paint(cr);
+                    ::cairo_surface_flush(pRoot);
+                }
+            }
+
+            status_t X11CairoSurface::start_async(size_t threads)
+            {
+                if (pCR != NULL)
+                    return STATUS_BAD_STATE;
+                if (pRasterizer != NULL)
+                    return STATUS_OK;
+
+                // Start band workers first, tiled rasterization is optional
+                if (threads > 1)
+                {
+                    if (start_bands(threads) != STATUS_OK)
+                        lsp_warn("Could not start band workers, using single-threaded rasterization");
+                }
+
+                ipc::Thread *thread = new ipc::Thread(rasterize_proc, this);
+                if (thread == NULL)
+                {
+                    stop_bands();
+                    return STATUS_NO_MEM;
+                }
+
+                pRasterizer         = thread;
+                status_t res        = thread->start();
+                if (res != STATUS_OK)
+                {
+                    pRasterizer         = NULL;
+                    delete thread;
+                    stop_bands();
+                }
+
+                return res;
+            }
+
+            status_t X11CairoSurface::start_bands(size_t count)
+            {
+            #ifdef CAIRO_HAS_TEE_SURFACE
+                count               = lsp_min(count, BANDS_MAX);
+
+                // The first band is always rasterized by the rasterization thread
+                for (size_t i=1; i<count; ++i)
+                {
+                    band_t *b           = &vBands[i];
+                    b->thread           = new ipc::Thread(band_proc, b);
+                    if (b->thread == NULL)
+                    {
+                        stop_bands();
+                        return STATUS_NO_MEM;
+                    }
+
+                    status_t res        = b->thread->start();
+                    if (res != STATUS_OK)
+                    {
+                        delete b->thread;
+                        b->thread           = NULL;
+                        stop_bands();
+                        return res;
+                    }
+                }
+
+                nBands              = count;
+                return STATUS_OK;
+            #else
+                // Each band needs its own copy of the recording which is made by the tee surface
+                return STATUS_NOT_SUPPORTED;
+            #endif /* CAIRO_HAS_TEE_SURFACE */
+            }
+
+            void X11CairoSurface::stop_bands()
+            {
+                // Terminate threads
+                {
+                    sBandLock.lock();
+                    lsp_finally { sBandLock.unlock(); };
+
+                    bBandStop           = true;
+                    sBandLock.notify_all();
+                }
+
+                // Wait until threads have terminated
+                for (size_t i=1; i<BANDS_MAX; ++i)
+                {
+                    band_t *b           = &vBands[i];
+                    if (b->thread == NULL)
+                        continue;
+
+                    b->thread->join();
+                    delete b->thread;
+                    b->thread           = NULL;
+                }
+
+                nBands              = 1;
+                bBandStop           = false;
+            }
+
+            void X11CairoSurface::stop_rasterizer()
+            {
+                if (pRasterizer == NULL)
+                    return;
+
+                // Terminate the thread
+                {
+                    sFrameLock.lock();
+                    lsp_finally { sFrameLock.unlock(); };
+
+                    pRasterizer->cancel();
+                    sFrameLock.notify_all();
+                }
+
+                // Wait until thread has terminated
+                pRasterizer->join();
+                delete pRasterizer;
+                pRasterizer         = NULL;
+                stop_bands();
+
+                // Drop all frames
+                for (size_t i=0, n=vFrames.size(); i<n; ++i)
+                    destroy_frame(vFrames.uget(i));
+                vFrames.flush();
+                if (pFrame != NULL)
+                {
+                    destroy_frame(pFrame);
+                    pFrame              = NULL;
+                }
+                destroy_segment();
+                vClips.flush();
+            }
+
+            status_t X11CairoSurface::rasterize_proc(void *arg)
+            {
+                X11CairoSurface * const self = static_cast<X11CairoSurface *>(arg);
+                return self->rasterize();
+            }
+
+            status_t X11CairoSurface::rasterize()
+            {
+                while (true)
+                {
+                    // Wait for the next frame
+                    frame_t *frame  = NULL;
+                    {
+                        sFrameLock.lock();
+                        lsp_finally { sFrameLock.unlock(); };
+
+                        while ((frame = vFrames.first()) == NULL)
+                        {
+                            if (pRasterizer->cancelled())
+                                return STATUS_OK;
+                            sFrameLock.wait();
+                        }
+                        if (pRasterizer->cancelled())
+                            return STATUS_OK;
+                    }
+
+                    // Render the frame and remove it from queue
+                    rasterize_frame(frame);
+                    {
+                        sFrameLock.lock();
+                        lsp_finally { sFrameLock.unlock(); };
+
+                        vFrames.shift();
+                        sFrameLock.notify_all();
+                    }
+                    destroy_frame(frame);
+                }
+            }
+
+            void X11CairoSurface::replay_frame(cairo_t *cr, const frame_t *frame, size_t index)
+            {
+                // Rasterize only damaged areas
+                for (size_t i=0; i<frame->ndamage; ++i)
+                {
+                    const damage_t *d = &frame->damage[i];
+                    ::cairo_rectangle(cr, d->l, d->t, d->r - d->l, d->b - d->t);
+                }
+                ::cairo_clip(cr);
+
+                // Replay steps
+                for (size_t i=0, n=frame->steps.size(); i<n; ++i)
+                {
+                    const step_t *s = frame->steps.uget(i);
+                    if (s->recording[index] != NULL)
+                    {
+                        ::cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+                        ::cairo_set_source_surface(cr, s->recording[index], 0.0, 0.0);
+                        ::cairo_paint(cr);
+                    }
+                    else
+                    {
+                        ::cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+                        ::cairo_set_source_rgba(cr, s->color[0], s->color[1], s->color[2], s->color[3]);
+                        ::cairo_rectangle(cr, s->l, s->t, s->r - s->l, s->b - s->t);
+                        ::cairo_fill(cr);
+                    }
+                }
+            }
+
+            void X11CairoSurface::rasterize_frame(frame_t *frame)
+            {
+                if ((frame->ndamage == 0) || (pSurface == NULL))
+                    return;
+
+                if (nBands > 1)
+                    rasterize_tiled(frame);
+                else
+                {
+                    cairo_t *cr = ::cairo_create(pSurface);
+                    if (cr == NULL)
+                        return;
+                    lsp_finally { ::cairo_destroy(cr); };
+
+                    replay_frame(cr, frame, 0);
+                }
+
+                ::cairo_surface_flush(pSurface);
+                present(frame->damage, frame->ndamage, true);
+            }
+
+            void X11CairoSurface::rasterize_tiled(frame_t *frame)
+            {
+                // Compute the vertical span of the damaged area
+                const ssize_t height    = ::cairo_image_surface_get_height(pSurface);
+                ssize_t top             = height;
+                ssize_t bottom          = 0;
+                for (size_t i=0; i<frame->ndamage; ++i)
+                {
+                    const damage_t *d = &frame->damage[i];
+                    top                     = lsp_min(top, d->t);
+                    bottom                  = lsp_max(bottom, d->b);
+                }
+                top                     = lsp_max(top, 0);
+                bottom                  = lsp_min(bottom, height);
+                if (top >= bottom)
+                    return;
+
+                const ssize_t rows      = lsp_max((bottom - top + ssize_t(nBands) - 1) / ssize_t(nBands), ssize_t(BAND_MIN_ROWS));
+
+                // Start the job
+                ::cairo_surface_flush(pSurface);
+                {
+                    sBandLock.lock();
+                    lsp_finally { sBandLock.unlock(); };
+
+                    pBandFrame          = frame;
+                    nBandTop            = top;
+                    nBandBottom         = bottom;
+                    nBandRows           = rows;
+                    nBandPending        = nBands - 1;
+                    ++nBandJob;
+                    sBandLock.notify_all();
+                }
+
+                // Rasterize the first band and wait for other bands
+                rasterize_band(frame, 0);
+                {
+                    sBandLock.lock();
+                    lsp_finally { sBandLock.unlock(); };
+
+                    while (nBandPending > 0)
+                        sBandLock.wait();
+                    pBandFrame          = NULL;
+                }
+
+                // Pixel data has been modified outside of the surface
+                ::cairo_surface_mark_dirty(pSurface);
+            }
+
+            void X11CairoSurface::rasterize_band(const frame_t *frame, size_t index)
+            {
+                const ssize_t top       = nBandTop + ssize_t(index) * nBandRows;
+                const ssize_t bottom    = lsp_min(top + nBandRows, nBandBottom);
+                if (top >= bottom)
+                    return;
+
+                // Create surface that shares the rows of the band with the surface
+                uint8_t *data           = ::cairo_image_surface_get_data(pSurface);
+                if (data == NULL)
+                    return;
+                const ssize_t stride    = ::cairo_image_surface_get_stride(pSurface);
+                const ssize_t width     = ::cairo_image_surface_get_width(pSurface);
+
+                cairo_surface_t *band   = ::cairo_image_surface_create_for_data(
+                    &data[top * stride], ::cairo_image_surface_get_format(pSurface), width, bottom - top, stride);
+                lsp_finally { ::cairo_surface_destroy(band); };
+                if (::cairo_surface_status(band) != CAIRO_STATUS_SUCCESS)
+                    return;
+                ::cairo_surface_set_device_offset(band, 0.0, -top);
+
+                cairo_t *cr             = ::cairo_create(band);
+                lsp_finally { ::cairo_destroy(cr); };
+                if (::cairo_status(cr) != CAIRO_STATUS_SUCCESS)
+                    return;
+
+                // Band boundaries are pixel-aligned, so the output matches single-threaded rasterization
+                ::cairo_rectangle(cr, 0, top, width, bottom - top);
+                ::cairo_clip(cr);
+                replay_frame(cr, frame, index);
+            }
+
+            status_t X11CairoSurface::band_proc(void *arg)
+            {
+                band_t *b = static_cast<band_t *>(arg);
+                return b->self->band_main(b->index);
+            }
+
+            status_t X11CairoSurface::band_main(size_t index)
+            {
+                size_t job          = 0;
+
+                while (true)
+                {
+                    // Wait for the new job
+                    const frame_t *frame = NULL;
+                    {
+                        sBandLock.lock();
+                        lsp_finally { sBandLock.unlock(); };
+
+                        while ((nBandJob == job) && (!bBandStop))
+                            sBandLock.wait();
+                        if (bBandStop)
+                            return STATUS_OK;
+
+                        job                 = nBandJob;
+                        frame               = pBandFrame;
+                    }
+
+                    // Rasterize the band and report completion
+                    rasterize_band(frame, index);
+                    {
+                        sBandLock.lock();
+                        lsp_finally { sBandLock.unlock(); };
+
+                        if ((--nBandPending) == 0)
+                            sBandLock.notify_all();
+                    }
+                }
+            }
+
+            void X11CairoSurface::wait_frames(size_t count)
+            {
+                if (pRasterizer == NULL)
                     return;
 
-                cairo_surface_t *cs = cairo_image_surface_create_for_data(
-                    static_cast<unsigned char *>(const_cast<void *>(data)),
-                    CAIRO_FORMAT_ARGB32,
-                    width, height, stride);
-                if (cs == NULL)
-                    return;
-                lsp_finally { cairo_surface_destroy(cs); };
+                sFrameLock.lock();
+                lsp_finally { sFrameLock.unlock(); };
 
-                // Draw one surface on another
-                ::cairo_save(pCR);
-                lsp_finally { ::cairo_restore(pCR); };
+                while (vFrames.size() > count)
+                    sFrameLock.wait();
+            }
 
-                if ((sx != 1.0f) && (sy != 1.0f))
+            void X11CairoSurface::destroy_frame(frame_t *frame)
+            {
+                for (size_t i=0, n=frame->steps.size(); i<n; ++i)
                 {
-                    if (sx < 0.0f)
-                        x       -= sx * width;
-                    if (sy < 0.0f)
-                        y       -= sy * height;
-
-                    ::cairo_translate(pCR, x, y);
-                    ::cairo_scale(pCR, sx, sy);
-                    ::cairo_set_source_surface(pCR, cs, 0.0f, 0.0f);
+                    step_t *s = frame->steps.uget(i);
+                    for (size_t j=0; j<BANDS_MAX; ++j)
+                    {
+                        if (s->recording[j] != NULL)
+                            ::cairo_surface_destroy(s->recording[j]);
+                    }
                 }
-                else
-                    ::cairo_set_source_surface(pCR, cs, x, y);
-
-                // Draw the surface
-                if (a > 0.0f)
-                    ::cairo_paint_with_alpha(pCR, 1.0f - a);
-                else
-                    ::cairo_paint(pCR);
+                delete frame;
             }
 
-            void X11CairoSurface::begin()
+            bool X11CairoSurface::begin_segment(cairo_antialias_t aa)
             {
-                // Force end() call
-                end();
+                cairo_rectangle_t extents;
+                extents.x           = 0.0;
+                extents.y           = 0.0;
+                extents.width       = nWidth;
+                extents.height      = nHeight;
 
-                // Create cairo objects
-                if (pCR == NULL)
+                // Cairo updates the internal state of the recording surface on each clipped replay,
+                // so each band replays its own copy of the recording
+                for (size_t i=0; i<nBands; ++i)
                 {
-                    if ((pCR = ::cairo_create(pSurface)) == NULL)
-                        return;
+                    vRecording[i]       = ::cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents);
+                    if (::cairo_surface_status(vRecording[i]) != CAIRO_STATUS_SUCCESS)
+                    {
+                        destroy_segment();
+                        return false;
+                    }
                 }
-                if (pFO == NULL)
+
+                // Record drawing commands to all copies at once
+                cairo_surface_t *target = ::cairo_surface_reference(vRecording[0]);
+            #ifdef CAIRO_HAS_TEE_SURFACE
+                if (nBands > 1)
                 {
-                    if ((pFO = ::cairo_font_options_create()) == NULL)
-                        return;
+                    ::cairo_surface_destroy(target);
+                    target              = ::cairo_tee_surface_create(vRecording[0]);
+                    for (size_t i=1; i<nBands; ++i)
+                        ::cairo_tee_surface_add(target, vRecording[i]);
                 }
+            #endif /* CAIRO_HAS_TEE_SURFACE */
 
-                // Initialize settings
-                ::cairo_set_antialias(pCR, CAIRO_ANTIALIAS_FAST);
-                ::cairo_set_line_join(pCR, CAIRO_LINE_JOIN_BEVEL);
-                ::cairo_set_tolerance(pCR, 0.5);
+                pCR                 = ::cairo_create(target);
+                ::cairo_surface_destroy(target);
+                if (::cairo_status(pCR) != CAIRO_STATUS_SUCCESS)
+                {
+                    ::cairo_destroy(pCR);
+                    pCR                 = NULL;
+                    destroy_segment();
+                    return false;
+                }
 
-            #ifdef LSP_DEBUG
-                nNumClips       = 0;
-            #endif /* LSP_DEBUG */
+                setup_context(aa);
+                return true;
             }
 
-            void X11CairoSurface::end()
+            void X11CairoSurface::end_segment()
             {
-                if (pCR == NULL)
+                if (pCR != NULL)
+                {
+                    ::cairo_destroy(pCR);
+                    pCR                 = NULL;
+                }
+                if (vRecording[0] == NULL)
                     return;
 
-            #ifdef LSP_DEBUG
-                if (nNumClips > 0)
-                    lsp_error("Mismatching number of clip_begin() and clip_end() calls");
-            #endif /* LSP_DEBUG */
+                step_t *s           = (pFrame != NULL) ? pFrame->steps.add() : NULL;
+                if (s == NULL)
+                {
+                    destroy_segment();
+                    return;
+                }
 
-                ::cairo_surface_flush(pSurface);
+                for (size_t i=0; i<BANDS_MAX; ++i)
+                {
+                    s->recording[i]     = vRecording[i];
+                    vRecording[i]       = NULL;
+                }
+            }
 
-                // Copy back surface to front surface if it is present
-                if (pRoot != NULL)
+            void X11CairoSurface::destroy_segment()
+            {
+                for (size_t i=0; i<BANDS_MAX; ++i)
                 {
-                    cairo_t *cr = ::cairo_create(pRoot);
-                    if (cr == NULL)
-                        return;
-                    lsp_finally {
-                        cairo_destroy(cr);
-                    };
+                    if (vRecording[i] != NULL)
+                    {
+                        ::cairo_surface_destroy(vRecording[i]);
+                        vRecording[i]       = NULL;
+                    }
+                }
+            }
 
-                    ::cairo_set_source_surface(cr, pSurface, 0, 0);
-                    ::cairo_paint(cr);
-                    ::cairo_surface_flush(pRoot);
+            void X11CairoSurface::clear_async(double r, double g, double b, double a)
+            {
+                // Compute the area to clear, all clipping regions are rectangles
+                double x[2], y[2];
+                ::cairo_clip_extents(pCR, &x[0], &y[0], &x[1], &y[1]);
+                damage_user(x[0], y[0], x[1], y[1]);
+                ::cairo_user_to_device(pCR, &x[0], &y[0]);
+                ::cairo_user_to_device(pCR, &x[1], &y[1]);
+
+                // Clearing can not be replayed from the recording with OVER operator,
+                // so finish current segment and add the clear step
+                const cairo_antialias_t aa = ::cairo_get_antialias(pCR);
+                end_segment();
+
+                step_t *s           = (pFrame != NULL) ? pFrame->steps.add() : NULL;
+                if (s != NULL)
+                {
+                    for (size_t i=0; i<BANDS_MAX; ++i)
+                        s->recording[i]     = NULL;
+                    s->l                = lsp_min(x[0], x[1]);
+                    s->t                = lsp_min(y[0], y[1]);
+                    s->r                = lsp_max(x[0], x[1]);
+                    s->b                = lsp_max(y[0], y[1]);
+                    s->color[0]         = r;
+                    s->color[1]         = g;
+                    s->color[2]         = b;
+                    s->color[3]         = a;
                 }
+
+                begin_segment(aa);
             }
 
             void X11CairoSurface::set_current_font(font_context_t *ctx, const Font &f)
@@ -383,6 +1606,15 @@ namespace lsp
             {
                 if (pCR == NULL)
                     return;
+                if (pRasterizer != NULL)
+                {
+                    clear_async(
+                        float((rgb >> 16) & 0xff) * k_color,
+                        float((rgb >> 8) & 0xff) * k_color,
+                        float(rgb & 0xff) * k_color,
+                        0.0f);
+                    return;
+                }
 
                 cairo_operator_t op = cairo_get_operator(pCR);
                 ::cairo_set_operator (pCR, CAIRO_OPERATOR_SOURCE);
@@ -392,7 +1624,7 @@ namespace lsp
                     float(rgb & 0xff) * k_color,
                     0.0f
                 );
-                ::cairo_paint(pCR);
+                paint();
                 ::cairo_set_operator (pCR, op);
             }
 
@@ -400,6 +1632,15 @@ namespace lsp
             {
                 if (pCR == NULL)
                     return;
+                if (pRasterizer != NULL)
+                {
+                    clear_async(
+                        float((rgba >> 16) & 0xff) * k_color,
+                        float((rgba >> 8) & 0xff) * k_color,
+                        float(rgba & 0xff) * k_color,
+                        float((rgba >> 24) & 0xff) * k_color);
+                    return;
+                }
 
                 cairo_operator_t op = cairo_get_operator(pCR);
                 ::cairo_set_operator (pCR, CAIRO_OPERATOR_SOURCE);
@@ -409,7 +1650,7 @@ namespace lsp
                     float(rgba & 0xff) * k_color,
                     float((rgba >> 24) & 0xff) * k_color
                 );
-                ::cairo_paint(pCR);
+                paint();
                 ::cairo_set_operator (pCR, op);
             }
 
@@ -435,11 +1676,18 @@ namespace lsp
             {
                 if (pCR == NULL)
                     return;
+                if (pRasterizer != NULL)
+                {
+                    float r, g, b, o;
+                    color.get_rgbo(r, g, b, o);
+                    clear_async(r, g, b, o);
+                    return;
+                }
 
                 setSourceRGBA(color);
                 cairo_operator_t op = ::cairo_get_operator(pCR);
                 ::cairo_set_operator (pCR, CAIRO_OPERATOR_SOURCE);
-                ::cairo_paint(pCR);
+                paint();
                 ::cairo_set_operator (pCR, op);
             }
 
@@ -494,7 +1742,7 @@ namespace lsp
                 cairo_set_line_width(pCR, line_width);
                 drawRoundRect(left + lw2, top + lw2, width - line_width, height - line_width, radius, mask);
 
-                cairo_stroke(pCR);
+                stroke_path();
                 cairo_set_line_width(pCR, w);
                 cairo_set_line_join(pCR, j);
             }
@@ -513,7 +1761,7 @@ namespace lsp
                 cairo_set_line_width(pCR, line_width);
                 drawRoundRect(r->nLeft+ lw2, r->nTop + lw2, r->nWidth - line_width, r->nHeight - line_width, radius, mask);
 
-                cairo_stroke(pCR);
+                stroke_path();
                 cairo_set_line_width(pCR, w);
                 cairo_set_line_join(pCR, j);
             }
@@ -533,7 +1781,7 @@ namespace lsp
                 cg->apply(pCR);
                 drawRoundRect(r->nLeft + lw2, r->nTop + lw2, r->nWidth - line_width, r->nHeight - line_width, radius, mask);
 
-                cairo_stroke(pCR);
+                stroke_path();
                 cairo_set_line_width(pCR, w);
                 cairo_set_line_join(pCR, j);
             }
@@ -554,28 +1802,285 @@ namespace lsp
                 cg->apply(pCR);
                 drawRoundRect(left + lw2, top + lw2, width - line_width, height - line_width, radius, mask);
 
-                cairo_stroke(pCR);
+                stroke_path();
                 cairo_set_line_width(pCR, w);
                 cairo_set_line_join(pCR, j);
             }
 
+            static inline void fill_pixels(uint32_t *dst, uint32_t pixel, size_t count)
+            {
+                for (size_t i=0; i<count; ++i)
+                    dst[i]          = pixel;
+            }
+
+            static inline uint32_t color_component(double c, size_t shift)
+            {
+                // Same conversion as cairo does: double to 16-bit and then to 8-bit value
+                return (uint32_t(lsp_limit(c, 0.0, 1.0) * 65535.0 + 0.5) >> 8) << shift;
+            }
+
+            bool X11CairoSurface::direct_clip(damage_t *clip, size_t *count, double *dx, double *dy)
+            {
+                // Direct access is possible only for ARGB32 image surface in synchronous mode
+                if (pRasterizer != NULL)
+                    return false;
+                if ((::cairo_surface_get_type(pSurface) != CAIRO_SURFACE_TYPE_IMAGE) ||
+                    (::cairo_image_surface_get_format(pSurface) != CAIRO_FORMAT_ARGB32))
+                    return false;
+
+                // The transformation should be a translation
+                cairo_matrix_t m;
+                ::cairo_get_matrix(pCR, &m);
+                if ((m.xx != 1.0) || (m.yy != 1.0) || (m.xy != 0.0) || (m.yx != 0.0))
+                    return false;
+
+                // The clipping region should be a set of pixel-aligned rectangles
+                cairo_rectangle_list_t *list = ::cairo_copy_clip_rectangle_list(pCR);
+                if (list == NULL)
+                    return false;
+                lsp_finally { ::cairo_rectangle_list_destroy(list); };
+                if ((list->status != CAIRO_STATUS_SUCCESS) || (list->num_rectangles > ssize_t(DAMAGE_MAX)))
+                    return false;
+
+                const ssize_t sw    = ::cairo_image_surface_get_width(pSurface);
+                const ssize_t sh    = ::cairo_image_surface_get_height(pSurface);
+                size_t n            = 0;
+
+                for (ssize_t i=0; i<list->num_rectangles; ++i)
+                {
+                    const cairo_rectangle_t *c = &list->rectangles[i];
+                    const double l      = c->x + m.x0;
+                    const double t      = c->y + m.y0;
+                    const double r      = l + c->width;
+                    const double b      = t + c->height;
+                    if ((l != floor(l)) || (t != floor(t)) || (r != floor(r)) || (b != floor(b)))
+                        return false;
+
+                    damage_t *d         = &clip[n];
+                    d->l                = lsp_max(ssize_t(l), ssize_t(0));
+                    d->t                = lsp_max(ssize_t(t), ssize_t(0));
+                    d->r                = lsp_min(ssize_t(r), sw);
+                    d->b                = lsp_min(ssize_t(b), sh);
+                    if ((d->l < d->r) && (d->t < d->b))
+                        ++n;
+                }
+
+                *count              = n;
+                *dx                 = m.x0;
+                *dy                 = m.y0;
+
+                return true;
+            }
+
+            bool X11CairoSurface::fill_rect_fast(const Color &color, size_t mask, float radius, float left, float top, float width, float height)
+            {
+                // Only opaque rectangles without rounded corners
+                if ((radius > 0.0f) && (mask & SURFMASK_ALL_CORNER))
+                    return false;
+                if ((width <= 0.0f) || (height <= 0.0f))
+                    return false;
+
+                float r, g, b, o;
+                color.get_rgbo(r, g, b, o);
+                if (o < 1.0f)
+                    return false;
+
+                const cairo_operator_t op = ::cairo_get_operator(pCR);
+                if ((op != CAIRO_OPERATOR_OVER) && (op != CAIRO_OPERATOR_SOURCE))
+                    return false;
+
+                damage_t clip[DAMAGE_MAX];
+                size_t nclip;
+                double dx, dy;
+                if (!direct_clip(clip, &nclip, &dx, &dy))
+                    return false;
+
+                // The rectangle should be pixel-aligned
+                const double fl     = left + dx;
+                const double ftop   = top + dy;
+                const double fr     = fl + width;
+                const double fb     = ftop + height;
+                if ((fl != floor(fl)) || (ftop != floor(ftop)) || (fr != floor(fr)) || (fb != floor(fb)))
+                    return false;
+
+                // Fill the image data directly
+                const uint32_t pixel    =
+                    0xff000000 | color_component(r, 16) | color_component(g, 8) | color_component(b, 0);
+                const ssize_t stride    = ::cairo_image_surface_get_stride(pSurface);
+
+                ::cairo_surface_flush(pSurface);
+                uint8_t *data           = ::cairo_image_surface_get_data(pSurface);
+                if (data == NULL)
+                    return false;
+
+                for (size_t i=0; i<nclip; ++i)
+                {
+                    const damage_t *c   = &clip[i];
+                    const ssize_t dl    = lsp_max(ssize_t(fl), c->l);
+                    const ssize_t dt    = lsp_max(ssize_t(ftop), c->t);
+                    const ssize_t dr    = lsp_min(ssize_t(fr), c->r);
+                    const ssize_t db    = lsp_min(ssize_t(fb), c->b);
+                    if ((dl >= dr) || (dt >= db))
+                        continue;
+
+                    for (ssize_t y=dt; y<db; ++y)
+                        fill_pixels(reinterpret_cast<uint32_t *>(&data[y * stride]) + dl, pixel, dr - dl);
+
+                    ::cairo_surface_mark_dirty_rectangle(pSurface, dl, dt, dr - dl, db - dt);
+                    damage(dl, dt, dr - dl, db - dt);
+                }
+
+                return true;
+            }
+
+        #ifdef USE_LIBFREETYPE
+            bool X11CairoSurface::glyphs_overlap(const ft::GlyphRun *run)
+            {
+                // Glyph bitmaps are placed from left to right, so it is enough to compare
+                // each bitmap with the right edge of all previous bitmaps
+                const ft::glyph_pos_t *vp   = run->glyphs();
+                ssize_t right               = 0;
+                bool found                  = false;
+
+                for (size_t i=0, n=run->size(); i<n; ++i)
+                {
+                    const ft::glyph_pos_t *pos  = &vp[i];
+                    const dsp::bitmap_t *bm     = &pos->glyph->bitmap;
+                    if ((bm->width <= 0) || (bm->height <= 0))
+                        continue;
+
+                    if ((found) && (pos->x < right))
+                        return true;
+                    right                       = (found) ? lsp_max(right, pos->x + bm->width) : pos->x + bm->width;
+                    found                       = true;
+                }
+
+                return false;
+            }
+
+            void X11CairoSurface::draw_glyph(void *arg, const ft::glyph_t *glyph, ssize_t x, ssize_t y)
+            {
+                glyph_run_t *run        = static_cast<glyph_run_t *>(arg);
+                const dsp::bitmap_t *bm = &glyph->bitmap;
+                const ssize_t gl        = run->x + x;
+                const ssize_t gt        = run->y + y;
+                const ssize_t gr        = gl + bm->width;
+                const ssize_t gb        = gt + bm->height;
+
+                for (size_t i=0; i<run->nclip; ++i)
+                {
+                    const damage_t *c       = &run->clip[i];
+                    const ssize_t l         = lsp_max(gl, c->l);
+                    const ssize_t t         = lsp_max(gt, c->t);
+                    const ssize_t r         = lsp_min(gr, c->r);
+                    const ssize_t b         = lsp_min(gb, c->b);
+                    if ((l >= r) || (t >= b))
+                        continue;
+
+                    ft::blend_glyph(run->data, run->stride, glyph, gl, gt, l, t, r, b, run->color);
+
+                    // Update bounds of the modified area
+                    damage_t *d             = &run->bounds;
+                    if (d->l < d->r)
+                    {
+                        d->l                    = lsp_min(d->l, l);
+                        d->t                    = lsp_min(d->t, t);
+                        d->r                    = lsp_max(d->r, r);
+                        d->b                    = lsp_max(d->b, b);
+                    }
+                    else
+                    {
+                        d->l                    = l;
+                        d->t                    = t;
+                        d->r                    = r;
+                        d->b                    = b;
+                    }
+                }
+            }
+
+            bool X11CairoSurface::out_glyphs(
+                ft::FontManager *mgr, const Font &f, const Color &color, float x, float y,
+                ft::text_range_t *tr, const LSPString *text, ssize_t first, ssize_t last)
+            {
+                if (::cairo_get_operator(pCR) != CAIRO_OPERATOR_OVER)
+                    return false;
+
+                glyph_run_t run;
+                double dx, dy;
+                if (!direct_clip(run.clip, &run.nclip, &dx, &dy))
+                    return false;
+
+                // Glyphs are composited without resampling, so the origin should be pixel-aligned
+                const double ox     = x + dx;
+                const double oy     = y + dy;
+                if ((ox != floor(ox)) || (oy != floor(oy)))
+                    return false;
+
+                // Each glyph is blended separately while the text bitmap takes the maximum coverage
+                // of overlapping glyphs, so the text with overlapping glyphs is drawn as text bitmap
+                if (!mgr->layout_text(&f, &sGlyphRun, text, first, last))
+                    return false;
+                if (glyphs_overlap(&sGlyphRun))
+                    return false;
+
+                ::cairo_surface_flush(pSurface);
+                run.data            = ::cairo_image_surface_get_data(pSurface);
+                if (run.data == NULL)
+                    return false;
+                run.stride          = ::cairo_image_surface_get_stride(pSurface);
+                run.x               = ssize_t(ox);
+                run.y               = ssize_t(oy);
+                run.bounds.l        = 0;
+                run.bounds.t        = 0;
+                run.bounds.r        = 0;
+                run.bounds.b        = 0;
+
+                // Same conversion as cairo does for the solid source
+                float r, g, b, o;
+                color.get_rgbo(r, g, b, o);
+                run.color           =
+                    color_component(o, 24) |
+                    color_component(double(r) * double(o), 16) |
+                    color_component(double(g) * double(o), 8) |
+                    color_component(double(b) * double(o), 0);
+
+                if (tr != NULL)
+                    *tr                 = *sGlyphRun.range();
+                const bool res      = mgr->render_glyphs(&sGlyphRun, draw_glyph, &run);
+
+                // Commit the modified area
+                const damage_t *d   = &run.bounds;
+                if (d->l >= d->r)
+                    return res;
+
+                ::cairo_surface_mark_dirty_rectangle(pSurface, d->l, d->t, d->r - d->l, d->b - d->t);
+                damage(d->l, d->t, d->r - d->l, d->b - d->t);
+
+                return true;
+            }
+        #endif /* USE_LIBFREETYPE */
+
             void X11CairoSurface::fill_rect(const Color &color, size_t mask, float radius, float left, float top, float width, float height)
             {
                 if (pCR == NULL)
                     return;
+                if (fill_rect_fast(color, mask, radius, left, top, width, height))
+                    return;
 
                 setSourceRGBA(color);
                 drawRoundRect(left, top, width, height, radius, mask);
-                cairo_fill(pCR);
+                fill_path();
             }
 
             void X11CairoSurface::fill_rect(const Color &color, size_t mask, float radius, const ws::rectangle_t *r)
             {
                 if (pCR == NULL)
                     return;
+                if (fill_rect_fast(color, mask, radius, r->nLeft, r->nTop, r->nWidth, r->nHeight))
+                    return;
                 setSourceRGBA(color);
                 drawRoundRect(r->nLeft, r->nTop, r->nWidth, r->nHeight, radius, mask);
-                cairo_fill(pCR);
+                fill_path();
             }
 
             void X11CairoSurface::fill_rect(IGradient *g, size_t mask, float radius, float left, float top, float width, float height)
@@ -586,7 +2091,7 @@ namespace lsp
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(g);
                 cg->apply(pCR);
                 drawRoundRect(left, top, width, height, radius, mask);
-                cairo_fill(pCR);
+                fill_path();
             }
 
             void X11CairoSurface::fill_rect(IGradient *g, size_t mask, float radius, const ws::rectangle_t *r)
@@ -597,7 +2102,7 @@ namespace lsp
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(g);
                 cg->apply(pCR);
                 drawRoundRect(r->nLeft, r->nTop, r->nWidth, r->nHeight, radius, mask);
-                cairo_fill(pCR);
+                fill_path();
             }
 
             void X11CairoSurface::fill_rect(ISurface *s, float alpha, size_t mask, float radius, float left, float top, float width, float height)
@@ -611,6 +2116,7 @@ namespace lsp
                 X11CairoSurface *cs = static_cast<X11CairoSurface *>(s);
                 if (cs->pSurface == NULL)
                     return;
+                cs->wait_frames(0);
 
                 // Draw one surface on another
                 ::cairo_save(pCR);
@@ -637,7 +2143,7 @@ namespace lsp
                 ::cairo_set_source(pCR, p);
                 drawRoundRect(left, top, width, height, radius, mask);
                 ::cairo_clip(pCR);
-                ::cairo_paint_with_alpha(pCR, 1.0f - alpha);
+                paint_with_alpha(1.0f - alpha);
             }
 
             void X11CairoSurface::fill_rect(ISurface *s, float alpha, size_t mask, float radius, const ws::rectangle_t *r)
@@ -663,7 +2169,7 @@ namespace lsp
                 else
                     cairo_arc(pCR, x, y, r, 0.0f, M_PI * 2.0f);
                 cairo_close_path(pCR);
-                cairo_fill(pCR);
+                fill_path();
             }
 
             void X11CairoSurface::fill_triangle(IGradient *g, float x0, float y0, float x1, float y1, float x2, float y2)
@@ -677,7 +2183,7 @@ namespace lsp
                 cairo_line_to(pCR, x1, y1);
                 cairo_line_to(pCR, x2, y2);
                 cairo_close_path(pCR);
-                cairo_fill(pCR);
+                fill_path();
             }
 
             void X11CairoSurface::fill_triangle(const Color &c, float x0, float y0, float x1, float y1, float x2, float y2)
@@ -690,7 +2196,7 @@ namespace lsp
                 cairo_line_to(pCR, x1, y1);
                 cairo_line_to(pCR, x2, y2);
                 cairo_close_path(pCR);
-                cairo_fill(pCR);
+                fill_path();
             }
 
             bool X11CairoSurface::get_font_parameters(const Font &f, font_parameters_t *fp)
@@ -859,7 +2365,27 @@ namespace lsp
                     if (!tmp.set_utf8(text))
                         return;
 
+                    // Composite glyphs directly into the surface if possible
                     ft::text_range_t tr;
+                    if (out_glyphs(mgr, f, color, x, y, &tr, &tmp, 0, tmp.length()))
+                    {
+                        // Draw underline if required
+                        if (f.is_underline())
+                        {
+                            const float width   = lsp_max(1.0f, f.get_size() / 12.0f);
+                            const float sx      = x + tr.x_bearing;
+                            const float bottom  = y + width * 1.5f;
+
+                            setSourceRGBA(color);
+                            cairo_set_line_width(pCR, width);
+                            cairo_move_to(pCR, sx, bottom);
+                            cairo_line_to(pCR, sx + tr.x_advance, bottom);
+                            stroke_path();
+                        }
+
+                        return;
+                    }
+
                     dsp::bitmap_t *bitmap   = mgr->render_text(&f, &tr, &tmp, 0, tmp.length());
                     if (bitmap != NULL)
                     {
@@ -879,7 +2405,7 @@ namespace lsp
                         setSourceRGBA(color);
                         const float sx  = x + tr.x_bearing;
                         const float sy  = y + tr.y_bearing;
-                        cairo_mask_surface(pCR, fs, sx, sy);
+                        mask_surface(fs, sx, sy);
 
                         // Draw underline if required
                         if (f.is_underline())
@@ -890,7 +2416,7 @@ namespace lsp
                             cairo_set_line_width(pCR, width);
                             cairo_move_to(pCR, sx, bottom);
                             cairo_line_to(pCR, sx + tr.x_advance, bottom);
-                            cairo_stroke(pCR);
+                            stroke_path();
                         }
 
                         return;
@@ -906,7 +2432,7 @@ namespace lsp
                 // Draw
                 cairo_move_to(pCR, x, y);
                 setSourceRGBA(color);
-                cairo_show_text(pCR, text);
+                show_text(text);
 
                 // Draw underline if required
                 if (f.is_underline())
@@ -919,7 +2445,7 @@ namespace lsp
 
                     cairo_move_to(pCR, x, y + te.y_advance + 1 + width);
                     cairo_line_to(pCR, x + te.x_advance, y + te.y_advance + 1 + width);
-                    cairo_stroke(pCR);
+                    stroke_path();
                 }
             }
 
@@ -932,7 +2458,27 @@ namespace lsp
                 ft::FontManager *mgr = pDisplay->font_manager();
                 if (mgr != NULL)
                 {
+                    // Composite glyphs directly into the surface if possible
                     ft::text_range_t tr;
+                    if (out_glyphs(mgr, f, color, x, y, &tr, text, first, last))
+                    {
+                        // Draw underline if required
+                        if (f.is_underline())
+                        {
+                            const float width   = lsp_max(1.0f, f.get_size() / 12.0f);
+                            const float sx      = x + tr.x_bearing;
+                            const float bottom  = y + width * 1.5f;
+
+                            setSourceRGBA(color);
+                            cairo_set_line_width(pCR, width);
+                            cairo_move_to(pCR, sx, bottom);
+                            cairo_line_to(pCR, sx + tr.x_advance, bottom);
+                            stroke_path();
+                        }
+
+                        return;
+                    }
+
                     dsp::bitmap_t *bitmap   = mgr->render_text(&f, &tr, text, first, last);
                     if (bitmap != NULL)
                     {
@@ -952,7 +2498,7 @@ namespace lsp
                         setSourceRGBA(color);
                         const float sx = x + tr.x_bearing;
                         const float sy = y + tr.y_bearing;
-                        cairo_mask_surface(pCR, fs, sx, sy);
+                        mask_surface(fs, sx, sy);
 
                         // Draw underline if required
                         if (f.is_underline())
@@ -963,7 +2509,7 @@ namespace lsp
                             cairo_set_line_width(pCR, width);
                             cairo_move_to(pCR, sx, bottom);
                             cairo_line_to(pCR, sx + tr.x_advance, bottom);
-                            cairo_stroke(pCR);
+                            stroke_path();
                         }
 
                         return;
@@ -983,7 +2529,7 @@ namespace lsp
                 // Draw
                 cairo_move_to(pCR, x, y);
                 setSourceRGBA(color);
-                cairo_show_text(pCR, utf8_text);
+                show_text(utf8_text);
 
                 // Draw underline if required
                 if (f.is_underline())
@@ -996,7 +2542,7 @@ namespace lsp
 
                     cairo_move_to(pCR, x, y + te.y_advance + 1 + width);
                     cairo_line_to(pCR, x + te.x_advance, y + te.y_advance + 1 + width);
-                    cairo_stroke(pCR);
+                    stroke_path();
                 }
             }
 
@@ -1015,7 +2561,33 @@ namespace lsp
                     if (!tmp.set_utf8(text))
                         return;
 
+                    // Composite glyphs directly into the surface if possible
                     ft::text_range_t tr;
+                    if (mgr->get_text_parameters(&f, &tr, &tmp, 0, tmp.length()))
+                    {
+                        r_w   = tr.x_advance;
+                        r_h   = -tr.y_bearing;
+                        fx    = truncf(x - tr.x_bearing - r_w * 0.5f + (r_w + 4.0f) * 0.5f * dx);
+                        fy    = truncf(y + r_h * 0.5f - (r_h + 4.0f) * 0.5f * dy);
+                        if (out_glyphs(mgr, f, color, fx, fy, NULL, &tmp, 0, tmp.length()))
+                        {
+                            // Draw underline if required
+                            if (f.is_underline())
+                            {
+                                const float width   = lsp_max(1.0f, f.get_size() / 12.0f);
+                                const float bottom  = fy + width * 1.5f;
+
+                                setSourceRGBA(color);
+                                cairo_set_line_width(pCR, width);
+                                cairo_move_to(pCR, fx, bottom);
+                                cairo_line_to(pCR, fx + tr.x_advance, bottom);
+                                stroke_path();
+                            }
+
+                            return;
+                        }
+                    }
+
                     dsp::bitmap_t *bitmap   = mgr->render_text(&f, &tr, &tmp, 0, tmp.length());
                     if (bitmap != NULL)
                     {
@@ -1037,7 +2609,7 @@ namespace lsp
                         r_h   = -tr.y_bearing;
                         fx    = truncf(x - tr.x_bearing - r_w * 0.5f + (r_w + 4.0f) * 0.5f * dx);
                         fy    = truncf(y + r_h * 0.5f - (r_h + 4.0f) * 0.5f * dy);
-                        cairo_mask_surface(pCR, fs, fx + tr.x_bearing, fy + tr.y_bearing);
+                        mask_surface(fs, fx + tr.x_bearing, fy + tr.y_bearing);
 
                         // Draw underline if required
                         if (f.is_underline())
@@ -1048,7 +2620,7 @@ namespace lsp
                             cairo_set_line_width(pCR, width);
                             cairo_move_to(pCR, fx, bottom);
                             cairo_line_to(pCR, fx + tr.x_advance, bottom);
-                            cairo_stroke(pCR);
+                            stroke_path();
                         }
 
                         return;
@@ -1072,7 +2644,7 @@ namespace lsp
 
                 setSourceRGBA(color);
                 cairo_move_to(pCR, fx, fy);
-                cairo_show_text(pCR, text);
+                show_text(text);
 
                 // Draw underline if required
                 if (f.is_underline())
@@ -1082,7 +2654,7 @@ namespace lsp
                     cairo_set_line_width(pCR, width);
                     cairo_move_to(pCR, fx, fy + te.y_advance + 1 + width);
                     cairo_line_to(pCR, fx + te.x_advance, fy + te.y_advance + 1 + width);
-                    cairo_stroke(pCR);
+                    stroke_path();
                 }
             }
 
@@ -1097,7 +2669,33 @@ namespace lsp
                 ft::FontManager *mgr = pDisplay->font_manager();
                 if (mgr != NULL)
                 {
+                    // Composite glyphs directly into the surface if possible
                     ft::text_range_t tr;
+                    if (mgr->get_text_parameters(&f, &tr, text, first, last))
+                    {
+                        r_w   = tr.x_advance;
+                        r_h   = -tr.y_bearing;
+                        fx    = truncf(x - tr.x_bearing - r_w * 0.5f + (r_w + 4.0f) * 0.5f * dx);
+                        fy    = truncf(y + r_h * 0.5f - (r_h + 4.0f) * 0.5f * dy);
+                        if (out_glyphs(mgr, f, color, fx, fy, NULL, text, first, last))
+                        {
+                            // Draw underline if required
+                            if (f.is_underline())
+                            {
+                                const float width   = lsp_max(1.0f, f.get_size() / 12.0f);
+                                const float bottom  = fy + width * 1.5f;
+
+                                setSourceRGBA(color);
+                                cairo_set_line_width(pCR, width);
+                                cairo_move_to(pCR, fx, bottom);
+                                cairo_line_to(pCR, fx + tr.x_advance, bottom);
+                                stroke_path();
+                            }
+
+                            return;
+                        }
+                    }
+
                     dsp::bitmap_t *bitmap   = mgr->render_text(&f, &tr, text, first, last);
                     if (bitmap != NULL)
                     {
@@ -1119,7 +2717,7 @@ namespace lsp
                         r_h   = -tr.y_bearing;
                         fx    = truncf(x - tr.x_bearing - r_w * 0.5f + (r_w + 4.0f) * 0.5f * dx);
                         fy    = truncf(y + r_h * 0.5f - (r_h + 4.0f) * 0.5f * dy);
-                        cairo_mask_surface(pCR, fs, fx + tr.x_bearing, fy + tr.y_bearing);
+                        mask_surface(fs, fx + tr.x_bearing, fy + tr.y_bearing);
 
                         // Draw underline if required
                         if (f.is_underline())
@@ -1130,7 +2728,7 @@ namespace lsp
                             cairo_set_line_width(pCR, width);
                             cairo_move_to(pCR, fx, bottom);
                             cairo_line_to(pCR, fx + tr.x_advance, bottom);
-                            cairo_stroke(pCR);
+                            stroke_path();
                         }
 
                         return;
@@ -1158,7 +2756,7 @@ namespace lsp
 
                 setSourceRGBA(color);
                 cairo_move_to(pCR, fx, fy);
-                cairo_show_text(pCR, utf8_text);
+                show_text(utf8_text);
 
                 // Draw underline if required
                 if (f.is_underline())
@@ -1168,7 +2766,7 @@ namespace lsp
                     cairo_set_line_width(pCR, width);
                     cairo_move_to(pCR, fx, fy + te.y_advance + 1 + width);
                     cairo_line_to(pCR, fx + te.x_advance, fy + te.y_advance + 1 + width);
-                    cairo_stroke(pCR);
+                    stroke_path();
                 }
             }
 
@@ -1182,7 +2780,7 @@ namespace lsp
                 cairo_set_line_width(pCR, width);
                 cairo_move_to(pCR, x0, y0);
                 cairo_line_to(pCR, x1, y1);
-                cairo_stroke(pCR);
+                stroke_path();
                 cairo_set_line_width(pCR, ow);
             }
 
@@ -1198,7 +2796,7 @@ namespace lsp
                 cairo_set_line_width(pCR, width);
                 cairo_move_to(pCR, x0, y0);
                 cairo_line_to(pCR, x1, y1);
-                cairo_stroke(pCR);
+                stroke_path();
                 cairo_set_line_width(pCR, ow);
             }
 
@@ -1222,7 +2820,7 @@ namespace lsp
                     cairo_line_to(pCR, nWidth, -(c + a*nWidth)/b);
                 }
 
-                cairo_stroke(pCR);
+                stroke_path();
                 cairo_set_line_width(pCR, ow);
             }
 
@@ -1246,7 +2844,7 @@ namespace lsp
                     cairo_line_to(pCR, roundf(right), roundf(-(c + a*right)/b));
                 }
 
-                cairo_stroke(pCR);
+                stroke_path();
                 cairo_set_line_width(pCR, ow);
             }
 
@@ -1284,7 +2882,7 @@ namespace lsp
                 }
 
                 cairo_close_path(pCR);
-                cairo_fill(pCR);
+                fill_path();
             }
 
             void X11CairoSurface::wire_arc(const Color &c, float x, float y, float r, float a1, float a2, float width)
@@ -1302,7 +2900,7 @@ namespace lsp
                     cairo_arc_negative(pCR, x, y, r, a1, a2);
                 else
                     cairo_arc(pCR, x, y, r, a1, a2);
-                cairo_stroke(pCR);
+                stroke_path();
                 cairo_set_line_width(pCR, ow);
             }
 
@@ -1316,7 +2914,7 @@ namespace lsp
                     cairo_line_to(pCR, x[i], y[i]);
 
                 setSourceRGBA(color);
-                cairo_fill(pCR);
+                fill_path();
             }
 
             void X11CairoSurface::fill_poly(IGradient *gr, const float *x, const float *y, size_t n)
@@ -1330,7 +2928,7 @@ namespace lsp
 
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(gr);
                 cg->apply(pCR);
-                cairo_fill(pCR);
+                fill_path();
             }
 
             void X11CairoSurface::wire_poly(const Color & color, float width, const float *x, const float *y, size_t n)
@@ -1338,13 +2936,31 @@ namespace lsp
                 if ((pCR == NULL) || (n < 2))
                     return;
 
+                // Decimate dense polyline so the stroking cost depends on the number of pixel columns
+                float *buf = NULL;
+                lsp_finally {
+                    if (buf != NULL)
+                        free(buf);
+                };
+                if (ws::need_decimation(x, n))
+                {
+                    buf         = static_cast<float *>(malloc(n * 2 * sizeof(float)));
+                    if (buf != NULL)
+                    {
+                        float *dy   = &buf[n];
+                        n           = ws::decimate_poly(buf, dy, x, y, n);
+                        x           = buf;
+                        y           = dy;
+                    }
+                }
+
                 cairo_move_to(pCR, x[0], y[0]);
                 for (size_t i=1; i < n; ++i)
                     cairo_line_to(pCR, x[i], y[i]);
 
                 setSourceRGBA(color);
                 cairo_set_line_width(pCR, width);
-                cairo_stroke(pCR);
+                stroke_path();
             }
 
             void X11CairoSurface::draw_poly(const Color &fill, const Color &wire, float width, const float *x, const float *y, size_t n)
@@ -1359,16 +2975,16 @@ namespace lsp
                 if (width > 0.0f)
                 {
                     setSourceRGBA(fill);
-                    cairo_fill_preserve(pCR);
+                    fill_path_preserve();
 
                     cairo_set_line_width(pCR, width);
                     setSourceRGBA(wire);
-                    cairo_stroke(pCR);
+                    stroke_path();
                 }
                 else
                 {
                     setSourceRGBA(fill);
-                    cairo_fill(pCR);
+                    fill_path();
                 }
             }
 
@@ -1379,7 +2995,7 @@ namespace lsp
 
                 setSourceRGBA(c);
                 cairo_arc(pCR, x, y, r, 0.0f, M_PI * 2.0f);
-                cairo_fill(pCR);
+                fill_path();
             }
 
             void X11CairoSurface::fill_circle(IGradient *g, float x, float y, float r)
@@ -1390,7 +3006,7 @@ namespace lsp
                 X11CairoGradient *cg = static_cast<X11CairoGradient *>(g);
                 cg->apply(pCR);
                 cairo_arc(pCR, x, y, r, 0, M_PI * 2.0f);
-                cairo_fill(pCR);
+                fill_path();
             }
 
             void X11CairoSurface::fill_frame(
@@ -1409,7 +3025,7 @@ namespace lsp
                 {
                     setSourceRGBA(color);
                     cairo_rectangle(pCR, fx, fy, fw, fh);
-                    cairo_fill(pCR);
+                    fill_path();
                     return;
                 }
                 else if ((ix <= fx) && (ixe >= fxe) && (iy <= fy) && (iye >= fye))
@@ -1421,25 +3037,25 @@ namespace lsp
                     if (iy <= fy)
                     {
                         cairo_rectangle(pCR, ixe, fy, fxe - ixe, iye - fy);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, fx, iye, fw, fye - iye);
-                        cairo_fill(pCR);
+                        fill_path();
                     }
                     else if (iye >= fye)
                     {
                         cairo_rectangle(pCR, fx, fy, fw, iy - fy);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, ixe, iy, fxe - ixe, fye - iy);
-                        cairo_fill(pCR);
+                        fill_path();
                     }
                     else
                     {
                         cairo_rectangle(pCR, fx, fy, fw, iy - fy);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, ixe, iy, fxe - ixe, ih);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, fx, iye, fw, fye - iye);
-                        cairo_fill(pCR);
+                        fill_path();
                     }
                 }
                 else if (ixe >= fxe)
@@ -1447,25 +3063,25 @@ namespace lsp
                     if (iy <= fy)
                     {
                         cairo_rectangle(pCR, fx, fy, ix - fx, iye - fy);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, fx, iye, fw, fye - iye);
-                        cairo_fill(pCR);
+                        fill_path();
                     }
                     else if (iye >= fye)
                     {
                         cairo_rectangle(pCR, fx, fy, fw, iy - fy);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, fx, iy, ix - fx, fye - iy);
-                        cairo_fill(pCR);
+                        fill_path();
                     }
                     else
                     {
                         cairo_rectangle(pCR, fx, fy, fw, iy - fy);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, fx, iy, ix - fx, ih);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, fx, iye, fw, fye - iye);
-                        cairo_fill(pCR);
+                        fill_path();
                     }
                 }
                 else
@@ -1473,31 +3089,31 @@ namespace lsp
                     if (iy <= fy)
                     {
                         cairo_rectangle(pCR, fx, fy, ix - fx, iye - fy);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, ixe, fy, fxe - ixe, iye - fy);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, fx, iye, fw, fye - iye);
-                        cairo_fill(pCR);
+                        fill_path();
                     }
                     else if (iye >= fye)
                     {
                         cairo_rectangle(pCR, fx, fy, fw, iy - fy);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, fx, iy, ix - fx, fye - iy);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, ixe, iy, fxe - ixe, fye - iy);
-                        cairo_fill(pCR);
+                        fill_path();
                     }
                     else
                     {
                         cairo_rectangle(pCR, fx, fy, fw, iy - fy);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, fx, iy, ix - fx, ih);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, ixe, iy, fxe - ixe, ih);
-                        cairo_fill(pCR);
+                        fill_path();
                         cairo_rectangle(pCR, fx, iye, fw, fye - iye);
-                        cairo_fill(pCR);
+                        fill_path();
                     }
                 }
 
@@ -1525,7 +3141,7 @@ namespace lsp
                     cairo_line_to(pCR, ix + radius, iy);
                     cairo_arc_negative(pCR, ix + radius, iy + radius, radius, 1.5*M_PI, 1.0*M_PI);
                     cairo_close_path(pCR);
-                    cairo_fill(pCR);
+                    fill_path();
                 }
                 if (flags & SURFMASK_RT_CORNER)
                 {
@@ -1533,7 +3149,7 @@ namespace lsp
                     cairo_line_to(pCR, ix + iw, iy + radius);
                     cairo_arc_negative(pCR, ix + iw - radius, iy + radius, radius, 2.0*M_PI, 1.5*M_PI);
                     cairo_close_path(pCR);
-                    cairo_fill(pCR);
+                    fill_path();
                 }
                 if (flags & SURFMASK_LB_CORNER)
                 {
@@ -1541,7 +3157,7 @@ namespace lsp
                     cairo_line_to(pCR, ix, iy + ih - radius);
                     cairo_arc_negative(pCR, ix + radius, iy + ih - radius, radius, 1.0*M_PI, 0.5*M_PI);
                     cairo_close_path(pCR);
-                    cairo_fill(pCR);
+                    fill_path();
                 }
                 if (flags & SURFMASK_RB_CORNER)
                 {
@@ -1549,7 +3165,7 @@ namespace lsp
                     cairo_line_to(pCR, ix + iw - radius, iy + ih);
                     cairo_arc_negative(pCR, ix + iw - radius, iy + ih - radius, radius, 0.5*M_PI, 0.0);
                     cairo_close_path(pCR);
-                    cairo_fill(pCR);
+                    fill_path();
                 }
             }
 
@@ -1613,6 +3229,21 @@ namespace lsp
                 cairo_clip(pCR);
                 cairo_new_path(pCR);
 
+                // Remember the clipping region to restore it for the next recording segment
+                if (pRasterizer != NULL)
+                {
+                    clip_t *c = vClips.add();
+                    if (c != NULL)
+                    {
+                        c->x        = x;
+                        c->y        = y;
+                        c->w        = w;
+                        c->h        = h;
+                        c->ox       = fOriginX;
+                        c->oy       = fOriginY;
+                    }
+                }
+
             #ifdef LSP_DEBUG
                 ++nNumClips;
             #endif /* LSP_DEBUG */
@@ -1633,6 +3264,8 @@ namespace lsp
             #endif /* LSP_DEBUG */
 
                 cairo_restore(pCR);
+                if (pRasterizer != NULL)
+                    vClips.pop();
             }
 
         } /* namespace x11 */
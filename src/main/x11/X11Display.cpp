@@ -174,6 +174,11 @@ namespace lsp
                 sSetInputFocusReq.hWnd      = None;
                 sSetInputFocusReq.bSuccess  = false;
 
+                sShmReq.nOpcode         = -1;
+                sShmReq.bChecked        = false;
+                sShmReq.bPending        = false;
+                sShmReq.bSuccess        = false;
+
                 pEstimation     = NULL;
             }
 
@@ -215,6 +220,27 @@ namespace lsp
                     status_t fm_res    = sFontManager.init();
                     if (fm_res != STATUS_OK)
                         return fm_res;
+
+                    // Persistent glyph cache is enabled only on explicit request, the variable
+                    // contains either the absolute path to the cache directory or the flag
+                    // to use the default location in the user's cache directory
+                    LSPString var;
+                    if (system::get_env_var("LSP_WS_LIB_GLYPH_CACHE", &var) == STATUS_OK)
+                    {
+                        io::Path cache_path;
+                        status_t res    = STATUS_NOT_FOUND;
+                        if ((var.equals_ascii_nocase("on")) ||
+                            (var.equals_ascii_nocase("yes")) ||
+                            (var.equals_ascii_nocase("y")) ||
+                            (var.equals_ascii_nocase("enabled")) ||
+                            (var.equals_ascii_nocase("1")))
+                            res             = ft::DiskCache::default_path(&cache_path);
+                        else if ((cache_path.set(&var) == STATUS_OK) && (cache_path.is_absolute()))
+                            res             = STATUS_OK;
+
+                        if ((res == STATUS_OK) && (sFontManager.set_disk_cache(&cache_path) == STATUS_OK))
+                            lsp_trace("Enabled persistent glyph cache at %s", cache_path.as_native());
+                    }
                 }
             #endif /* USE_LIBFREETYPE */
 
@@ -453,6 +479,7 @@ namespace lsp
                     delete pEstimation;
                     pEstimation     = NULL;
                 }
+                sMetrics.clear();
             }
 
             void X11Display::destroy()
@@ -3594,6 +3621,10 @@ namespace lsp
                     if (sSetInputFocusReq.hWnd != None)
                         sSetInputFocusReq.bSuccess = false;
                 }
+
+                // Failed XShmAttach request?
+                if ((sShmReq.bPending) && (ev->request_code == sShmReq.nOpcode))
+                    sShmReq.bSuccess = false;
             }
 
             X11Display::dnd_recv_t *X11Display::current_drag_task()
@@ -3862,6 +3893,53 @@ namespace lsp
                 return sSetInputFocusReq.bSuccess;
             }
 
+            bool X11Display::shm_supported()
+            {
+                if (!sShmReq.bChecked)
+                {
+                    int event = 0, error = 0;
+                    sShmReq.bChecked    = true;
+                    if ((!::XQueryExtension(pDisplay, "MIT-SHM", &sShmReq.nOpcode, &event, &error)) ||
+                        (!::XShmQueryExtension(pDisplay)))
+                        sShmReq.nOpcode     = -1;
+
+                    lsp_trace("this=%p: MIT-SHM extension is %s", this, (sShmReq.nOpcode >= 0) ? "available" : "not available");
+                }
+
+                return sShmReq.nOpcode >= 0;
+            }
+
+            bool X11Display::shm_attach(XShmSegmentInfo *info)
+            {
+                if (!shm_supported())
+                    return false;
+
+                // Create the request
+                sShmReq.bPending        = true;
+                sShmReq.bSuccess        = true;
+
+                // Set error handler
+                ::XSync(pDisplay, False);
+                XErrorHandler old = ::XSetErrorHandler(x11_error_handler);
+
+                // Attach the segment
+                ::XShmAttach(pDisplay, info);
+
+                // Reset error handler
+                ::XSync(pDisplay, False);
+                ::XSetErrorHandler(old);
+
+                sShmReq.bPending        = false;
+                if (!sShmReq.bSuccess)
+                {
+                    // Most likely, the display is remote, do not try to use MIT-SHM anymore
+                    lsp_trace("this=%p: failed to attach shared memory segment, disabling MIT-SHM", this);
+                    sShmReq.nOpcode         = -1;
+                }
+
+                return sShmReq.bSuccess;
+            }
+
             bool X11Display::translate_coordinates(Window src_w, Window dest_w, int src_x, int src_y, int *dest_x, int *dest_y, Window *child_return)
             {
                 // Create the request
@@ -3902,6 +3980,9 @@ namespace lsp
 
                 status_t res    = STATUS_OK;
 
+                // Cached measurements may refer to the font with the same name
+                sMetrics.clear();
+
             #ifdef USE_LIBFREETYPE
                 if ((res = sFontManager.add(name, is)) != STATUS_OK)
                     return res;
@@ -3916,6 +3997,8 @@ namespace lsp
                     return STATUS_BAD_ARGUMENTS;
 
                 status_t res    = STATUS_OK;
+                sMetrics.clear();
+
             #ifdef USE_LIBFREETYPE
                 if ((res = sFontManager.add_alias(name, alias)) != STATUS_OK)
                     return res;
@@ -3930,6 +4013,8 @@ namespace lsp
                     return STATUS_BAD_ARGUMENTS;
 
                 status_t res;
+                sMetrics.clear();
+
             #ifdef USE_LIBFREETYPE
                 if ((res = sFontManager.remove(name)) != STATUS_OK)
                     return res;
@@ -3940,6 +4025,8 @@ namespace lsp
 
             void X11Display::remove_all_fonts()
             {
+                sMetrics.clear();
+
             #ifdef USE_LIBFREETYPE
                 sFontManager.clear();
             #endif /* USE_LIBFREETYPE */
@@ -3957,26 +4044,103 @@ namespace lsp
 
             bool X11Display::get_font_parameters(const Font &f, font_parameters_t *fp)
             {
+                if (f.name() == NULL)
+                {
+                    pEstimation->begin();
+                    lsp_finally{ pEstimation->end(); };
+                    return pEstimation->get_font_parameters(f, fp);
+                }
+
+                // Lookup the cache first
+                const uint32_t hash = X11MetricsCache::hash(f, X11MetricsCache::KEY_FONT, NULL, 0);
+                const X11MetricsCache::params_t *cached = sMetrics.get(hash, f, X11MetricsCache::KEY_FONT, NULL, 0);
+                if (cached != NULL)
+                {
+                    *fp                 = cached->font;
+                    return true;
+                }
+
                 // Redirect the request to estimation surface
-                pEstimation->begin();
-                lsp_finally{ pEstimation->end(); };
-                return pEstimation->get_font_parameters(f, fp);
+                X11MetricsCache::params_t params;
+                {
+                    pEstimation->begin();
+                    lsp_finally{ pEstimation->end(); };
+                    if (!pEstimation->get_font_parameters(f, &params.font))
+                        return false;
+                }
+
+                sMetrics.put(hash, f, X11MetricsCache::KEY_FONT, NULL, 0, &params);
+                *fp                 = params.font;
+                return true;
             }
 
             bool X11Display::get_text_parameters(const Font &f, text_parameters_t *tp, const char *text)
             {
+                if ((f.name() == NULL) || (text == NULL))
+                {
+                    pEstimation->begin();
+                    lsp_finally{ pEstimation->end(); };
+                    return pEstimation->get_text_parameters(f, tp, text);
+                }
+
+                // Lookup the cache first
+                const size_t length = strlen(text);
+                const uint32_t hash = X11MetricsCache::hash(f, X11MetricsCache::KEY_UTF8, text, length);
+                const X11MetricsCache::params_t *cached = sMetrics.get(hash, f, X11MetricsCache::KEY_UTF8, text, length);
+                if (cached != NULL)
+                {
+                    *tp                 = cached->text;
+                    return true;
+                }
+
                 // Redirect the request to estimation surface
-                pEstimation->begin();
-                lsp_finally{ pEstimation->end(); };
-                return pEstimation->get_text_parameters(f, tp, text);
+                X11MetricsCache::params_t params;
+                {
+                    pEstimation->begin();
+                    lsp_finally{ pEstimation->end(); };
+                    if (!pEstimation->get_text_parameters(f, &params.text, text))
+                        return false;
+                }
+
+                sMetrics.put(hash, f, X11MetricsCache::KEY_UTF8, text, length, &params);
+                *tp                 = params.text;
+                return true;
             }
 
             bool X11Display::get_text_parameters(const Font &f, text_parameters_t *tp, const LSPString *text, ssize_t first, ssize_t last)
             {
+                // Only substrings that lie within the string can be cached
+                if ((f.name() == NULL) || (text == NULL) ||
+                    (first < 0) || (first > last) || (size_t(last) > text->length()))
+                {
+                    pEstimation->begin();
+                    lsp_finally{ pEstimation->end(); };
+                    return pEstimation->get_text_parameters(f, tp, text, first, last);
+                }
+
+                // Lookup the cache first
+                const lsp_wchar_t *chars    = &text->characters()[first];
+                const size_t length         = (last - first) * sizeof(lsp_wchar_t);
+                const uint32_t hash         = X11MetricsCache::hash(f, X11MetricsCache::KEY_UTF32, chars, length);
+                const X11MetricsCache::params_t *cached = sMetrics.get(hash, f, X11MetricsCache::KEY_UTF32, chars, length);
+                if (cached != NULL)
+                {
+                    *tp                 = cached->text;
+                    return true;
+                }
+
                 // Redirect the request to estimation surface
-                pEstimation->begin();
-                lsp_finally{ pEstimation->end(); };
-                return pEstimation->get_text_parameters(f, tp, text, first, last);
+                X11MetricsCache::params_t params;
+                {
+                    pEstimation->begin();
+                    lsp_finally{ pEstimation->end(); };
+                    if (!pEstimation->get_text_parameters(f, &params.text, text, first, last))
+                        return false;
+                }
+
+                sMetrics.put(hash, f, X11MetricsCache::KEY_UTF32, chars, length, &params);
+                *tp                 = params.text;
+                return true;
             }
 
             const MonitorInfo *X11Display::enum_monitors(size_t *count)
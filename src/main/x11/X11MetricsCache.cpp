@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <private/x11/X11MetricsCache.h>
+
+#ifdef USE_LIBX11
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+namespace lsp
+{
+    namespace ws
+    {
+        namespace x11
+        {
+            X11MetricsCache::X11MetricsCache(size_t max_size):
+                sCache(BINS, max_size, destroy)
+            {
+            }
+
+            X11MetricsCache::~X11MetricsCache()
+            {
+                clear();
+            }
+
+            uint32_t X11MetricsCache::hash(const Font &f, key_type_t type, const void *text, size_t length)
+            {
+                // FNV-1a over the font descriptor and the text
+                const uint8_t *name = reinterpret_cast<const uint8_t *>(f.name());
+                const uint8_t *p    = static_cast<const uint8_t *>(text);
+                const float fsize   = f.size();
+                uint32_t h          = 0x811c9dc5;
+                uint32_t sz;
+
+                for ( ; *name != '\0'; ++name)
+                    h                   = (h ^ *name) * 0x01000193;
+                memcpy(&sz, &fsize, sizeof(sz));
+                h                   = (h ^ sz) * 0x01000193;
+                h                   = (h ^ uint32_t(f.raw_flags())) * 0x01000193;
+                h                   = (h ^ uint32_t(type)) * 0x01000193;
+                for (size_t i=0; i<length; ++i)
+                    h                   = (h ^ p[i]) * 0x01000193;
+                h                   = (h ^ uint32_t(length)) * 0x01000193;
+
+                return h;
+            }
+
+            bool X11MetricsCache::match(const lru_item_t *item, const void *key)
+            {
+                const metrics_t *m  = reinterpret_cast<const metrics_t *>(item);
+                const key_t *k      = static_cast<const key_t *>(key);
+
+                if ((m->type != k->type) || (m->tlength != k->tlength) || (m->nlength != k->nlength))
+                    return false;
+                if ((m->fsize != k->fsize) || (m->flags != k->flags))
+                    return false;
+                if (memcmp(m->name, k->name, k->nlength) != 0)
+                    return false;
+
+                return (k->tlength == 0) || (memcmp(m->text, k->text, k->tlength) == 0);
+            }
+
+            void X11MetricsCache::destroy(lru_item_t *item)
+            {
+                free(item);
+            }
+
+            const X11MetricsCache::params_t *X11MetricsCache::get(uint32_t hash, const Font &f, key_type_t type, const void *text, size_t length)
+            {
+                key_t key;
+                key.type                = uint32_t(type);
+                key.fsize               = f.size();
+                key.flags               = f.raw_flags();
+                key.name                = f.name();
+                key.nlength             = strlen(key.name);
+                key.text                = text;
+                key.tlength             = length;
+
+                metrics_t *m            = reinterpret_cast<metrics_t *>(sCache.get(hash, match, &key));
+                return (m != NULL) ? &m->params : NULL;
+            }
+
+            bool X11MetricsCache::put(uint32_t hash, const Font &f, key_type_t type, const void *text, size_t length, const params_t *params)
+            {
+                // Estimate the size of the record
+                const char *name        = f.name();
+                const size_t nlength    = strlen(name);
+                const size_t szof_hdr   = align_size(sizeof(metrics_t), DEFAULT_ALIGN);
+                const size_t to_alloc   = szof_hdr + nlength + length;
+
+                // Free space for the new record
+                if (!sCache.reserve(to_alloc))
+                    return false;
+
+                // Allocate the record
+                uint8_t *ptr            = static_cast<uint8_t *>(malloc(to_alloc));
+                if (ptr == NULL)
+                    return false;
+
+                metrics_t *m            = reinterpret_cast<metrics_t *>(ptr);
+                m->item.hnext           = NULL;
+                m->item.prev            = NULL;
+                m->item.next            = NULL;
+                m->item.hash            = hash;
+                m->item.size            = to_alloc;
+                m->type                 = uint32_t(type);
+                m->fsize                = f.size();
+                m->flags                = f.raw_flags();
+                m->nlength              = nlength;
+                m->tlength              = length;
+                m->params               = *params;
+                m->name                 = reinterpret_cast<char *>(&ptr[szof_hdr]);
+                m->text                 = &ptr[szof_hdr + nlength];
+
+                memcpy(m->name, name, nlength);
+                if (length > 0)
+                    memcpy(m->text, text, length);
+
+                // Link the record
+                if (!sCache.insert(&m->item))
+                {
+                    free(m);
+                    return false;
+                }
+
+                return true;
+            }
+
+            void X11MetricsCache::clear()
+            {
+                sCache.clear();
+            }
+
+            size_t X11MetricsCache::set_max_size(size_t max_size)
+            {
+                return sCache.set_max_size(max_size);
+            }
+
+            void X11MetricsCache::clear_stats()
+            {
+                sCache.clear_stats();
+            }
+
+        } /* namespace x11 */
+    } /* namespace ws */
+} /* namespace lsp */
+
+#endif /* USE_LIBX11 */
@@ -47,6 +47,7 @@
 
 #include <limits.h>
 #include <errno.h>
+#include <stdlib.h>
 
 namespace lsp
 {
@@ -149,11 +150,28 @@ namespace lsp
                 }
             #endif /* LSP_PLUGINS_USE_OPENGL_GLX */
 
-                result = new X11CairoSurface(dpy, window, visual, width, height);
-                if (result != NULL)
+                X11CairoSurface *cs = new X11CairoSurface(dpy, window, visual, width, height);
+                if (cs != NULL)
                 {
-                    lsp_trace("Using X11CairoSurface ptr=%p", result);
-                    return result;
+                    // Asynchronous rasterization is enabled only on explicit request
+                    LSPString var;
+                    if ((system::get_env_var("LSP_WS_LIB_CAIRO_ASYNC", &var) == STATUS_OK) &&
+                        (check_env_option_enabled("LSP_WS_LIB_CAIRO_ASYNC")))
+                    {
+                        // Number of rasterization threads, 'auto' means number of CPU cores
+                        size_t threads  = 1;
+                        if (system::get_env_var("LSP_WS_LIB_CAIRO_THREADS", &var) == STATUS_OK)
+                        {
+                            const long value = (var.equals_ascii_nocase("auto")) ? 0 : atol(var.get_utf8());
+                            threads         = (value > 0) ? value : ipc::Thread::system_cores();
+                        }
+
+                        if (cs->start_async(threads) == STATUS_OK)
+                            lsp_trace("Enabled asynchronous rasterization for ptr=%p, threads=%d", cs, int(threads));
+                    }
+
+                    lsp_trace("Using X11CairoSurface ptr=%p", cs);
+                    return cs;
                 }
 
                 return NULL;
@@ -166,6 +184,10 @@ namespace lsp
                 bWrapper                = wrapper;
                 bVisible                = false;
                 bInvalidated            = true;
+                sInvalid.nLeft          = 0;
+                sInvalid.nTop           = 0;
+                sInvalid.nWidth         = 0;
+                sInvalid.nHeight        = 0;
                 pVisualInfo             = NULL;
                 hColormap               = None;
                 if (wrapper)
@@ -538,7 +560,39 @@ namespace lsp
                     return;
 
                 lsp_finally {
-                    bInvalidated = false;
+                    bInvalidated        = false;
+                    sInvalid.nWidth     = 0;
+                    sInvalid.nHeight    = 0;
+                };
+
+                // Compute the area to redraw
+                ws::rectangle_t r;
+                r.nLeft     = 0;
+                r.nTop      = 0;
+                r.nWidth    = sSize.nWidth;
+                r.nHeight   = sSize.nHeight;
+                if ((sInvalid.nWidth > 0) && (sInvalid.nHeight > 0))
+                {
+                    const ssize_t left  = lsp_max(sInvalid.nLeft, r.nLeft);
+                    const ssize_t top   = lsp_max(sInvalid.nTop, r.nTop);
+                    const ssize_t right = lsp_min(sInvalid.nLeft + sInvalid.nWidth, r.nLeft + r.nWidth);
+                    const ssize_t bottom= lsp_min(sInvalid.nTop + sInvalid.nHeight, r.nTop + r.nHeight);
+                    if ((left >= right) || (top >= bottom))
+                        return;
+
+                    r.nLeft     = left;
+                    r.nTop      = top;
+                    r.nWidth    = right - left;
+                    r.nHeight   = bottom - top;
+                }
+
+                // Restrict drawing to the redraw area only while handling the event
+                X11CairoSurface *cs = (pSurface->type() == ST_XLIB) ? static_cast<X11CairoSurface *>(pSurface) : NULL;
+                if (cs != NULL)
+                    cs->set_redraw_area(&r);
+                lsp_finally {
+                    if ((cs != NULL) && (pSurface == cs))
+                        cs->set_redraw_area(NULL);
                 };
 
                 ws::event_t ev;
@@ -546,20 +600,65 @@ namespace lsp
 
                 ev.nTime    = system::get_time_millis();
                 ev.nType    = UIE_REDRAW;
-                ev.nLeft    = 0;
-                ev.nTop     = 0;
-                ev.nWidth   = sSize.nWidth;
-                ev.nHeight  = sSize.nHeight;
+                ev.nLeft    = r.nLeft;
+                ev.nTop     = r.nTop;
+                ev.nWidth   = r.nWidth;
+                ev.nHeight  = r.nHeight;
 
                 pHandler->handle_event(&ev);
             }
 
+            void X11Window::add_invalid_area(ssize_t left, ssize_t top, ssize_t width, ssize_t height)
+            {
+                if ((width <= 0) || (height <= 0))
+                    return;
+
+                if (!bInvalidated)
+                {
+                    sInvalid.nLeft      = left;
+                    sInvalid.nTop       = top;
+                    sInvalid.nWidth     = width;
+                    sInvalid.nHeight    = height;
+                    bInvalidated        = true;
+                    return;
+                }
+
+                // Empty area of invalidated window means the whole window
+                if ((sInvalid.nWidth <= 0) || (sInvalid.nHeight <= 0))
+                    return;
+
+                const ssize_t right = lsp_max(sInvalid.nLeft + sInvalid.nWidth, left + width);
+                const ssize_t bottom= lsp_max(sInvalid.nTop + sInvalid.nHeight, top + height);
+                sInvalid.nLeft      = lsp_min(sInvalid.nLeft, left);
+                sInvalid.nTop       = lsp_min(sInvalid.nTop, top);
+                sInvalid.nWidth     = right - sInvalid.nLeft;
+                sInvalid.nHeight    = bottom - sInvalid.nTop;
+            }
+
             status_t X11Window::invalidate()
             {
                 if ((pSurface == NULL) || (hWindow == None))
                     return STATUS_BAD_STATE;
 
-                bInvalidated    = true;
+                bInvalidated        = true;
+                sInvalid.nWidth     = 0;
+                sInvalid.nHeight    = 0;
+
+                // The whole window should be redrawn, drop the pending redraw area
+                if (pSurface->type() == ST_XLIB)
+                    static_cast<X11CairoSurface *>(pSurface)->set_redraw_area(NULL);
+
+                return STATUS_OK;
+            }
+
+            status_t X11Window::invalidate(const rectangle_t *r)
+            {
+                if (r == NULL)
+                    return STATUS_BAD_ARGUMENTS;
+                if ((pSurface == NULL) || (hWindow == None))
+                    return STATUS_BAD_STATE;
+
+                add_invalid_area(r->nLeft, r->nTop, r->nWidth, r->nHeight);
 
                 return STATUS_OK;
             }
@@ -645,6 +744,9 @@ namespace lsp
                         Display *dpy    = pX11Display->x11display();
                         ::Visual *v     = (pVisualInfo != NULL) ? pVisualInfo->visual : DefaultVisual(dpy, screen());
                         pSurface        = create_surface(static_cast<X11Display *>(pDisplay), hWindow, v, sSize.nWidth, sSize.nHeight);
+                        bInvalidated    = true;
+                        sInvalid.nWidth = 0;
+                        sInvalid.nHeight= 0;
 
                         // Need to take focus?
                         if (pX11Display->pFocusWindow == this)
@@ -669,7 +771,11 @@ namespace lsp
                         lsp_trace("UIE_REDRAW location = %d x %d, size = %d x %d",
                                 int(ev->nLeft), int(ev->nTop),
                                 int(ev->nWidth), int(ev->nHeight));
-                        bInvalidated        = true;
+                        add_invalid_area(ev->nLeft, ev->nTop, ev->nWidth, ev->nHeight);
+
+                        // Exposed area should be copied to the window even if it will not be re-drawn
+                        if ((pSurface != NULL) && (pSurface->type() == ST_XLIB))
+                            static_cast<X11CairoSurface *>(pSurface)->damage(ev->nLeft, ev->nTop, ev->nWidth, ev->nHeight);
                         return STATUS_OK;
                     }
 
@@ -694,7 +800,13 @@ namespace lsp
                         sSize.nWidth        = ev->nWidth;
                         sSize.nHeight       = ev->nHeight;
                         if (pSurface != NULL)
+                        {
+                            // Contents of the surface is lost, the whole window should be redrawn
                             pSurface->resize(sSize.nWidth, sSize.nHeight);
+                            bInvalidated        = true;
+                            sInvalid.nWidth     = 0;
+                            sInvalid.nHeight    = 0;
+                        }
                         break;
                     }
 
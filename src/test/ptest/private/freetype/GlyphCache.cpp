@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/test-fw/ptest.h>
+
+#include <private/freetype/face.h>
+#include <private/freetype/GlyphCache.h>
+
+using namespace lsp;
+using namespace lsp::ws;
+
+namespace
+{
+    // Glyph cache and LRU list used by FontManager before they were replaced with the CLOCK table:
+    // each face has it's own chained hash keyed by codepoint, all glyphs are linked into one LRU list.
+    typedef struct legacy_glyph_t
+    {
+        legacy_glyph_t     *cache_next;
+        legacy_glyph_t     *lru_prev;
+        legacy_glyph_t     *lru_next;
+        lsp_wchar_t         codepoint;
+    } legacy_glyph_t;
+
+    class LegacyGlyphCache
+    {
+        protected:
+            typedef struct bin_t
+            {
+                size_t              size;
+                legacy_glyph_t     *data;
+            } bin_t;
+
+        protected:
+            size_t          nSize;
+            size_t          nCap;
+            bin_t          *vBins;
+
+        protected:
+            bool grow()
+            {
+                if (nCap == 0)
+                {
+                    bin_t *xbin     = static_cast<bin_t *>(::malloc(0x10 * sizeof(bin_t)));
+                    if (xbin == NULL)
+                        return false;
+
+                    nCap            = 0x10;
+                    vBins           = xbin;
+                    for (size_t i=0; i<nCap; ++i, ++xbin)
+                    {
+                        xbin->size      = 0;
+                        xbin->data      = NULL;
+                    }
+                    return true;
+                }
+
+                const size_t ncap   = nCap << 1;
+                bin_t *xbin         = static_cast<bin_t *>(::realloc(vBins, ncap * sizeof(bin_t)));
+                if (xbin == NULL)
+                    return false;
+
+                const size_t mask   = (ncap - 1) ^ (nCap - 1);
+                vBins               = xbin;
+                bin_t *ybin         = &xbin[nCap];
+
+                for (size_t i=0; i<nCap; ++i, ++xbin, ++ybin)
+                {
+                    ybin->size      = 0;
+                    ybin->data      = NULL;
+
+                    for (legacy_glyph_t **pcurr = &xbin->data; *pcurr != NULL; )
+                    {
+                        legacy_glyph_t *curr = *pcurr;
+                        if (curr->codepoint & mask)
+                        {
+                            *pcurr              = curr->cache_next;
+                            curr->cache_next    = ybin->data;
+                            ybin->data          = curr;
+                            --xbin->size;
+                            ++ybin->size;
+                        }
+                        else
+                            pcurr               = &curr->cache_next;
+                    }
+                }
+
+                nCap            = ncap;
+                return true;
+            }
+
+        public:
+            LegacyGlyphCache()
+            {
+                nSize       = 0;
+                nCap        = 0;
+                vBins       = NULL;
+            }
+
+            ~LegacyGlyphCache()
+            {
+                if (vBins != NULL)
+                {
+                    free(vBins);
+                    vBins       = NULL;
+                }
+            }
+
+        public:
+            bool put(legacy_glyph_t *glyph)
+            {
+                bin_t *bin      = (vBins != NULL) ? &vBins[glyph->codepoint & (nCap - 1)] : NULL;
+                if (bin != NULL)
+                {
+                    for (legacy_glyph_t *g = bin->data; g != NULL; g = g->cache_next)
+                        if (g->codepoint == glyph->codepoint)
+                            return false;
+                }
+
+                if (nSize >= (nCap << 2))
+                {
+                    if (!grow())
+                        return false;
+                    bin             = &vBins[glyph->codepoint & (nCap - 1)];
+                }
+
+                glyph->cache_next   = bin->data;
+                bin->data           = glyph;
+                ++bin->size;
+                ++nSize;
+
+                return true;
+            }
+
+            legacy_glyph_t *get(lsp_wchar_t codepoint)
+            {
+                bin_t *bin      = (vBins != NULL) ? &vBins[codepoint & (nCap - 1)] : NULL;
+                if (bin == NULL)
+                    return NULL;
+
+                for (legacy_glyph_t *g = bin->data; g != NULL; g = g->cache_next)
+                    if (g->codepoint == codepoint)
+                        return g;
+
+                return NULL;
+            }
+    };
+
+    class LegacyLRUCache
+    {
+        protected:
+            legacy_glyph_t     *pHead;
+            legacy_glyph_t     *pTail;
+
+        public:
+            LegacyLRUCache()
+            {
+                pHead       = NULL;
+                pTail       = NULL;
+            }
+
+        public:
+            void add_first(legacy_glyph_t *glyph)
+            {
+                glyph->lru_next     = pHead;
+                glyph->lru_prev     = NULL;
+                if (pHead != NULL)
+                    pHead->lru_prev     = glyph;
+                else
+                    pTail               = glyph;
+                pHead               = glyph;
+            }
+
+            legacy_glyph_t *touch(legacy_glyph_t *glyph)
+            {
+                if (glyph->lru_prev != NULL)
+                    glyph->lru_prev->lru_next   = glyph->lru_next;
+                else
+                    return glyph;
+
+                if (glyph->lru_next != NULL)
+                    glyph->lru_next->lru_prev   = glyph->lru_prev;
+                else
+                    pTail               = glyph->lru_prev;
+
+                glyph->lru_next     = pHead;
+                glyph->lru_prev     = NULL;
+                pHead->lru_prev     = glyph;
+                pHead               = glyph;
+
+                return glyph;
+            }
+    };
+} /* namespace */
+
+#define FACES           4
+#define MIN_RANK        8
+#define MAX_RANK        14
+#define LOOKUPS         0x1000
+
+PTEST_BEGIN("ws.freetype", glyphcache, 5, 1000)
+
+    void lookup(const char *label, ft::GlyphCache *cache, const ft::face_t *faces,
+        const lsp_wchar_t *codes, const size_t *order, size_t count)
+    {
+        char buf[80];
+        snprintf(buf, sizeof(buf), "clock %s x %d", label, int(cache->size()));
+        printf("Testing %s glyphs...\n", buf);
+
+        PTEST_LOOP(buf,
+            for (size_t i=0; i<LOOKUPS; ++i)
+            {
+                const size_t k = order[i % count];
+                cache->get(&faces[k % FACES], codes[k]);
+            }
+        );
+    }
+
+    void lookup_legacy(const char *label, LegacyGlyphCache *caches, LegacyLRUCache *lru,
+        const lsp_wchar_t *codes, const size_t *order, size_t count)
+    {
+        char buf[80];
+        snprintf(buf, sizeof(buf), "legacy %s x %d", label, int(count));
+        printf("Testing %s glyphs...\n", buf);
+
+        PTEST_LOOP(buf,
+            for (size_t i=0; i<LOOKUPS; ++i)
+            {
+                const size_t k = order[i % count];
+                legacy_glyph_t *g = caches[k % FACES].get(codes[k]);
+                if (g != NULL)
+                    lru->touch(g);
+            }
+        );
+    }
+
+    PTEST_MAIN
+    {
+        const size_t max_count = 1 << MAX_RANK;
+        ft::face_t faces[FACES];
+
+        ft::glyph_t *vglyphs    = new ft::glyph_t[max_count];
+        legacy_glyph_t *lglyphs = new legacy_glyph_t[max_count];
+        lsp_wchar_t *codes      = new lsp_wchar_t[max_count];
+        lsp_wchar_t *missing    = new lsp_wchar_t[max_count];
+        size_t *order           = new size_t[max_count];
+        lsp_finally {
+            delete [] vglyphs;
+            delete [] lglyphs;
+            delete [] codes;
+            delete [] missing;
+            delete [] order;
+        };
+
+        // Glyphs of all faces share the same codepoints like glyphs of the same text in different fonts
+        for (size_t i=0; i<max_count; ++i)
+        {
+            codes[i]                = 0x20 + i / FACES;
+            missing[i]              = 0x100000 + i / FACES;
+            vglyphs[i].face         = &faces[i % FACES];
+            vglyphs[i].codepoint    = codes[i];
+            vglyphs[i].cache_next   = NULL;
+            lglyphs[i].codepoint    = codes[i];
+        }
+
+        for (size_t rank=MIN_RANK; rank <= MAX_RANK; rank += 2)
+        {
+            const size_t count = 1 << rank;
+
+            ft::GlyphCache cache;
+            LegacyGlyphCache lcaches[FACES];
+            LegacyLRUCache lru;
+            for (size_t i=0; i<count; ++i)
+            {
+                cache.put(&vglyphs[i]);
+                lcaches[i % FACES].put(&lglyphs[i]);
+                lru.add_first(&lglyphs[i]);
+            }
+
+            // Sequential lookup like in text layout and random lookup
+            for (size_t i=0; i<count; ++i)
+                order[i]                = i;
+            lookup("sequential hit", &cache, faces, codes, order, count);
+            lookup_legacy("sequential hit", lcaches, &lru, codes, order, count);
+
+            for (size_t i=0; i<count; ++i)
+                order[i]                = (i * 0x9e3779b1) & (count - 1);
+            lookup("random hit", &cache, faces, codes, order, count);
+            lookup_legacy("random hit", lcaches, &lru, codes, order, count);
+            lookup("random miss", &cache, faces, missing, order, count);
+            lookup_legacy("random miss", lcaches, &lru, missing, order, count);
+
+            cache.clear();
+            printf("\n");
+        }
+    }
+
+PTEST_END
+
+#endif /* USE_LIBFREETYPE */
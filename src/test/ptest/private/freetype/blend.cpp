@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/test-fw/ptest.h>
+
+#include <private/freetype/blend.h>
+
+using namespace lsp::ws;
+
+#define IMG_WIDTH       256
+#define IMG_HEIGHT      64
+#define MIN_SIZE        8
+#define MAX_SIZE        64
+
+PTEST_BEGIN("ws.freetype", blend, 5, 1000)
+
+    void make_glyph(ft::glyph_t *glyph, uint8_t *data, ft::glyph_format_t format, size_t width, size_t height)
+    {
+        const size_t bits   = 1 << format;
+        const size_t stride = (width * bits + 7) >> 3;
+
+        bzero(glyph, sizeof(ft::glyph_t));
+        glyph->format           = format;
+        glyph->bitmap.width     = width;
+        glyph->bitmap.height    = height;
+        glyph->bitmap.stride    = stride;
+        glyph->bitmap.data      = data;
+
+        // Glyph-like coverage: opaque stems, empty counters and partially covered edges
+        for (size_t i=0, n=stride * height; i<n; ++i)
+        {
+            const size_t v      = (i * 37) % 5;
+            data[i]             = (v == 0) ? 0x00 : (v == 1) ? 0xff : uint8_t(i * 73);
+        }
+    }
+
+    void call(const char *label, uint32_t *image, const ft::glyph_t *glyph, uint32_t color)
+    {
+        char buf[80];
+        snprintf(buf, sizeof(buf), "%s %dx%d", label, int(glyph->bitmap.width), int(glyph->bitmap.height));
+        printf("Testing %s glyph...\n", buf);
+
+        // Blend the row of glyphs like a line of text
+        const ssize_t step  = glyph->bitmap.width;
+        PTEST_LOOP(buf,
+            for (ssize_t x=0; x + step <= IMG_WIDTH; x += step)
+                ft::blend_glyph(
+                    reinterpret_cast<uint8_t *>(image), IMG_WIDTH * sizeof(uint32_t),
+                    glyph, x, 0, 0, 0, IMG_WIDTH, IMG_HEIGHT, color);
+        );
+    }
+
+    PTEST_MAIN
+    {
+        static const char * const labels[] = { "1bpp", "2bpp", "4bpp", "8bpp" };
+        static const ft::glyph_format_t formats[] = { ft::FMT_1_BPP, ft::FMT_2_BPP, ft::FMT_4_BPP, ft::FMT_8_BPP };
+
+        uint32_t *image     = new uint32_t[IMG_WIDTH * IMG_HEIGHT];
+        uint8_t *data       = new uint8_t[MAX_SIZE * MAX_SIZE];
+        lsp_finally {
+            delete [] image;
+            delete [] data;
+        };
+        for (size_t i=0; i<IMG_WIDTH * IMG_HEIGHT; ++i)
+            image[i]            = 0xff202020;
+
+        const uint32_t opaque       = ft::premultiply_color(1.0f, 0.5f, 0.25f, 1.0f);
+        const uint32_t translucent  = ft::premultiply_color(1.0f, 0.5f, 0.25f, 0.5f);
+
+        for (size_t size=MIN_SIZE; size <= MAX_SIZE; size <<= 1)
+        {
+            for (size_t i=0; i<4; ++i)
+            {
+                char label[32];
+                ft::glyph_t glyph;
+                make_glyph(&glyph, data, formats[i], size, size);
+
+                snprintf(label, sizeof(label), "%s opaque", labels[i]);
+                call(label, image, &glyph, opaque);
+                snprintf(label, sizeof(label), "%s translucent", labels[i]);
+                call(label, image, &glyph, translucent);
+            }
+            printf("\n");
+        }
+    }
+
+PTEST_END
+
+#endif /* USE_LIBFREETYPE */
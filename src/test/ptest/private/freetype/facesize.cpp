@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/test-fw/ptest.h>
+
+#include <private/freetype/face.h>
+#include <private/freetype/FontManager.h>
+
+using namespace lsp;
+using namespace lsp::ws;
+
+#define SIZES           8
+#define ACTIVATIONS     0x100
+
+PTEST_BEGIN("ws.freetype", facesize, 5, 1000)
+
+    // The way activate_face() worked before: rescale the shared FT_Face on each activation
+    void rescale(const char *label, ft::library_t & ft, ft::face_t * const *faces, size_t count)
+    {
+        char buf[80];
+        snprintf(buf, sizeof(buf), "%s x %d", label, int(count));
+        printf("Testing %s sizes...\n", buf);
+
+        PTEST_LOOP(buf,
+            for (size_t i=0; i<ACTIVATIONS; ++i)
+            {
+                ft::face_t *face = faces[i % count];
+                ft.set_char_size(face->ft_face, face->h_size, face->v_size, 0, 0);
+                ft.set_transform(face->ft_face, &face->matrix, NULL);
+            }
+        );
+    }
+
+    void activate(const char *label, ft::library_t & ft, ft::face_t * const *faces, size_t count)
+    {
+        char buf[80];
+        snprintf(buf, sizeof(buf), "%s x %d", label, int(count));
+        printf("Testing %s sizes...\n", buf);
+
+        PTEST_LOOP(buf,
+            for (size_t i=0; i<ACTIVATIONS; ++i)
+                ft::activate_face(ft, faces[i % count]);
+        );
+    }
+
+    void font_parameters(const char *label, ft::FontManager *manager, const Font *fonts, size_t count)
+    {
+        char buf[80];
+        snprintf(buf, sizeof(buf), "%s x %d", label, int(count));
+        printf("Testing %s sizes...\n", buf);
+
+        font_parameters_t fp;
+        PTEST_LOOP(buf,
+            for (size_t i=0; i<ACTIVATIONS; ++i)
+                manager->get_font_parameters(&fonts[i % count], &fp);
+        );
+    }
+
+    void test_faces(const io::Path *path)
+    {
+        ft::library_t ft;
+        if (ft.init() != STATUS_OK)
+            return;
+        lsp_finally { ft.destroy(); };
+
+        lltl::parray<ft::face_t> loaded;
+        if (ft::load_face(&loaded, ft, path) != STATUS_OK)
+            return;
+        lsp_finally { ft::destroy_faces(ft, &loaded); };
+
+        // Create faces of different sizes that share the same FT_Face like FontManager does
+        ft::face_t *faces[SIZES];
+        size_t count = 0;
+        lsp_finally {
+            for (size_t i=0; i<count; ++i)
+                ft::destroy_face(ft, faces[i]);
+        };
+        for ( ; count < SIZES; ++count)
+        {
+            ft::face_t *face    = ft::clone_face(ft, loaded.uget(0));
+            if (face == NULL)
+                return;
+            faces[count]        = face;
+
+            face->h_size        = ft::float_to_f26p6(10.0f + count * 2.0f);
+            face->v_size        = 0;
+            face->matrix.xx     = 0x10000;
+            face->matrix.xy     = 0;
+            face->matrix.yx     = 0;
+            face->matrix.yy     = 0x10000;
+        }
+
+        // Rescaling should not touch size objects of the faces, so it works on it's own size object
+        FT_Size scratch = NULL;
+        if (ft.new_size(faces[0]->ft_face, &scratch) != FT_Err_Ok)
+            return;
+        lsp_finally { ft.done_size(scratch); };
+
+        for (size_t n=2; n <= SIZES; n <<= 1)
+        {
+            ft.activate_size(scratch);
+            rescale("set_char_size", ft, faces, n);
+            activate("activate_size", ft, faces, n);
+        }
+        printf("\n");
+    }
+
+    void test_manager(const io::Path *path)
+    {
+        ft::FontManager manager;
+        if (manager.init() != STATUS_OK)
+            return;
+        lsp_finally { manager.destroy(); };
+        if (manager.add("noto-sans", path) != STATUS_OK)
+            return;
+
+        Font fonts[SIZES];
+        for (size_t i=0; i<SIZES; ++i)
+        {
+            fonts[i].set_name("noto-sans");
+            fonts[i].set_size(10.0f + i * 2.0f);
+        }
+
+        for (size_t n=2; n <= SIZES; n <<= 1)
+            font_parameters("FontManager", &manager, fonts, n);
+        printf("\n");
+    }
+
+    PTEST_MAIN
+    {
+        io::Path path;
+        if (path.fmt("%s/font/NotoSansDisplay-Regular.ttf", resources()) <= 0)
+            return;
+
+        test_faces(&path);
+        test_manager(&path);
+    }
+
+PTEST_END
+
+#endif /* USE_LIBFREETYPE */
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/gl/defs.h>
+
+#ifdef LSP_PLUGINS_USE_OPENGL
+
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/test-fw/ptest.h>
+
+#include <private/gl/extrude.h>
+
+using namespace lsp::ws;
+
+#define POINTS          4096
+#define MIN_POINTS      64
+
+PTEST_BEGIN("ws.gl", extrude, 5, 1000)
+
+    void call(const char *label, const float *x, const float *y, size_t n,
+        gl::vertex_t *vertices, uint32_t *indices, bool chunked)
+    {
+        char buf[80];
+        snprintf(buf, sizeof(buf), "%s %s x %d", (chunked) ? "chunked" : "scalar", label, int(n));
+        printf("Testing %s points...\n", buf);
+
+        PTEST_LOOP(buf,
+            gl::vertex_t *v = vertices;
+            uint32_t *iv    = indices;
+            if (chunked)
+                gl::extrude_polyline<uint32_t>(v, iv, 0, 0, x, y, 2.0f, n);
+            else
+                gl::extrude_polyline_scalar<uint32_t>(v, iv, 0, 0, x, y, 2.0f, n);
+        );
+    }
+
+    PTEST_MAIN
+    {
+        float *x                = new float[POINTS];
+        float *y                = new float[POINTS];
+        gl::vertex_t *vertices  = new gl::vertex_t[POINTS * 4];
+        uint32_t *indices       = new uint32_t[POINTS * 12];
+        lsp_finally {
+            delete [] x;
+            delete [] y;
+            delete [] vertices;
+            delete [] indices;
+        };
+
+        for (size_t i=0; i<POINTS; ++i)
+            x[i]        = float(i) * 0.25f;
+
+        // Smooth trace like a frequency response curve
+        for (size_t i=0; i<POINTS; ++i)
+            y[i]        = 100.0f + 80.0f * sinf(float(i) * 0.01f);
+        for (size_t n=MIN_POINTS; n <= POINTS; n <<= 2)
+        {
+            call("smooth", x, y, n, vertices, indices, false);
+            call("smooth", x, y, n, vertices, indices, true);
+        }
+        printf("\n");
+
+        // Noisy trace like a spectrum
+        for (size_t i=0; i<POINTS; ++i)
+            y[i]        = 100.0f + float((i * 7919) % 101) - 50.0f;
+        call("noisy", x, y, POINTS, vertices, indices, false);
+        call("noisy", x, y, POINTS, vertices, indices, true);
+
+        // Trace with one repeated point in each chunk that triggers the point-by-point fallback
+        for (size_t i=gl::EXTRUDE_CHUNK/2; i<POINTS; i += gl::EXTRUDE_CHUNK)
+        {
+            x[i]        = x[i - 1];
+            y[i]        = y[i - 1];
+        }
+        call("degenerate", x, y, POINTS, vertices, indices, false);
+        call("degenerate", x, y, POINTS, vertices, indices, true);
+    }
+
+PTEST_END
+
+#endif /* LSP_PLUGINS_USE_OPENGL */
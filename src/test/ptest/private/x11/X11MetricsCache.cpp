@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/ws/version.h>
+
+#ifdef USE_LIBX11
+
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/test-fw/ptest.h>
+
+#include <private/x11/X11MetricsCache.h>
+
+#define MIN_LABELS      0x40
+#define MAX_LABELS      0x1000
+#define LABEL_SIZE      32
+
+typedef lsp::ws::x11::X11MetricsCache cache_t;
+
+PTEST_BEGIN("ws.x11", metricscache, 5, 1000)
+
+    void relayout(const char *label, cache_t *cache, const lsp::ws::Font *fonts, const char *labels, size_t count)
+    {
+        char buf[80];
+        snprintf(buf, sizeof(buf), "%s x %d", label, int(count));
+        printf("Testing %s labels...\n", buf);
+
+        cache_t::params_t p;
+        bzero(&p, sizeof(p));
+
+        // Each relayout measures all labels of the window, missing measurements are stored
+        PTEST_LOOP(buf,
+            for (size_t i=0; i<count; ++i)
+            {
+                const lsp::ws::Font &f  = fonts[i & 3];
+                const char *text        = &labels[i * LABEL_SIZE];
+                const size_t length     = strlen(text);
+                const uint32_t hash     = cache_t::hash(f, cache_t::KEY_UTF8, text, length);
+                if (cache->get(hash, f, cache_t::KEY_UTF8, text, length) == NULL)
+                    cache->put(hash, f, cache_t::KEY_UTF8, text, length, &p);
+            }
+        );
+    }
+
+    PTEST_MAIN
+    {
+        lsp::ws::Font fonts[4];
+        fonts[0].set_name("sans");
+        fonts[0].set_size(12.0f);
+        fonts[1].set_name("sans");
+        fonts[1].set_size(12.0f);
+        fonts[1].set_bold(true);
+        fonts[2].set_name("monospace");
+        fonts[2].set_size(10.0f);
+        fonts[3].set_name("sans");
+        fonts[3].set_size(16.0f);
+
+        char *labels = new char[MAX_LABELS * LABEL_SIZE];
+        lsp_finally { delete [] labels; };
+        for (size_t i=0; i<MAX_LABELS; ++i)
+            snprintf(&labels[i * LABEL_SIZE], LABEL_SIZE, "Parameter %d: %d dB", int(i), int(i * 7) % 96 - 48);
+
+        for (size_t count=MIN_LABELS; count <= MAX_LABELS; count <<= 2)
+        {
+            // All measurements fit into the cache
+            cache_t cache;
+            relayout("cached relayout", &cache, fonts, labels, count);
+
+            // Only a quarter of measurements fit into the cache, the LRU order makes each lookup a miss
+            cache_t small(cache.size() / 4);
+            relayout("thrashing relayout", &small, fonts, labels, count);
+
+            printf("\n");
+        }
+    }
+
+PTEST_END
+
+#endif /* USE_LIBX11 */
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/ws/version.h>
+
+#if defined(USE_LIBX11) && defined(USE_LIBCAIRO)
+
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/test-fw/ptest.h>
+
+#include <private/x11/X11CairoSurface.h>
+
+#define IMG_WIDTH       1920
+#define IMG_HEIGHT      1080
+#define MIN_SIZE        4
+#define MAX_SIZE        256
+
+namespace
+{
+    using namespace lsp;
+
+    /**
+     * Image surface that fills rectangles either directly or through the cairo rasterizer
+     */
+    class TestSurface: public ws::x11::X11CairoSurface
+    {
+        public:
+            explicit TestSurface(size_t width, size_t height):
+                X11CairoSurface(NULL, width, height)
+            {
+            }
+
+        public:
+            bool fill_direct(const Color &c, float left, float top, float width, float height)
+            {
+                return fill_rect_fast(c, SURFMASK_NO_CORNER, 0.0f, left, top, width, height);
+            }
+
+            void fill_cairo(const Color &c, float left, float top, float width, float height)
+            {
+                float r, g, b, o;
+                c.get_rgbo(r, g, b, o);
+                ::cairo_set_source_rgba(pCR, r, g, b, o);
+                ::cairo_rectangle(pCR, left, top, width, height);
+                ::cairo_fill(pCR);
+            }
+    };
+} /* namespace */
+
+PTEST_BEGIN("ws.x11", fillrect, 5, 1000)
+
+    void call(const char *label, TestSurface *s, size_t size, bool direct)
+    {
+        char buf[80];
+        snprintf(buf, sizeof(buf), "%s %dx%d", label, int(size), int(size));
+        printf("Testing %s rectangles...\n", buf);
+
+        // Fill the surface with the grid of rectangles like a set of widget backgrounds
+        Color c(0.25f, 0.5f, 0.75f);
+        if (direct)
+        {
+            PTEST_LOOP(buf,
+                for (size_t y=0; y + size <= IMG_HEIGHT; y += size)
+                    for (size_t x=0; x + size <= IMG_WIDTH; x += size)
+                        s->fill_direct(c, x, y, size - 1, size - 1);
+            );
+        }
+        else
+        {
+            PTEST_LOOP(buf,
+                for (size_t y=0; y + size <= IMG_HEIGHT; y += size)
+                    for (size_t x=0; x + size <= IMG_WIDTH; x += size)
+                        s->fill_cairo(c, x, y, size - 1, size - 1);
+            );
+        }
+    }
+
+    PTEST_MAIN
+    {
+        TestSurface s(IMG_WIDTH, IMG_HEIGHT);
+        s.begin();
+        lsp_finally {
+            s.end();
+            s.destroy();
+        };
+
+        for (size_t size=MIN_SIZE; size <= MAX_SIZE; size <<= 2)
+        {
+            call("direct", &s, size, true);
+            call("cairo", &s, size, false);
+            printf("\n");
+        }
+    }
+
+PTEST_END
+
+#endif /* USE_LIBX11 && USE_LIBCAIRO */
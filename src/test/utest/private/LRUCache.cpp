@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+
+#include <private/LRUCache.h>
+
+using namespace lsp::ws;
+
+UTEST_BEGIN("ws", lrucache)
+
+    typedef struct record_t
+    {
+        lru_item_t          item;
+        int                 key;
+        bool                destroyed;
+    } record_t;
+
+    static bool match(const lru_item_t *item, const void *key)
+    {
+        return reinterpret_cast<const record_t *>(item)->key == *static_cast<const int *>(key);
+    }
+
+    static void destroy(lru_item_t *item)
+    {
+        reinterpret_cast<record_t *>(item)->destroyed = true;
+    }
+
+    void init_records(record_t *r, size_t count, uint32_t hash_mask)
+    {
+        for (size_t i=0; i<count; ++i)
+        {
+            r[i].item.hnext     = NULL;
+            r[i].item.prev      = NULL;
+            r[i].item.next      = NULL;
+            r[i].item.hash      = uint32_t(i) & hash_mask;
+            r[i].item.size      = 10;
+            r[i].key            = int(i);
+            r[i].destroyed      = false;
+        }
+    }
+
+    lru_item_t *lookup(LRUCache *cache, const record_t *r)
+    {
+        return cache->get(r->item.hash, match, &r->key);
+    }
+
+    void test_collisions()
+    {
+        printf("Testing lookup of colliding keys...\n");
+
+        record_t r[8];
+        init_records(r, 8, 0);  // All records have the same hash
+
+        LRUCache cache(4, 1000, destroy);
+        UTEST_ASSERT(lookup(&cache, &r[0]) == NULL);
+        for (size_t i=0; i<8; ++i)
+        {
+            UTEST_ASSERT(cache.reserve(r[i].item.size));
+            UTEST_ASSERT(cache.insert(&r[i].item));
+        }
+        UTEST_ASSERT(cache.size() == 80);
+
+        for (size_t i=0; i<8; ++i)
+            UTEST_ASSERT(lookup(&cache, &r[i]) == &r[i].item);
+
+        // The record with the same key but other hash should not be found
+        record_t other  = r[3];
+        other.item.hash = 1;
+        UTEST_ASSERT(lookup(&cache, &other) == NULL);
+
+        UTEST_ASSERT(cache.hits() == 8);
+        UTEST_ASSERT(cache.misses() == 2);
+        cache.clear_stats();
+        UTEST_ASSERT(cache.hits() == 0);
+        UTEST_ASSERT(cache.misses() == 0);
+
+        // Removal from the middle of the bin should keep other records
+        cache.remove(&r[4].item);
+        UTEST_ASSERT(r[4].destroyed);
+        UTEST_ASSERT(cache.size() == 70);
+        for (size_t i=0; i<8; ++i)
+            UTEST_ASSERT(lookup(&cache, &r[i]) == ((i == 4) ? NULL : &r[i].item));
+
+        cache.clear();
+        UTEST_ASSERT(cache.size() == 0);
+        UTEST_ASSERT(cache.first() == NULL);
+        for (size_t i=0; i<8; ++i)
+            UTEST_ASSERT(r[i].destroyed);
+    }
+
+    void test_recency()
+    {
+        printf("Testing eviction of least recently used records...\n");
+
+        record_t r[6];
+        init_records(r, 6, 0xff);
+
+        // The cache holds four records of 10 bytes
+        LRUCache cache(16, 40, destroy);
+        for (size_t i=0; i<4; ++i)
+        {
+            UTEST_ASSERT(cache.reserve(r[i].item.size));
+            UTEST_ASSERT(cache.insert(&r[i].item));
+        }
+        UTEST_ASSERT(cache.first() == &r[3].item);
+
+        // Touch the oldest record, the next oldest should be evicted instead
+        UTEST_ASSERT(lookup(&cache, &r[0]) == &r[0].item);
+        UTEST_ASSERT(cache.first() == &r[0].item);
+        UTEST_ASSERT(cache.reserve(r[4].item.size));
+        UTEST_ASSERT(cache.insert(&r[4].item));
+        UTEST_ASSERT(!r[0].destroyed);
+        UTEST_ASSERT(r[1].destroyed);
+        UTEST_ASSERT(cache.size() == 40);
+
+        // Shrinking the cache evicts records in the order of use
+        UTEST_ASSERT(cache.set_max_size(20) == 40);
+        UTEST_ASSERT(r[2].destroyed);
+        UTEST_ASSERT(r[3].destroyed);
+        UTEST_ASSERT(!r[0].destroyed);
+        UTEST_ASSERT(!r[4].destroyed);
+        UTEST_ASSERT(cache.size() == 20);
+
+        // Record larger than a quarter of the cache should be rejected without eviction
+        r[5].item.size  = 6;
+        UTEST_ASSERT(!cache.reserve(r[5].item.size));
+        UTEST_ASSERT(cache.size() == 20);
+        UTEST_ASSERT(!r[0].destroyed);
+    }
+
+    UTEST_MAIN
+    {
+        test_collisions();
+        test_recency();
+    }
+
+UTEST_END;
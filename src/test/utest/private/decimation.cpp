@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+
+#include <private/decimation.h>
+
+using namespace lsp::ws;
+
+UTEST_BEGIN("ws", decimation)
+
+    static constexpr size_t POINTS      = 0x1000;
+    static constexpr size_t COLUMNS     = 0x40;
+
+    void test_decimation()
+    {
+        printf("Testing decimation of dense polyline...\n");
+
+        float x[POINTS], y[POINTS], dx[POINTS], dy[POINTS];
+        for (size_t i=0; i<POINTS; ++i)
+        {
+            x[i]        = float(i * COLUMNS) / float(POINTS);
+            y[i]        = float((i * 7919) % 101);
+        }
+        y[100]      = -1000.0f;
+        y[2000]     = 1000.0f;
+
+        UTEST_ASSERT(need_decimation(x, POINTS));
+
+        const size_t n = decimate_poly(dx, dy, x, y, POINTS);
+        UTEST_ASSERT(n <= COLUMNS * 4);
+        UTEST_ASSERT(n > COLUMNS);
+
+        // First and last points should be kept, peaks should be preserved exactly
+        UTEST_ASSERT((dx[0] == x[0]) && (dy[0] == y[0]));
+        UTEST_ASSERT((dx[n-1] == x[POINTS-1]) && (dy[n-1] == y[POINTS-1]));
+
+        bool min_found = false, max_found = false;
+        for (size_t i=0; i<n; ++i)
+        {
+            min_found  |= (dx[i] == x[100]) && (dy[i] == -1000.0f);
+            max_found  |= (dx[i] == x[2000]) && (dy[i] == 1000.0f);
+            if (i > 0)
+                UTEST_ASSERT(dx[i] >= dx[i-1]);
+        }
+        UTEST_ASSERT(min_found);
+        UTEST_ASSERT(max_found);
+
+        // In-place decimation should give the same result
+        const size_t m = decimate_poly(x, y, x, y, POINTS);
+        UTEST_ASSERT(m == n);
+        for (size_t i=0; i<n; ++i)
+            UTEST_ASSERT((x[i] == dx[i]) && (y[i] == dy[i]));
+    }
+
+    void test_sparse()
+    {
+        printf("Testing sparse polyline...\n");
+
+        float x[POINTS], y[POINTS], dx[POINTS], dy[POINTS];
+        for (size_t i=0; i<POINTS; ++i)
+        {
+            x[i]        = float(i);
+            y[i]        = float(i & 1);
+        }
+
+        UTEST_ASSERT(!need_decimation(x, POINTS));
+        UTEST_ASSERT(decimate_poly(dx, dy, x, y, POINTS) == POINTS);
+
+        // Short polylines are never decimated
+        for (size_t i=0; i<POINTS; ++i)
+            x[i]        = 0.0f;
+        UTEST_ASSERT(need_decimation(x, POINTS));
+        UTEST_ASSERT(!need_decimation(x, DECIMATION_MIN_POINTS - 1));
+    }
+
+    UTEST_MAIN
+    {
+        test_decimation();
+        test_sparse();
+    }
+
+UTEST_END;
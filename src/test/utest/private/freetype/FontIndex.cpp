@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/runtime/system.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/test-fw/utest.h>
+
+#include <private/freetype/face_id.h>
+#include <private/freetype/FontIndex.h>
+
+using namespace lsp::ws;
+
+UTEST_BEGIN("ws.freetype", fontindex)
+
+    void test_persistence()
+    {
+        printf("Testing persistence of the font index\n");
+
+        // Redirect the cache directory
+        lsp::io::Path path;
+        UTEST_ASSERT(path.fmt("%s/utest-%s", tempdir(), name()) > 0);
+        UTEST_ASSERT(lsp::system::set_env_var("XDG_CACHE_HOME", path.as_native()) == lsp::STATUS_OK);
+        UTEST_ASSERT(path.append_child("lsp-ws-lib/font-index") == lsp::STATUS_OK);
+        path.remove();
+
+        // Build the index and persist it
+        ft::FontIndex built;
+        const ft::FontIndex::font_info_t *f1 = built.find(NULL, 0);
+        printf("Indexed %d entries\n", int(built.size()));
+        if (built.size() <= 0)
+            return;
+        UTEST_ASSERT(path.exists());
+
+        // Load the persisted index
+        ft::FontIndex loaded;
+        const ft::FontIndex::font_info_t *f2 = loaded.find(NULL, 0);
+        UTEST_ASSERT(loaded.size() == built.size());
+        UTEST_ASSERT((f1 == NULL) == (f2 == NULL));
+        if (f1 != NULL)
+        {
+            printf("Default font: family=%s, style=%s, path=%s\n", f1->family, f1->style, f1->path);
+            UTEST_ASSERT(strcmp(f1->family, f2->family) == 0);
+            UTEST_ASSERT(strcmp(f1->path, f2->path) == 0);
+            UTEST_ASSERT(strcmp(f1->style, f2->style) == 0);
+            UTEST_ASSERT(f1->weight == f2->weight);
+            UTEST_ASSERT(f1->slant == f2->slant);
+
+            // Family lookup should be case-insensitive
+            lsp::LSPString family;
+            UTEST_ASSERT(family.set_utf8(f1->family));
+            family.toupper();
+            const ft::FontIndex::font_info_t *f3 = loaded.find(family.get_utf8(), 0);
+            UTEST_ASSERT(f3 != NULL);
+            UTEST_ASSERT(strcasecmp(f3->family, f1->family) == 0);
+        }
+
+        // Unknown family should not be found
+        UTEST_ASSERT(loaded.find("Unknown Font Family For Testing", ft::FID_BOLD) == NULL);
+        loaded.clear();
+        UTEST_ASSERT(loaded.size() == 0);
+    }
+
+    UTEST_MAIN
+    {
+        test_persistence();
+    }
+
+UTEST_END;
+
+#endif /* USE_LIBFREETYPE */
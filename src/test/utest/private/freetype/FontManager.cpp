@@ -22,10 +22,13 @@
 #ifdef USE_LIBFREETYPE
 
 #include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/io/Dir.h>
 #include <lsp-plug.in/io/InFileStream.h>
 #include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/ipc/Thread.h>
 #include <lsp-plug.in/runtime/LSPString.h>
 #include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
 #include <lsp-plug.in/test-fw/utest.h>
 
 #include <private/freetype/FontManager.h>
@@ -79,6 +82,36 @@ namespace
 
         return 0;
     }
+
+    typedef struct glyph_target_t
+    {
+        dsp::bitmap_t  *bitmap;
+        ssize_t         x;
+        ssize_t         y;
+        size_t          count;
+    } glyph_target_t;
+
+    void put_glyph(void *arg, const ws::ft::glyph_t *glyph, ssize_t x, ssize_t y)
+    {
+        glyph_target_t *t = static_cast<glyph_target_t *>(arg);
+        switch (glyph->format)
+        {
+            case ws::ft::FMT_1_BPP:
+                dsp::bitmap_max_b1b8(t->bitmap, &glyph->bitmap, t->x + x, t->y + y);
+                break;
+            case ws::ft::FMT_2_BPP:
+                dsp::bitmap_max_b2b8(t->bitmap, &glyph->bitmap, t->x + x, t->y + y);
+                break;
+            case ws::ft::FMT_4_BPP:
+                dsp::bitmap_max_b4b8(t->bitmap, &glyph->bitmap, t->x + x, t->y + y);
+                break;
+            case ws::ft::FMT_8_BPP:
+            default:
+                dsp::bitmap_max_b8b8(t->bitmap, &glyph->bitmap, t->x + x, t->y + y);
+                break;
+        }
+        ++t->count;
+    }
 } /* namespace */;
 
 UTEST_BEGIN("ws.freetype", fontmanager)
@@ -103,6 +136,10 @@ UTEST_BEGIN("ws.freetype", fontmanager)
         UTEST_ASSERT(ifs.open(&path2) == STATUS_OK);
         UTEST_ASSERT(manager.add("test-2", &ifs) == STATUS_OK);
 
+        // Try to add missing font file
+        UTEST_ASSERT(path2.fmt("%s/font/missing-font.ttf", resources()) > 0);
+        UTEST_ASSERT(manager.add("test-3", &path2) != STATUS_OK);
+
         // Create aliases
         UTEST_ASSERT(manager.add_alias("alias-test-1", "test-1") == STATUS_OK);
         UTEST_ASSERT(manager.add_alias("alias-test-2", "test-2") == STATUS_OK);
@@ -219,6 +256,58 @@ UTEST_BEGIN("ws.freetype", fontmanager)
         UTEST_ASSERT(manager.remove("noto-sans") == STATUS_OK);
     }
 
+    void test_render_glyphs()
+    {
+        // Load font
+        ft::FontManager manager;
+        io::Path path;
+
+        printf("Testing rendering of glyph run\n");
+
+        // Initialize manager
+        UTEST_ASSERT(manager.init() == STATUS_OK);
+        lsp_finally { manager.destroy(); };
+        UTEST_ASSERT(path.fmt("%s/font/NotoSansDisplay-Regular.ttf", resources()) > 0);
+        UTEST_ASSERT(manager.add("noto-sans", &path) == STATUS_OK);
+
+        ws::Font f("noto-sans", 16.0f);
+        LSPString text;
+        UTEST_ASSERT(text.set_ascii("Glyph run should match the rendered text."));
+
+        // Render the reference bitmap
+        ft::text_range_t tp1, tp2;
+        dsp::bitmap_t *bitmap = manager.render_text(&f, &tp1, &text, 0, text.length());
+        UTEST_ASSERT(bitmap != NULL);
+        lsp_finally { ft::free_bitmap(bitmap); };
+
+        // Render the glyph run into the bitmap of the same size
+        glyph_target_t target;
+        target.bitmap   = ft::create_bitmap(bitmap->width, bitmap->height);
+        target.x        = -tp1.x_bearing;
+        target.y        = -tp1.y_bearing;
+        target.count    = 0;
+        UTEST_ASSERT(target.bitmap != NULL);
+        lsp_finally { ft::free_bitmap(target.bitmap); };
+
+        UTEST_ASSERT(manager.render_glyphs(&f, &tp2, &text, 0, text.length(), put_glyph, &target));
+        UTEST_ASSERT(target.count == text.length());
+
+        // Compare results
+        UTEST_ASSERT(tp1.x_bearing == tp2.x_bearing);
+        UTEST_ASSERT(tp1.y_bearing == tp2.y_bearing);
+        UTEST_ASSERT(tp1.width == tp2.width);
+        UTEST_ASSERT(tp1.height == tp2.height);
+        UTEST_ASSERT(tp1.x_advance == tp2.x_advance);
+        UTEST_ASSERT(tp1.y_advance == tp2.y_advance);
+        for (ssize_t y=0; y<bitmap->height; ++y)
+            UTEST_ASSERT(memcmp(&bitmap->data[y * bitmap->stride], &target.bitmap->data[y * target.bitmap->stride], bitmap->width) == 0);
+
+        // Empty text should not be rendered
+        UTEST_ASSERT(!manager.render_glyphs(&f, &tp2, &text, 0, 0, put_glyph, &target));
+
+        UTEST_ASSERT(manager.remove("noto-sans") == STATUS_OK);
+    }
+
     void test_cache_removal()
     {
         // Load font
@@ -259,17 +348,251 @@ UTEST_BEGIN("ws.freetype", fontmanager)
         printf("Used cache size:    %ld bytes\n", long(manager.used_cache_size()));
         printf("Face hit/miss:      %ld/%ld\n", long(manager.face_hits()), long(manager.face_misses()));
         printf("Glyph hit/miss/rm:  %ld/%ld/%ld\n", long(manager.glyph_hits()), long(manager.glyph_misses()), long(manager.glyph_removal()));
+        printf("Reserved cache size: %ld bytes\n", long(manager.reserved_cache_size()));
+        UTEST_ASSERT(manager.reserved_cache_size() >= manager.used_cache_size());
+
+        // Shrinking the cache should return memory to the system
+        manager.set_cache_limits(0, 0);
+        UTEST_ASSERT(manager.used_cache_size() == 0);
+        UTEST_ASSERT(manager.reserved_cache_size() == 0);
 
         // Remove the font
         UTEST_ASSERT(manager.remove("noto-sans") == STATUS_OK);
     }
 
+    void test_text_cache()
+    {
+        ft::FontManager manager;
+        io::Path path;
+
+        printf("Testing rendered text cache\n");
+
+        UTEST_ASSERT(manager.init() == STATUS_OK);
+        lsp_finally { manager.destroy(); };
+        UTEST_ASSERT(path.fmt("%s/font/NotoSansDisplay-Regular.ttf", resources()) > 0);
+        UTEST_ASSERT(manager.add("noto-sans", &path) == STATUS_OK);
+
+        ft::text_range_t tp1, tp2;
+        ws::Font f("noto-sans", 16.0f);
+        LSPString text;
+        UTEST_ASSERT(text.set_ascii("Cached text"));
+
+        // First rendering should put the text to the cache
+        dsp::bitmap_t *b1 = manager.render_text(&f, &tp1, &text, 0, text.length());
+        UTEST_ASSERT(b1 != NULL);
+        lsp_finally { ft::free_bitmap(b1); };
+        UTEST_ASSERT(manager.text_misses() == 1);
+        UTEST_ASSERT(manager.used_text_cache_size() > 0);
+
+        // Second rendering should return the same bitmap
+        dsp::bitmap_t *b2 = manager.render_text(&f, &tp2, &text, 0, text.length());
+        UTEST_ASSERT(b2 != NULL);
+        lsp_finally { ft::free_bitmap(b2); };
+        UTEST_ASSERT(b2 == b1);
+        UTEST_ASSERT(manager.text_hits() == 1);
+        UTEST_ASSERT(memcmp(&tp1, &tp2, sizeof(ft::text_range_t)) == 0);
+
+        // Substring should be rendered separately
+        dsp::bitmap_t *b3 = manager.render_text(&f, NULL, &text, 0, 6);
+        UTEST_ASSERT(b3 != NULL);
+        lsp_finally { ft::free_bitmap(b3); };
+        UTEST_ASSERT(b3 != b1);
+        UTEST_ASSERT(manager.text_misses() == 2);
+
+        // Bitmaps should remain valid after the font has been removed
+        UTEST_ASSERT(manager.remove("noto-sans") == STATUS_OK);
+        UTEST_ASSERT(manager.used_text_cache_size() == 0);
+        UTEST_ASSERT(ssize_t(b1->width) == tp1.width);
+    }
+
+    void test_prefetch()
+    {
+        ft::FontManager manager;
+        io::Path path;
+
+        printf("Testing background rasterization of glyphs\n");
+
+        UTEST_ASSERT(manager.init() == STATUS_OK);
+        lsp_finally { manager.destroy(); };
+        UTEST_ASSERT(path.fmt("%s/font/NotoSansDisplay-Regular.ttf", resources()) > 0);
+        UTEST_ASSERT(manager.add("noto-sans", &path) == STATUS_OK);
+
+        ws::Font f("noto-sans", 16.0f);
+        ws::Font missing("missing-font", 16.0f);
+        UTEST_ASSERT(manager.prefetch(&f, 'z', 'a') == STATUS_INVALID_VALUE);
+        UTEST_ASSERT(manager.prefetch(&missing, 'a', 'z') == STATUS_NOT_FOUND);
+
+        // Request printable ASCII characters and wait until they are rendered
+        UTEST_ASSERT(manager.prefetch(&f, 0x20, 0x7e) == STATUS_OK);
+        ws::font_parameters_t fp;
+        while (manager.prefetch_pending() > 0)
+        {
+            ipc::Thread::sleep(1);
+            UTEST_ASSERT(manager.get_font_parameters(&f, &fp));
+        }
+        UTEST_ASSERT(manager.used_cache_size() > 0);
+
+        // All glyphs should be taken from the cache
+        LSPString text;
+        ft::text_range_t tp;
+        UTEST_ASSERT(text.set_ascii("The quick brown fox jumps over the lazy dog 0123456789"));
+        manager.clear_cache_stats();
+        UTEST_ASSERT(manager.get_text_parameters(&f, &tp, &text, 0, text.length()));
+        UTEST_ASSERT(manager.glyph_misses() == 0);
+        UTEST_ASSERT(manager.glyph_hits() > 0);
+
+        // Second request should be satisfied by the cache
+        UTEST_ASSERT(manager.prefetch(&f, 0x20, 0x7e) == STATUS_OK);
+        UTEST_ASSERT(manager.prefetch_pending() == 0);
+
+        // Pending requests should not prevent the font from removal
+        UTEST_ASSERT(manager.prefetch(&f, 0x400, 0x4ff) == STATUS_OK);
+        UTEST_ASSERT(manager.remove("noto-sans") == STATUS_OK);
+    }
+
+    static void count_glyph(void *arg, const ft::glyph_t *glyph, ssize_t x, ssize_t y)
+    {
+        ++(*static_cast<size_t *>(arg));
+    }
+
+    void test_glyph_run()
+    {
+        ft::FontManager manager;
+        io::Path path;
+
+        printf("Testing layout of the glyph run\n");
+
+        UTEST_ASSERT(manager.init() == STATUS_OK);
+        lsp_finally { manager.destroy(); };
+        UTEST_ASSERT(path.fmt("%s/font/NotoSansDisplay-Regular.ttf", resources()) > 0);
+        UTEST_ASSERT(manager.add("noto-sans", &path) == STATUS_OK);
+
+        ft::text_range_t tp;
+        ft::GlyphRun run;
+        ws::Font f("noto-sans", 16.0f);
+        LSPString text;
+        UTEST_ASSERT(text.set_ascii("Laid out text"));
+
+        // The run should contain the same measurements as the text
+        UTEST_ASSERT(manager.get_text_parameters(&f, &tp, &text, 0, text.length()));
+        UTEST_ASSERT(manager.layout_text(&f, &run, &text, 0, text.length()));
+        UTEST_ASSERT(run.size() == text.length());
+        UTEST_ASSERT(memcmp(&tp, run.range(), sizeof(ft::text_range_t)) == 0);
+        UTEST_ASSERT(manager.is_valid(&run));
+
+        // Render the run several times
+        dsp::bitmap_t *b1 = manager.render_text(&run);
+        UTEST_ASSERT(b1 != NULL);
+        lsp_finally { ft::free_bitmap(b1); };
+        dsp::bitmap_t *b2 = manager.render_text(&f, NULL, &text, 0, text.length());
+        UTEST_ASSERT(b2 != NULL);
+        lsp_finally { ft::free_bitmap(b2); };
+        UTEST_ASSERT(b1->width == b2->width);
+        UTEST_ASSERT(b1->height == b2->height);
+        UTEST_ASSERT(memcmp(b1->data, b2->data, b1->stride * b1->height) == 0);
+
+        size_t count = 0;
+        UTEST_ASSERT(manager.render_glyphs(&run, count_glyph, &count));
+        UTEST_ASSERT(count == text.length());
+
+        // Empty run should not be rendered
+        UTEST_ASSERT(manager.layout_text(&f, &run, &text, 2, 2));
+        UTEST_ASSERT(run.size() == 0);
+        UTEST_ASSERT(manager.render_text(&run) == NULL);
+
+        // The run should become invalid after the glyph cache has been shrinked
+        UTEST_ASSERT(manager.layout_text(&f, &run, &text, 0, text.length()));
+        manager.set_cache_limits(0, 0);
+        UTEST_ASSERT(!manager.is_valid(&run));
+        UTEST_ASSERT(manager.render_text(&run) == NULL);
+        UTEST_ASSERT(!manager.render_glyphs(&run, count_glyph, &count));
+    }
+
+    void test_disk_cache()
+    {
+        io::Path path, cache;
+        ft::text_range_t tp1, tp2;
+        ws::Font f("noto-sans", 16.0f);
+        LSPString text;
+
+        printf("Testing persistent glyph cache\n");
+
+        UTEST_ASSERT(path.fmt("%s/font/NotoSansDisplay-Regular.ttf", resources()) > 0);
+        UTEST_ASSERT(cache.fmt("%s/%s-glyph-cache", tempdir(), name()) > 0);
+        UTEST_ASSERT(text.set_ascii("Persistent glyphs"));
+
+        // Render the text and write glyphs to disk
+        dsp::bitmap_t *b1 = NULL;
+        {
+            ft::FontManager manager;
+            UTEST_ASSERT(manager.init() == STATUS_OK);
+            lsp_finally { manager.destroy(); };
+            UTEST_ASSERT(!manager.disk_cache_enabled());
+            UTEST_ASSERT(manager.set_disk_cache(&cache) == STATUS_OK);
+            UTEST_ASSERT(manager.disk_cache_enabled());
+            UTEST_ASSERT(manager.add("noto-sans", &path) == STATUS_OK);
+
+            b1 = manager.render_text(&f, &tp1, &text, 0, text.length());
+            UTEST_ASSERT(b1 != NULL);
+            UTEST_ASSERT(manager.flush_disk_cache() == STATUS_OK);
+        }
+        lsp_finally { ft::free_bitmap(b1); };
+
+        // Only strike files should remain in the cache directory
+        {
+            io::Dir dir;
+            LSPString item, tmp_ext, strike_ext;
+            size_t strikes = 0;
+            UTEST_ASSERT(tmp_ext.set_ascii(".tmp"));
+            UTEST_ASSERT(strike_ext.set_ascii(".glyphs"));
+            UTEST_ASSERT(dir.open(&cache) == STATUS_OK);
+            while (dir.read(&item, false) == STATUS_OK)
+            {
+                if ((item.equals_ascii(".")) || (item.equals_ascii("..")))
+                    continue;
+                UTEST_ASSERT_MSG(item.index_of(&tmp_ext) < 0, "Temporary file left: %s", item.get_native());
+                if (item.index_of(&strike_ext) > 0)
+                    ++strikes;
+            }
+            dir.close();
+            UTEST_ASSERT(strikes > 0);
+        }
+
+        // Other font manager should load glyphs from disk instead of rendering them
+        ft::FontManager manager;
+        UTEST_ASSERT(manager.init() == STATUS_OK);
+        lsp_finally { manager.destroy(); };
+        UTEST_ASSERT(manager.set_disk_cache(&cache) == STATUS_OK);
+        UTEST_ASSERT(manager.add("noto-sans", &path) == STATUS_OK);
+
+        dsp::bitmap_t *b2 = manager.render_text(&f, &tp2, &text, 0, text.length());
+        UTEST_ASSERT(b2 != NULL);
+        lsp_finally { ft::free_bitmap(b2); };
+
+        UTEST_ASSERT(manager.glyph_misses() > 0);
+        UTEST_ASSERT(manager.disk_hits() == manager.glyph_misses());
+        UTEST_ASSERT(manager.disk_misses() == 0);
+        UTEST_ASSERT(memcmp(&tp1, &tp2, sizeof(ft::text_range_t)) == 0);
+        UTEST_ASSERT(b1->width == b2->width);
+        UTEST_ASSERT(b1->height == b2->height);
+        UTEST_ASSERT(memcmp(b1->data, b2->data, b1->stride * b1->height) == 0);
+
+        // Disabled cache should not be used
+        UTEST_ASSERT(manager.set_disk_cache(NULL) == STATUS_OK);
+        UTEST_ASSERT(!manager.disk_cache_enabled());
+    }
+
     UTEST_MAIN
     {
         test_load_font();
         test_render_text();
         test_fail_render_text();
+        test_render_glyphs();
         test_cache_removal();
+        test_text_cache();
+        test_prefetch();
+        test_glyph_run();
+        test_disk_cache();
     }
 
 UTEST_END;
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/test-fw/utest.h>
+
+#include <private/freetype/GlyphAllocator.h>
+
+using namespace lsp::ws;
+
+UTEST_BEGIN("ws.freetype", glyphallocator)
+
+    static constexpr size_t COUNT       = 1000;
+
+    void test_allocate()
+    {
+        printf("Testing allocation and release of glyphs\n");
+
+        ft::GlyphAllocator alloc;
+        lsp::lltl::parray<ft::glyph_t> glyphs;
+        size_t used = 0;
+
+        // Allocate glyphs of different sizes and fill them with data
+        for (size_t i=0; i<COUNT; ++i)
+        {
+            const size_t size   = sizeof(ft::glyph_t) + (i * 7) % 3000;
+            ft::glyph_t *glyph  = alloc.allocate(size);
+            UTEST_ASSERT(glyph != NULL);
+            UTEST_ASSERT(glyph->slab != NULL);
+            UTEST_ASSERT(glyph->szof >= size);
+            memset(&glyph[1], int(i & 0xff), size - sizeof(ft::glyph_t));
+            UTEST_ASSERT(glyphs.add(glyph));
+            used               += glyph->szof;
+        }
+
+        UTEST_ASSERT(alloc.used() == used);
+        UTEST_ASSERT(alloc.reserved() >= used);
+        UTEST_ASSERT(alloc.slabs() > 0);
+
+        // Check that glyphs do not overlap
+        for (size_t i=0; i<COUNT; ++i)
+        {
+            const ft::glyph_t *glyph    = glyphs.uget(i);
+            const uint8_t *data         = reinterpret_cast<const uint8_t *>(&glyph[1]);
+            const size_t size           = (i * 7) % 3000;
+            for (size_t j=0; j<size; ++j)
+                UTEST_ASSERT(data[j] == (i & 0xff));
+        }
+
+        // Release every second glyph, slabs should not be released
+        const size_t reserved   = alloc.reserved();
+        for (size_t i=0; i<COUNT; i += 2)
+        {
+            ft::glyph_t *glyph  = glyphs.uget(i);
+            used               -= glyph->szof;
+            ft::GlyphAllocator::release(glyph);
+        }
+        UTEST_ASSERT(alloc.used() == used);
+        UTEST_ASSERT(alloc.reserved() == reserved);
+
+        // Released slots should be reused
+        for (size_t i=0; i<COUNT; i += 2)
+        {
+            ft::glyph_t *glyph  = alloc.allocate(sizeof(ft::glyph_t) + (i * 7) % 3000);
+            UTEST_ASSERT(glyph != NULL);
+            glyphs.set(i, glyph);
+            used               += glyph->szof;
+        }
+        UTEST_ASSERT(alloc.used() == used);
+        UTEST_ASSERT(alloc.reserved() == reserved);
+
+        // Release all glyphs, empty slabs should be returned by trim()
+        for (size_t i=0; i<COUNT; ++i)
+            ft::GlyphAllocator::release(glyphs.uget(i));
+        UTEST_ASSERT(alloc.used() == 0);
+        UTEST_ASSERT(alloc.reserved() == reserved);
+        UTEST_ASSERT(alloc.trim() == reserved);
+        UTEST_ASSERT(alloc.reserved() == 0);
+        UTEST_ASSERT(alloc.slabs() == 0);
+    }
+
+    void test_large()
+    {
+        printf("Testing allocation of large glyphs\n");
+
+        ft::GlyphAllocator alloc;
+
+        ft::glyph_t *glyph  = alloc.allocate(0x10000);
+        UTEST_ASSERT(glyph != NULL);
+        UTEST_ASSERT(glyph->szof == 0x10000);
+        UTEST_ASSERT(alloc.used() == 0x10000);
+        UTEST_ASSERT(alloc.reserved() > 0x10000);
+        UTEST_ASSERT(alloc.slabs() == 1);
+
+        // Dedicated slab should be released immediately
+        ft::GlyphAllocator::release(glyph);
+        UTEST_ASSERT(alloc.used() == 0);
+        UTEST_ASSERT(alloc.reserved() == 0);
+        UTEST_ASSERT(alloc.slabs() == 0);
+    }
+
+    void test_move()
+    {
+        printf("Testing moving of glyphs from heap\n");
+
+        ft::GlyphAllocator alloc;
+
+        // Create heap glyph
+        const size_t bytes  = 12 * 16;
+        const size_t size   = sizeof(ft::glyph_t) + DEFAULT_ALIGN + bytes;
+        uint8_t *buf        = static_cast<uint8_t *>(malloc(size));
+        UTEST_ASSERT(buf != NULL);
+        ft::glyph_t *glyph  = reinterpret_cast<ft::glyph_t *>(buf);
+        bzero(glyph, sizeof(ft::glyph_t));
+        glyph->slab         = NULL;
+        glyph->szof         = size;
+        glyph->codepoint    = 'A';
+        glyph->bitmap.width = 12;
+        glyph->bitmap.height= 16;
+        glyph->bitmap.stride= 12;
+        glyph->bitmap.data  = lsp::align_ptr(&buf[sizeof(ft::glyph_t)], DEFAULT_ALIGN);
+        for (size_t i=0; i<bytes; ++i)
+            glyph->bitmap.data[i]   = uint8_t(i);
+
+        // Move glyph to the slab
+        ft::glyph_t *moved  = alloc.move(glyph);
+        UTEST_ASSERT(moved != NULL);
+        lsp_finally { ft::GlyphAllocator::release(moved); };
+        UTEST_ASSERT(moved->slab != NULL);
+        UTEST_ASSERT(moved->szof >= size);
+        UTEST_ASSERT(alloc.used() == moved->szof);
+        UTEST_ASSERT(moved->codepoint == 'A');
+        UTEST_ASSERT(moved->bitmap.width == 12);
+        UTEST_ASSERT(moved->bitmap.height == 16);
+        for (size_t i=0; i<bytes; ++i)
+            UTEST_ASSERT(moved->bitmap.data[i] == uint8_t(i));
+
+        // Glyph already in the slab should not be moved
+        UTEST_ASSERT(alloc.move(moved) == moved);
+    }
+
+    UTEST_MAIN
+    {
+        test_allocate();
+        test_large();
+        test_move();
+    }
+
+UTEST_END;
+
+#endif /* USE_LIBFREETYPE */
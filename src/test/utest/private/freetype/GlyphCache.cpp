@@ -25,71 +25,98 @@
 #include <lsp-plug.in/runtime/LSPString.h>
 #include <lsp-plug.in/test-fw/utest.h>
 
+#include <private/freetype/face.h>
 #include <private/freetype/GlyphCache.h>
 
 using namespace lsp::ws;
 
 UTEST_BEGIN("ws.freetype", glyphcache)
 
+    static constexpr const char *GLYPHS = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ[]{}/?.";
+
+    ft::glyph_t *make_glyphs(const char *text, ft::face_t *face)
+    {
+        size_t count = strlen(text);
+        ft::glyph_t *vglyphs = new ft::glyph_t[count];
+        if (vglyphs == NULL)
+            return NULL;
+
+        for (size_t i=0; i<count; ++i)
+        {
+            vglyphs[i].face         = face;
+            vglyphs[i].codepoint    = text[i];
+            vglyphs[i].cache_next   = NULL;
+        }
+
+        return vglyphs;
+    }
+
     void test_add_get()
     {
         printf("Testing adding and getting operations\n");
 
-        const char *glyphs="0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ[]{}/?.";
+        ft::face_t faces[2];
         ft::GlyphCache cache;
 
-        size_t count = strlen(glyphs);
-        ft::glyph_t *vglyphs = new ft::glyph_t[count];
-        UTEST_ASSERT(vglyphs != NULL);
-        lsp_finally { delete [] vglyphs; };
+        size_t count = strlen(GLYPHS);
+        ft::glyph_t *vglyphs1 = make_glyphs(GLYPHS, &faces[0]);
+        UTEST_ASSERT(vglyphs1 != NULL);
+        lsp_finally { delete [] vglyphs1; };
+        ft::glyph_t *vglyphs2 = make_glyphs(GLYPHS, &faces[1]);
+        UTEST_ASSERT(vglyphs2 != NULL);
+        lsp_finally { delete [] vglyphs2; };
 
         // Put all glyphs to the cache
         for (size_t i=0; i<count; ++i)
         {
-            ft::glyph_t *glyph  = &vglyphs[i];
-            glyph->codepoint    = glyphs[i];
-            UTEST_ASSERT_MSG(cache.put(glyph), "Failed to put glyph '%c'", glyphs[i]);
+            UTEST_ASSERT_MSG(cache.put(&vglyphs1[i]), "Failed to put glyph '%c'", GLYPHS[i]);
+            UTEST_ASSERT_MSG(cache.put(&vglyphs2[i]), "Failed to put glyph '%c'", GLYPHS[i]);
         }
 
-        UTEST_ASSERT(cache.size() == count);
+        UTEST_ASSERT(cache.size() == count * 2);
+        UTEST_ASSERT(cache.capacity() >= count * 4);
 
-        // Check that all glyphs are present the cache
+        // Check that all glyphs are present the cache and keyed by face
         for (size_t i=0; i<count; ++i)
         {
-            ft::glyph_t *glyph  = &vglyphs[i];
-            UTEST_ASSERT(cache.get(glyph->codepoint) == glyph);
+            UTEST_ASSERT(cache.get(&faces[0], GLYPHS[i]) == &vglyphs1[i]);
+            UTEST_ASSERT(cache.get(&faces[1], GLYPHS[i]) == &vglyphs2[i]);
+            UTEST_ASSERT(cache.contains(&faces[0], GLYPHS[i]));
         }
+        UTEST_ASSERT(!cache.contains(&faces[0], '!'));
     }
 
     void test_add_remove()
     {
         printf("Testing adding and removing operations\n");
 
-        const char *glyphs="0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ[]{}/?.";
+        ft::face_t face;
         ft::GlyphCache cache;
 
-        size_t count = strlen(glyphs);
-        ft::glyph_t *vglyphs = new ft::glyph_t[count];
+        size_t count = strlen(GLYPHS);
+        ft::glyph_t *vglyphs = make_glyphs(GLYPHS, &face);
         UTEST_ASSERT(vglyphs != NULL);
         lsp_finally { delete [] vglyphs; };
 
         // Put all glyphs to the cache
         for (size_t i=0; i<count; ++i)
-        {
-            ft::glyph_t *glyph  = &vglyphs[i];
-            glyph->codepoint    = glyphs[i];
-            UTEST_ASSERT(cache.put(glyph));
-        }
+            UTEST_ASSERT(cache.put(&vglyphs[i]));
 
         UTEST_ASSERT(cache.size() == count);
 
-        // Remove all glyphs from the cache
+        // Remove every second glyph and check that others are still accessible
+        for (size_t i=0; i<count; i += 2)
+            UTEST_ASSERT(cache.remove(&vglyphs[i]));
         for (size_t i=0; i<count; ++i)
         {
-            ft::glyph_t *glyph  = &vglyphs[i];
-            UTEST_ASSERT(cache.remove(glyph));
+            ft::glyph_t *glyph  = cache.get(&face, GLYPHS[i]);
+            UTEST_ASSERT(glyph == ((i & 1) ? &vglyphs[i] : NULL));
         }
 
+        // Remove all other glyphs from the cache
+        for (size_t i=1; i<count; i += 2)
+            UTEST_ASSERT(cache.remove(&vglyphs[i]));
+
         UTEST_ASSERT(cache.size() == 0);
     }
 
@@ -97,28 +124,24 @@ UTEST_BEGIN("ws.freetype", glyphcache)
     {
         printf("Testing clear operation\n");
 
-        const char *glyphs="0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ[]{}/?.";
         LSPString list;
+        ft::face_t face;
         ft::GlyphCache cache;
 
-        size_t count = strlen(glyphs);
-        ft::glyph_t *vglyphs = new ft::glyph_t[count];
+        size_t count = strlen(GLYPHS);
+        ft::glyph_t *vglyphs = make_glyphs(GLYPHS, &face);
         UTEST_ASSERT(vglyphs != NULL);
         lsp_finally { delete [] vglyphs; };
 
         // Put all glyphs to the cache
         for (size_t i=0; i<count; ++i)
-        {
-            ft::glyph_t *glyph  = &vglyphs[i];
-            glyph->codepoint    = glyphs[i];
-            UTEST_ASSERT(cache.put(glyph));
-        }
+            UTEST_ASSERT(cache.put(&vglyphs[i]));
 
         UTEST_ASSERT(cache.size() == count);
 
         // Remove all glyphs from the cache
         ft::glyph_t *root   = cache.clear();
-        UTEST_ASSERT(list.set_ascii(glyphs));
+        UTEST_ASSERT(list.set_ascii(GLYPHS));
         UTEST_ASSERT(cache.size() == 0);
 
         for ( ; root != NULL; root = root->cache_next)
@@ -131,23 +154,122 @@ UTEST_BEGIN("ws.freetype", glyphcache)
         UTEST_ASSERT(list.is_empty());
     }
 
+    void test_remove_face()
+    {
+        printf("Testing removal of the face\n");
+
+        LSPString list;
+        ft::face_t faces[2];
+        ft::GlyphCache cache;
+
+        size_t count = strlen(GLYPHS);
+        ft::glyph_t *vglyphs1 = make_glyphs(GLYPHS, &faces[0]);
+        UTEST_ASSERT(vglyphs1 != NULL);
+        lsp_finally { delete [] vglyphs1; };
+        ft::glyph_t *vglyphs2 = make_glyphs(GLYPHS, &faces[1]);
+        UTEST_ASSERT(vglyphs2 != NULL);
+        lsp_finally { delete [] vglyphs2; };
+
+        for (size_t i=0; i<count; ++i)
+        {
+            UTEST_ASSERT(cache.put(&vglyphs1[i]));
+            UTEST_ASSERT(cache.put(&vglyphs2[i]));
+        }
+
+        // Remove glyphs of the first face
+        ft::glyph_t *root   = cache.remove_face(&faces[0]);
+        UTEST_ASSERT(list.set_ascii(GLYPHS));
+        UTEST_ASSERT(cache.size() == count);
+
+        for ( ; root != NULL; root = root->cache_next)
+        {
+            UTEST_ASSERT(root->face == &faces[0]);
+            ssize_t idx = list.index_of(root->codepoint);
+            UTEST_ASSERT(idx >= 0);
+            UTEST_ASSERT(list.remove(idx, idx + 1));
+        }
+        UTEST_ASSERT(list.is_empty());
+
+        // Glyphs of the second face should remain
+        for (size_t i=0; i<count; ++i)
+        {
+            UTEST_ASSERT(cache.get(&faces[0], GLYPHS[i]) == NULL);
+            UTEST_ASSERT(cache.get(&faces[1], GLYPHS[i]) == &vglyphs2[i]);
+        }
+        UTEST_ASSERT(cache.remove_face(&faces[0]) == NULL);
+    }
+
+    void test_evict()
+    {
+        printf("Testing eviction of glyphs\n");
+
+        ft::face_t face;
+        ft::GlyphCache cache;
+        UTEST_ASSERT(cache.evict() == NULL);
+
+        const char *text    = "0123456789abcdefghijklmnopqrstuv";
+        size_t count        = strlen(text);
+        ft::glyph_t *vglyphs = make_glyphs(text, &face);
+        UTEST_ASSERT(vglyphs != NULL);
+        lsp_finally { delete [] vglyphs; };
+
+        for (size_t i=0; i<count; ++i)
+            UTEST_ASSERT(cache.put(&vglyphs[i]));
+
+        // First eviction clears the reference bits of all glyphs
+        ft::glyph_t *glyph  = cache.evict();
+        UTEST_ASSERT(glyph != NULL);
+        UTEST_ASSERT(cache.size() == count - 1);
+
+        // Reference digits that remain in the cache, they should have a second chance
+        size_t used         = 0;
+        for (size_t i=0; i<10; ++i)
+        {
+            if (cache.get(&face, text[i]) != NULL)
+                ++used;
+        }
+
+        // Other glyphs should be evicted first
+        for (size_t i=0, n=count - 1 - used; i<n; ++i)
+        {
+            glyph   = cache.evict();
+            UTEST_ASSERT(glyph != NULL);
+            UTEST_ASSERT_MSG((glyph->codepoint < '0') || (glyph->codepoint > '9'),
+                "Evicted referenced glyph '%c'", char(glyph->codepoint));
+            UTEST_ASSERT(cache.get(&face, glyph->codepoint) == NULL);
+        }
+        UTEST_ASSERT(cache.size() == used);
+
+        // Now referenced glyphs should be evicted
+        for (size_t i=0; i<used; ++i)
+            UTEST_ASSERT(cache.evict() != NULL);
+        UTEST_ASSERT(cache.size() == 0);
+        UTEST_ASSERT(cache.evict() == NULL);
+    }
+
     void test_invalid_operations()
     {
         printf("Testing invalid operations\n");
 
+        ft::face_t face;
         ft::GlyphCache cache;
         ft::glyph_t vglyphs[2];
+        vglyphs[0].face         = &face;
         vglyphs[0].codepoint    = 'A';
+        vglyphs[1].face         = &face;
         vglyphs[1].codepoint    = 'B';
 
+        UTEST_ASSERT(cache.get(&face, 'A') == NULL);
+        UTEST_ASSERT(!cache.remove(&vglyphs[0]));
+
         UTEST_ASSERT(cache.put(&vglyphs[0]));
         UTEST_ASSERT(cache.put(&vglyphs[1]));
         UTEST_ASSERT(!cache.put(&vglyphs[0]));
         UTEST_ASSERT(!cache.put(&vglyphs[1]));
 
-        UTEST_ASSERT(cache.get('A') == &vglyphs[0]);
-        UTEST_ASSERT(cache.get('B') == &vglyphs[1]);
-        UTEST_ASSERT(cache.get('C') == NULL);
+        UTEST_ASSERT(cache.get(&face, 'A') == &vglyphs[0]);
+        UTEST_ASSERT(cache.get(&face, 'B') == &vglyphs[1]);
+        UTEST_ASSERT(cache.get(&face, 'C') == NULL);
 
         UTEST_ASSERT(cache.remove(&vglyphs[0]));
         UTEST_ASSERT(cache.remove(&vglyphs[1]));
@@ -160,6 +282,8 @@ UTEST_BEGIN("ws.freetype", glyphcache)
         test_add_get();
         test_add_remove();
         test_clear();
+        test_remove_face();
+        test_evict();
         test_invalid_operations();
     }
 
@@ -168,3 +292,4 @@ UTEST_END;
 #endif /* USE_LIBFREETYPE */
 
 
+
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/test-fw/utest.h>
+
+#include <private/freetype/bitmap.h>
+#include <private/freetype/TextCache.h>
+
+using namespace lsp::ws;
+
+UTEST_BEGIN("ws.freetype", textcache)
+
+    static constexpr size_t LENGTH      = 16;
+
+    void make_text(lsp::lsp_wchar_t *text, size_t shift)
+    {
+        for (size_t i=0; i<LENGTH; ++i)
+            text[i]             = 'A' + ((i + shift) % 26);
+    }
+
+    void make_range(ft::text_range_t *r, ssize_t value)
+    {
+        r->x_bearing        = value;
+        r->y_bearing        = -value;
+        r->width            = value * 2;
+        r->height           = value * 3;
+        r->x_advance        = value * 4;
+        r->y_advance        = value * 5;
+    }
+
+    void test_lookup()
+    {
+        printf("Testing lookup...\n");
+
+        ft::face_t faces[2];
+        lsp::lsp_wchar_t text[LENGTH];
+        ft::text_range_t range;
+
+        make_text(text, 0);
+        make_range(&range, 10);
+
+        dsp::bitmap_t *bitmap   = ft::create_bitmap(64, 16);
+        UTEST_ASSERT(bitmap != NULL);
+        lsp_finally { ft::free_bitmap(bitmap); };
+
+        ft::TextCache cache;
+        const uint32_t hash = ft::TextCache::hash(&faces[0], text, LENGTH);
+
+        UTEST_ASSERT(cache.get(hash, &faces[0], text, LENGTH) == NULL);
+        UTEST_ASSERT(cache.put(hash, &faces[0], text, LENGTH, bitmap, &range));
+        UTEST_ASSERT(cache.size() > 0);
+
+        // Lookup the text
+        const ft::TextCache::text_t *t = cache.get(hash, &faces[0], text, LENGTH);
+        UTEST_ASSERT(t != NULL);
+        UTEST_ASSERT(t->bitmap == bitmap);
+        UTEST_ASSERT(t->length == LENGTH);
+        UTEST_ASSERT(t->range.width == 20);
+        UTEST_ASSERT(t->range.y_advance == 50);
+
+        // Different face, length or text should not match
+        UTEST_ASSERT(cache.get(hash, &faces[1], text, LENGTH) == NULL);
+        UTEST_ASSERT(cache.get(hash, &faces[0], text, LENGTH - 1) == NULL);
+        text[5]    += 1;
+        UTEST_ASSERT(cache.get(hash, &faces[0], text, LENGTH) == NULL);
+
+        UTEST_ASSERT(cache.hits() == 1);
+        UTEST_ASSERT(cache.misses() == 4);
+        cache.clear_stats();
+        UTEST_ASSERT(cache.hits() == 0);
+        UTEST_ASSERT(cache.misses() == 0);
+
+        // Drop text of the face
+        make_text(text, 0);
+        cache.remove_face(&faces[1]);
+        UTEST_ASSERT(cache.get(hash, &faces[0], text, LENGTH) != NULL);
+        cache.remove_face(&faces[0]);
+        UTEST_ASSERT(cache.get(hash, &faces[0], text, LENGTH) == NULL);
+        UTEST_ASSERT(cache.size() == 0);
+    }
+
+    void test_bitmaps()
+    {
+        printf("Testing bitmap references...\n");
+
+        ft::face_t face;
+        lsp::lsp_wchar_t text[LENGTH];
+        ft::text_range_t range;
+
+        make_text(text, 0);
+        make_range(&range, 1);
+
+        dsp::bitmap_t *small    = ft::create_bitmap(16, 4);
+        UTEST_ASSERT(small != NULL);
+        dsp::bitmap_t *large    = ft::create_bitmap(1024, 256);
+        UTEST_ASSERT(large != NULL);
+        lsp_finally { ft::free_bitmap(large); };
+        small->data[0]          = 0x55;
+        small->data[small->stride * small->height - 1] = 0xaa;
+
+        // The size of the bitmap is accounted in the cache size
+        const size_t max_size   = size_t(large->stride) * large->height;
+        ft::TextCache cache(max_size);
+        const uint32_t hash     = ft::TextCache::hash(&face, text, LENGTH);
+        UTEST_ASSERT(cache.put(hash, &face, text, LENGTH, small, &range));
+        UTEST_ASSERT(cache.size() >= size_t(small->stride) * small->height);
+
+        // The cache keeps the bitmap alive after the caller has released it
+        ft::free_bitmap(small);
+        const ft::TextCache::text_t *t = cache.get(hash, &face, text, LENGTH);
+        UTEST_ASSERT(t != NULL);
+        UTEST_ASSERT(t->bitmap == small);
+        UTEST_ASSERT(t->bitmap->data[0] == 0x55);
+        UTEST_ASSERT(t->bitmap->data[t->bitmap->stride * t->bitmap->height - 1] == 0xaa);
+
+        // Text with the bitmap larger than a quarter of the cache is not cached
+        make_text(text, 1);
+        const uint32_t lhash    = ft::TextCache::hash(&face, text, LENGTH);
+        const size_t size       = cache.size();
+        UTEST_ASSERT(!cache.put(lhash, &face, text, LENGTH, large, &range));
+        UTEST_ASSERT(cache.size() == size);
+        UTEST_ASSERT(cache.get(lhash, &face, text, LENGTH) == NULL);
+
+        // Shrinking the cache releases the bitmap
+        UTEST_ASSERT(cache.set_max_size(0) == max_size);
+        UTEST_ASSERT(cache.size() == 0);
+    }
+
+    void test_remove_face()
+    {
+        printf("Testing removal of the face...\n");
+
+        ft::face_t faces[3];
+        lsp::lsp_wchar_t text[LENGTH];
+        ft::text_range_t range;
+
+        make_range(&range, 1);
+        dsp::bitmap_t *bitmap   = ft::create_bitmap(16, 16);
+        UTEST_ASSERT(bitmap != NULL);
+        lsp_finally { ft::free_bitmap(bitmap); };
+
+        // Interleave texts of different faces in the LRU list
+        ft::TextCache cache;
+        for (size_t i=0; i<12; ++i)
+        {
+            ft::face_t *face    = &faces[i % 3];
+            make_text(text, i / 3);
+            UTEST_ASSERT(cache.put(ft::TextCache::hash(face, text, LENGTH), face, text, LENGTH, bitmap, &range));
+        }
+        const size_t size = cache.size();
+
+        cache.remove_face(&faces[1]);
+        UTEST_ASSERT(cache.size() == size - size / 3);
+        for (size_t i=0; i<12; ++i)
+        {
+            ft::face_t *face    = &faces[i % 3];
+            make_text(text, i / 3);
+            const ft::TextCache::text_t *t = cache.get(ft::TextCache::hash(face, text, LENGTH), face, text, LENGTH);
+            UTEST_ASSERT((t == NULL) == (face == &faces[1]));
+            if (t != NULL)
+                UTEST_ASSERT(t->face == face);
+        }
+
+        cache.clear();
+        UTEST_ASSERT(cache.size() == 0);
+    }
+
+    UTEST_MAIN
+    {
+        test_lookup();
+        test_bitmaps();
+        test_remove_face();
+    }
+
+UTEST_END;
+
+#endif /* USE_LIBFREETYPE */
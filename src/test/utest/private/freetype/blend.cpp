@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2023 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2023 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 2 мая 2023 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_LIBFREETYPE
+
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/test-fw/utest.h>
+
+#include <private/freetype/blend.h>
+
+using namespace lsp::ws;
+
+UTEST_BEGIN("ws.freetype", blend)
+
+    static constexpr size_t WIDTH       = 37;
+    static constexpr size_t HEIGHT      = 5;
+    static constexpr size_t IMG_WIDTH   = 48;
+    static constexpr size_t IMG_HEIGHT  = 8;
+
+    static uint32_t div_255(uint32_t v)
+    {
+        return (v + 127) / 255;
+    }
+
+    static uint32_t ref_blend(uint32_t d, uint32_t cov, uint32_t color)
+    {
+        uint32_t res    = 0;
+        const uint32_t sa   = div_255((color >> 24) * cov);
+        for (size_t shift = 0; shift < 32; shift += 8)
+        {
+            const uint32_t s    = div_255(((color >> shift) & 0xff) * cov);
+            const uint32_t dc   = (d >> shift) & 0xff;
+            res                |= (s + div_255(dc * (0xff - sa))) << shift;
+        }
+        return res;
+    }
+
+    static uint32_t coverage(ft::glyph_format_t format, size_t x, size_t y)
+    {
+        const size_t v = x * 7 + y * 3;
+        switch (format)
+        {
+            case ft::FMT_1_BPP: return (v & 1) * 0xff;
+            case ft::FMT_2_BPP: return (v & 3) * 0x55;
+            case ft::FMT_4_BPP: return (v & 0xf) * 0x11;
+            default: break;
+        }
+        return (v * 13) & 0xff;
+    }
+
+    void make_glyph(ft::glyph_t *glyph, uint8_t *data, ft::glyph_format_t format)
+    {
+        const size_t bits   = 1 << format;
+        const size_t stride = (WIDTH * bits + 7) >> 3;
+
+        bzero(glyph, sizeof(ft::glyph_t));
+        bzero(data, stride * HEIGHT);
+        glyph->format           = format;
+        glyph->bitmap.width     = WIDTH;
+        glyph->bitmap.height    = HEIGHT;
+        glyph->bitmap.stride    = stride;
+        glyph->bitmap.data      = data;
+
+        // Pack coverage values, most significant bits first
+        const uint32_t mask     = (1 << bits) - 1;
+        for (size_t y=0; y<HEIGHT; ++y)
+            for (size_t x=0; x<WIDTH; ++x)
+            {
+                const uint32_t v    = (coverage(format, x, y) * mask) / 0xff;
+                const size_t bit    = x * bits;
+                data[y * stride + (bit >> 3)]  |= v << (8 - bits - (bit & 7));
+            }
+    }
+
+    void test_format(ft::glyph_format_t format, uint32_t color)
+    {
+        uint32_t image[IMG_WIDTH * IMG_HEIGHT];
+        uint8_t data[WIDTH * HEIGHT];
+        ft::glyph_t glyph;
+        make_glyph(&glyph, data, format);
+
+        for (size_t i=0; i<IMG_WIDTH * IMG_HEIGHT; ++i)
+            image[i]        = 0x80402010 + i;
+
+        // Blend the glyph with clipping
+        const ssize_t gx = 3, gy = 1;
+        const ssize_t l = 5, t = 2, r = 30, b = 7;
+        UTEST_ASSERT(ft::blend_glyph(
+            reinterpret_cast<uint8_t *>(image), IMG_WIDTH * sizeof(uint32_t),
+            &glyph, gx, gy, l, t, r, b, color));
+
+        for (size_t y=0; y<IMG_HEIGHT; ++y)
+            for (size_t x=0; x<IMG_WIDTH; ++x)
+            {
+                const uint32_t src  = 0x80402010 + y * IMG_WIDTH + x;
+                uint32_t expected   = src;
+                if ((ssize_t(x) >= l) && (ssize_t(x) < r) && (ssize_t(y) >= t) && (ssize_t(y) < b) &&
+                    (ssize_t(x) >= gx) && (ssize_t(x) < gx + ssize_t(WIDTH)) &&
+                    (ssize_t(y) >= gy) && (ssize_t(y) < gy + ssize_t(HEIGHT)))
+                    expected            = ref_blend(src, coverage(format, x - gx, y - gy), color);
+
+                UTEST_ASSERT_MSG(image[y * IMG_WIDTH + x] == expected,
+                    "format=%d, x=%d, y=%d: got 0x%08x, expected 0x%08x",
+                    int(format), int(x), int(y), image[y * IMG_WIDTH + x], expected);
+            }
+
+        // Glyph outside of the clipping rectangle should not be drawn
+        UTEST_ASSERT(!ft::blend_glyph(
+            reinterpret_cast<uint8_t *>(image), IMG_WIDTH * sizeof(uint32_t),
+            &glyph, 40, 0, l, t, r, b, color));
+    }
+
+    UTEST_MAIN
+    {
+        const uint32_t opaque       = ft::premultiply_color(1.0f, 0.5f, 0.25f, 1.0f);
+        const uint32_t translucent  = ft::premultiply_color(1.0f, 0.5f, 0.25f, 0.5f);
+        UTEST_ASSERT(opaque == 0xffff8040);
+        UTEST_ASSERT(translucent == 0x80804020);
+
+        printf("Testing blending of glyphs with opaque colour\n");
+        test_format(ft::FMT_1_BPP, opaque);
+        test_format(ft::FMT_2_BPP, opaque);
+        test_format(ft::FMT_4_BPP, opaque);
+        test_format(ft::FMT_8_BPP, opaque);
+
+        printf("Testing blending of glyphs with translucent colour\n");
+        test_format(ft::FMT_1_BPP, translucent);
+        test_format(ft::FMT_2_BPP, translucent);
+        test_format(ft::FMT_4_BPP, translucent);
+        test_format(ft::FMT_8_BPP, translucent);
+    }
+
+UTEST_END;
+
+#endif /* USE_LIBFREETYPE */
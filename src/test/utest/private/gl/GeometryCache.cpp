@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/gl/defs.h>
+
+#ifdef LSP_PLUGINS_USE_OPENGL
+
+#include <lsp-plug.in/test-fw/utest.h>
+
+#include <private/gl/GeometryCache.h>
+
+UTEST_BEGIN("ws.gl", geometrycache)
+
+    static constexpr size_t POINTS      = 32;
+
+    void make_polyline(float *coords, float shift)
+    {
+        for (size_t i=0; i<POINTS; ++i)
+        {
+            coords[i]           = i * 10.0f + shift;
+            coords[i + POINTS]  = (i & 1) * 5.0f;
+        }
+    }
+
+    void make_geometry(lsp::ws::gl::vertex_t *v, uint16_t *idx, size_t nv, size_t ni, uint32_t vi)
+    {
+        for (size_t i=0; i<nv; ++i)
+        {
+            v[i].x              = float(i);
+            v[i].y              = float(i * 2);
+            v[i].s              = 0.0f;
+            v[i].t              = 0.0f;
+            v[i].cmd            = 42;
+        }
+        for (size_t i=0; i<ni; ++i)
+            idx[i]              = uint16_t(vi + (i % nv));
+    }
+
+    void test_lookup()
+    {
+        printf("Testing lookup...\n");
+
+        float coords[POINTS * 2];
+        lsp::ws::gl::vertex_t v[16];
+        uint16_t idx[24];
+        lsp::ws::gl::clip_rect_t rect = { 0.0f, 0.0f, 310.0f, 5.0f };
+
+        make_polyline(coords, 0.0f);
+        make_geometry(v, idx, 16, 24, 100);
+
+        lsp::ws::gl::GeometryCache cache;
+        const uint32_t hash = lsp::ws::gl::GeometryCache::hash(coords, POINTS, 2.0f);
+
+        // Geometry should be admitted only on second request
+        UTEST_ASSERT(cache.get(hash, coords, POINTS, 2.0f) == NULL);
+        UTEST_ASSERT(!cache.admit(hash));
+        UTEST_ASSERT(cache.get(hash, coords, POINTS, 2.0f) == NULL);
+        UTEST_ASSERT(cache.admit(hash));
+
+        UTEST_ASSERT(cache.put(hash, coords, POINTS, 2.0f, rect, v, 16, idx, lsp::ws::gl::INDEX_FMT_U16, 100, 24));
+        UTEST_ASSERT(cache.size() > 0);
+
+        // Lookup the geometry
+        const lsp::ws::gl::GeometryCache::geometry_t *g = cache.get(hash, coords, POINTS, 2.0f);
+        UTEST_ASSERT(g != NULL);
+        UTEST_ASSERT(g->nvertices == 16);
+        UTEST_ASSERT(g->nindices == 24);
+        UTEST_ASSERT(g->rect.right == 310.0f);
+        for (size_t i=0; i<16; ++i)
+        {
+            UTEST_ASSERT(g->vertices[i].x == float(i));
+            UTEST_ASSERT(g->vertices[i].y == float(i * 2));
+        }
+        for (size_t i=0; i<24; ++i)
+            UTEST_ASSERT(g->indices[i] == (i % 16));
+
+        // Different width or coordinates should not match
+        UTEST_ASSERT(cache.get(hash, coords, POINTS, 3.0f) == NULL);
+        coords[5]  += 1.0f;
+        UTEST_ASSERT(cache.get(hash, coords, POINTS, 2.0f) == NULL);
+
+        UTEST_ASSERT(cache.hits() == 1);
+        UTEST_ASSERT(cache.misses() == 4);
+
+        cache.clear();
+        UTEST_ASSERT(cache.size() == 0);
+    }
+
+    void test_admission()
+    {
+        printf("Testing admission...\n");
+
+        lsp::ws::gl::GeometryCache cache;
+
+        // Geometry is admitted once per two requests
+        UTEST_ASSERT(!cache.admit(1));
+        UTEST_ASSERT(cache.admit(1));
+        UTEST_ASSERT(!cache.admit(1));
+        UTEST_ASSERT(cache.admit(1));
+
+        // Geometry requested once is forgotten after many other requests
+        UTEST_ASSERT(!cache.admit(2));
+        for (uint32_t i=0; i<0x100; ++i)
+            UTEST_ASSERT(!cache.admit(0x1000 + i));
+        UTEST_ASSERT(!cache.admit(2));
+        UTEST_ASSERT(cache.admit(2));
+    }
+
+    void test_index_formats()
+    {
+        printf("Testing index formats...\n");
+
+        float coords[POINTS * 2];
+        lsp::ws::gl::vertex_t v[4];
+        lsp::ws::gl::clip_rect_t rect = { 0.0f, 0.0f, 310.0f, 5.0f };
+        const uint8_t idx8[6]   = { 10, 11, 12, 10, 12, 13 };
+        const uint32_t idx32[6] = { 70000, 70001, 70002, 70000, 70002, 70003 };
+        const uint32_t expected[6] = { 0, 1, 2, 0, 2, 3 };
+
+        make_polyline(coords, 0.0f);
+        make_geometry(v, NULL, 4, 0, 0);
+
+        lsp::ws::gl::GeometryCache cache;
+
+        // Indices are stored relative to the first vertex regardless of the format
+        const uint32_t h8   = lsp::ws::gl::GeometryCache::hash(coords, POINTS, 1.0f);
+        UTEST_ASSERT(cache.put(h8, coords, POINTS, 1.0f, rect, v, 4, idx8, lsp::ws::gl::INDEX_FMT_U8, 10, 6));
+        const uint32_t h32  = lsp::ws::gl::GeometryCache::hash(coords, POINTS, 4.0f);
+        UTEST_ASSERT(cache.put(h32, coords, POINTS, 4.0f, rect, v, 4, idx32, lsp::ws::gl::INDEX_FMT_U32, 70000, 6));
+
+        const lsp::ws::gl::GeometryCache::geometry_t *g8 = cache.get(h8, coords, POINTS, 1.0f);
+        const lsp::ws::gl::GeometryCache::geometry_t *g32 = cache.get(h32, coords, POINTS, 4.0f);
+        UTEST_ASSERT((g8 != NULL) && (g32 != NULL));
+        UTEST_ASSERT(g8 != g32);
+        for (size_t i=0; i<6; ++i)
+        {
+            UTEST_ASSERT(g8->indices[i] == expected[i]);
+            UTEST_ASSERT(g32->indices[i] == expected[i]);
+        }
+
+        // Polyline with less points and the same prefix should not match
+        UTEST_ASSERT(cache.get(h8, coords, POINTS - 1, 1.0f) == NULL);
+    }
+
+    void test_large_geometry()
+    {
+        printf("Testing large geometry...\n");
+
+        float coords[POINTS * 2];
+        lsp::ws::gl::vertex_t v[16];
+        uint16_t idx[24];
+        lsp::ws::gl::clip_rect_t rect = { 0.0f, 0.0f, 310.0f, 5.0f };
+
+        make_polyline(coords, 0.0f);
+        make_geometry(v, idx, 16, 24, 0);
+
+        // Geometry that takes more than a quarter of the cache is not cached
+        lsp::ws::gl::GeometryCache cache(0x400);
+        const uint32_t hash = lsp::ws::gl::GeometryCache::hash(coords, POINTS, 1.0f);
+        UTEST_ASSERT(!cache.put(hash, coords, POINTS, 1.0f, rect, v, 16, idx, lsp::ws::gl::INDEX_FMT_U16, 0, 24));
+        UTEST_ASSERT(cache.size() == 0);
+        UTEST_ASSERT(cache.get(hash, coords, POINTS, 1.0f) == NULL);
+    }
+
+    UTEST_MAIN
+    {
+        test_lookup();
+        test_admission();
+        test_index_formats();
+        test_large_geometry();
+    }
+
+UTEST_END;
+
+#endif /* LSP_PLUGINS_USE_OPENGL */
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/gl/defs.h>
+
+#ifdef LSP_PLUGINS_USE_OPENGL
+
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/test-fw/utest.h>
+
+#include <private/gl/extrude.h>
+
+using namespace lsp::ws;
+
+UTEST_BEGIN("ws.gl", extrude)
+
+    static constexpr size_t POINTS      = 4096;
+    static constexpr uint32_t CMD       = 42;
+
+    void make_trace(float *x, float *y, size_t n)
+    {
+        for (size_t i=0; i<n; ++i)
+        {
+            x[i]        = float(i) * 0.25f;
+            y[i]        = 100.0f + 80.0f * sinf(float(i) * 0.03f) + float((i * 7919) % 13);
+        }
+    }
+
+    bool float_close(float a, float b)
+    {
+        const float d   = fabsf(a - b);
+        return (d <= 1e-4f) || (d <= 1e-5f * lsp_max(fabsf(a), fabsf(b)));
+    }
+
+    template <class T>
+    void compare(const char *label, const float *x, const float *y, size_t n, float width)
+    {
+        printf("Testing %s polyline of %d points...\n", label, int(n));
+
+        const size_t segs   = (n > 1) ? n - 1 : 0;
+        gl::vertex_t *sv    = new gl::vertex_t[segs * 4 + 1];
+        gl::vertex_t *cv    = new gl::vertex_t[segs * 4 + 1];
+        T *si               = new T[segs * 12 + 1];
+        T *ci               = new T[segs * 12 + 1];
+        lsp_finally {
+            delete [] sv;
+            delete [] cv;
+            delete [] si;
+            delete [] ci;
+        };
+
+        gl::vertex_t *sv_end= sv;
+        gl::vertex_t *cv_end= cv;
+        T *si_end           = si;
+        T *ci_end           = ci;
+        gl::extrude_polyline_scalar<T>(sv_end, si_end, T(10), CMD, x, y, width, n);
+        gl::extrude_polyline<T>(cv_end, ci_end, T(10), CMD, x, y, width, n);
+
+        // The chunked extrusion should emit the same geometry as the scalar one
+        UTEST_ASSERT_MSG((sv_end - sv) == (cv_end - cv),
+            "Vertex count mismatch: scalar=%d, chunked=%d", int(sv_end - sv), int(cv_end - cv));
+        UTEST_ASSERT_MSG((si_end - si) == (ci_end - ci),
+            "Index count mismatch: scalar=%d, chunked=%d", int(si_end - si), int(ci_end - ci));
+
+        for (ssize_t i=0, nv=sv_end - sv; i<nv; ++i)
+        {
+            UTEST_ASSERT_MSG(float_close(sv[i].x, cv[i].x) && float_close(sv[i].y, cv[i].y),
+                "Vertex %d mismatch: scalar={%f, %f}, chunked={%f, %f}",
+                int(i), sv[i].x, sv[i].y, cv[i].x, cv[i].y);
+            UTEST_ASSERT(cv[i].cmd == CMD);
+            UTEST_ASSERT((cv[i].s == 0.0f) && (cv[i].t == 0.0f));
+        }
+        for (ssize_t i=0, ni=si_end - si; i<ni; ++i)
+            UTEST_ASSERT_MSG(si[i] == ci[i],
+                "Index %d mismatch: scalar=%d, chunked=%d", int(i), int(si[i]), int(ci[i]));
+    }
+
+    void test_trace()
+    {
+        float *x    = new float[POINTS];
+        float *y    = new float[POINTS];
+        lsp_finally {
+            delete [] x;
+            delete [] y;
+        };
+
+        make_trace(x, y, POINTS);
+        compare<uint32_t>("smooth", x, y, POINTS, 2.0f);
+        compare<uint32_t>("smooth", x, y, gl::EXTRUDE_CHUNK + 1, 1.0f);
+        compare<uint32_t>("smooth", x, y, gl::EXTRUDE_CHUNK + 2, 1.0f);
+        compare<uint16_t>("smooth", x, y, 1000, 3.0f);
+        compare<uint8_t>("smooth", x, y, 16, 3.0f);
+    }
+
+    void test_degenerate()
+    {
+        float *x    = new float[POINTS];
+        float *y    = new float[POINTS];
+        lsp_finally {
+            delete [] x;
+            delete [] y;
+        };
+
+        // Repeated points at the start, inside chunks and across chunk boundaries
+        static const size_t repeats[] = {
+            1, 2, 3,
+            100, 300, 301, 302,
+            gl::EXTRUDE_CHUNK * 2, gl::EXTRUDE_CHUNK * 2 + 1,
+            gl::EXTRUDE_CHUNK * 3 - 1,
+            POINTS - 2, POINTS - 1
+        };
+
+        make_trace(x, y, POINTS);
+        for (size_t i=0; i<sizeof(repeats)/sizeof(repeats[0]); ++i)
+        {
+            const size_t k  = repeats[i];
+            x[k]            = x[k - 1];
+            y[k]            = y[k - 1];
+        }
+        compare<uint32_t>("degenerate", x, y, POINTS, 2.0f);
+
+        // Very short segments that are joined with the following ones
+        make_trace(x, y, POINTS);
+        for (size_t i=gl::EXTRUDE_CHUNK + 10; i<gl::EXTRUDE_CHUNK + 20; ++i)
+        {
+            x[i]            = x[i - 1] + 1e-6f;
+            y[i]            = y[i - 1];
+        }
+        compare<uint32_t>("short segments", x, y, POINTS, 2.0f);
+
+        // All points are the same: nothing should be emitted
+        for (size_t i=0; i<POINTS; ++i)
+        {
+            x[i]            = 10.0f;
+            y[i]            = 20.0f;
+        }
+        compare<uint32_t>("collapsed", x, y, POINTS, 2.0f);
+        compare<uint32_t>("single point", x, y, 1, 2.0f);
+    }
+
+    UTEST_MAIN
+    {
+        test_trace();
+        test_degenerate();
+    }
+
+UTEST_END;
+
+#endif /* LSP_PLUGINS_USE_OPENGL */
@@ -0,0 +1,522 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/ws/version.h>
+
+#if defined(USE_LIBX11) && defined(USE_LIBCAIRO)
+
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/test-fw/utest.h>
+
+#include <private/x11/X11CairoSurface.h>
+#ifdef USE_LIBFREETYPE
+    #include <private/freetype/bitmap.h>
+    #include <private/freetype/FontManager.h>
+#endif /* USE_LIBFREETYPE */
+
+using namespace lsp::ws;
+
+namespace
+{
+    using namespace lsp;
+
+    /**
+     * Image surface that provides access to the rasterized pixels
+     */
+    class TestSurface: public ws::x11::X11CairoSurface
+    {
+        public:
+            explicit TestSurface(size_t width, size_t height):
+                X11CairoSurface(NULL, width, height)
+            {
+            }
+
+        public:
+            size_t bands() const        { return nBands; }
+
+            bool fill_direct(const Color &c, float left, float top, float width, float height)
+            {
+                return fill_rect_fast(c, SURFMASK_NO_CORNER, 0.0f, left, top, width, height);
+            }
+
+            void fill_cairo(const Color &c, float left, float top, float width, float height)
+            {
+                float r, g, b, o;
+                c.get_rgbo(r, g, b, o);
+                ::cairo_set_source_rgba(pCR, r, g, b, o);
+                ::cairo_rectangle(pCR, left, top, width, height);
+                ::cairo_fill(pCR);
+            }
+
+            void clip_boxes(const ws::rectangle_t *r, size_t n)
+            {
+                for (size_t i=0; i<n; ++i)
+                    ::cairo_rectangle(pCR, r[i].nLeft, r[i].nTop, r[i].nWidth, r[i].nHeight);
+                ::cairo_clip(pCR);
+            }
+
+        #ifdef USE_LIBFREETYPE
+            bool text_direct(ws::ft::FontManager *mgr, const ws::Font &f, const Color &c, float x, float y, const LSPString *text)
+            {
+                return out_glyphs(mgr, f, c, x, y, NULL, text, 0, text->length());
+            }
+
+            void text_bitmap(ws::ft::FontManager *mgr, const ws::Font &f, const Color &c, float x, float y, const LSPString *text)
+            {
+                // Same drawing as out_text() does when the glyphs can not be composited directly
+                ws::ft::text_range_t tr;
+                dsp::bitmap_t *bitmap   = mgr->render_text(&f, &tr, text, 0, text->length());
+                if (bitmap == NULL)
+                    return;
+                lsp_finally { ws::ft::free_bitmap(bitmap); };
+
+                cairo_surface_t *fs     = ::cairo_image_surface_create_for_data(
+                    bitmap->data, CAIRO_FORMAT_A8, bitmap->width, bitmap->height, bitmap->stride);
+                lsp_finally { ::cairo_surface_destroy(fs); };
+
+                float r, g, b, o;
+                c.get_rgbo(r, g, b, o);
+                ::cairo_set_source_rgba(pCR, r, g, b, o);
+                ::cairo_mask_surface(pCR, fs, x + tr.x_bearing, y + tr.y_bearing);
+            }
+        #endif /* USE_LIBFREETYPE */
+
+            void copy_pixels(uint8_t *dst)
+            {
+                wait_frames(0);
+                ::cairo_surface_flush(pSurface);
+
+                const uint8_t *src  = ::cairo_image_surface_get_data(pSurface);
+                const size_t stride = ::cairo_image_surface_get_stride(pSurface);
+                const size_t row    = nWidth * sizeof(uint32_t);
+                for (size_t y=0; y<nHeight; ++y)
+                    memcpy(&dst[y * row], &src[y * stride], row);
+            }
+    };
+} /* namespace */
+
+UTEST_BEGIN("ws.x11", cairosurface)
+
+    static constexpr size_t WIDTH       = 320;
+    static constexpr size_t HEIGHT      = 480;
+    static constexpr size_t FRAMES      = 3;
+    static constexpr size_t BANDS       = 4;
+    static constexpr size_t CELL_SIZE   = 16;
+    static constexpr size_t CELL_COLUMNS= WIDTH / CELL_SIZE + 1;
+    static constexpr size_t CELLS       = CELL_COLUMNS * (HEIGHT / CELL_SIZE + 1);
+
+    void draw_scene(ws::ISurface *s, size_t frame)
+    {
+        Color c(0.0f, 0.5f, 0.75f);
+
+        s->begin();
+        s->clear(c);
+
+        // Anti-aliased shapes crossing the band boundaries
+        for (size_t i=0; i<8; ++i)
+        {
+            c.set_rgb24(0xff0000 + i * 0x1f20);
+            c.alpha(i * 0.1f);
+            s->fill_circle(c, 40.0f + i * 33.0f, 30.0f + i * 57.0f + frame * 5.0f, 45.5f);
+            s->fill_rect(c, SURFMASK_ALL_CORNER, 7.0f, 10.5f + i * 20.0f, 50.25f * i, 120.0f, 77.5f);
+            s->line(c, 0.0f, i * 60.0f, WIDTH, HEIGHT - i * 60.0f + frame, 1.5f + i);
+        }
+
+        // Gradient fill
+        ws::IGradient *g = s->linear_gradient(0.0f, 0.0f, WIDTH, HEIGHT);
+        if (g != NULL)
+        {
+            c.set_rgb24(0x00ff00);
+            c.alpha(0.25f);
+            g->set_start(c);
+            c.set_rgb24(0xff00ff);
+            c.alpha(0.75f);
+            g->set_stop(c);
+            s->fill_triangle(g, 5.0f, 5.0f, WIDTH - 5.0f, HEIGHT * 0.5f, 30.0f, HEIGHT - 5.0f);
+            delete g;
+        }
+
+        // Clipped drawing
+        s->clip_begin(20.0f, 100.0f, 200.0f, 250.0f);
+        {
+            c.set_rgb24(0xffff00);
+            c.alpha(0.5f);
+            s->fill_sector(c, 120.0f, 220.0f, 150.0f, 0.3f, 2.5f + frame * 0.1f);
+            s->wire_rect(c, SURFMASK_NO_CORNER, 0.0f, 25.5f, 105.5f, 190.0f, 240.0f, 3.0f);
+        }
+        s->clip_end();
+
+        s->end();
+    }
+
+    void draw_source(ws::ISurface *s)
+    {
+        Color c;
+
+        s->begin();
+        c.set_rgb24(0x000000);
+        c.alpha(1.0f);
+        s->clear(c);
+
+        c.set_rgb24(0xff00ff);
+        c.alpha(0.3f);
+        s->fill_circle(c, 32.0f, 32.0f, 28.5f);
+        c.set_rgb24(0x00ffff);
+        s->fill_rect(c, SURFMASK_NO_CORNER, 0.0f, 8.0f, 8.0f, 16.0f, 16.0f);
+        s->end();
+    }
+
+    /**
+     * Each recorded segment is composited over the surface through an intermediate image,
+     * so the scene does not overlap translucent shapes within one segment: rounding of
+     * the intermediate image would differ from drawing the shapes one by one.
+     */
+    void draw_sequence(ws::ISurface *s, ws::ISurface *src, size_t frame)
+    {
+        Color c;
+
+        s->begin();
+        c.set_rgb24(0x202830);
+        c.alpha(0.0f);
+        s->clear(c);
+
+        // Opaque fills, pixel-aligned rectangles are filled directly in synchronous mode
+        c.set_rgb24(0x4080c0);
+        s->fill_rect(c, SURFMASK_NO_CORNER, 0.0f, 10.0f, 10.0f + frame, 120.0f, 80.0f);
+        c.set_rgb24(0xc04080);
+        s->fill_rect(c, SURFMASK_ALL_CORNER, 6.0f, 150.5f, 10.25f, 100.0f, 60.0f);
+
+        // Translucent fill over the opaque rectangle
+        c.set_rgb24(0xffff00);
+        c.alpha(0.5f);
+        s->fill_circle(c, 70.0f, 50.0f + frame, 25.0f);
+
+        // Another surface
+        s->draw(src, 20.0f, 120.0f + frame, 1.0f, 1.0f, 0.25f);
+
+        // Clip changes across the clear
+        s->clip_begin(160.0f, 100.0f, 120.0f, 120.0f);
+        {
+            c.set_rgb24(0x00ff00);
+            c.alpha(0.0f);
+            s->fill_rect(c, SURFMASK_NO_CORNER, 0.0f, 150.0f, 110.0f, 60.0f, 60.0f);
+            c.set_rgb24(0x102030);
+            c.alpha(0.25f);
+            s->clear(c);
+            c.set_rgb24(0x0000ff);
+            c.alpha(0.0f);
+            s->fill_circle(c, 220.0f, 160.0f, 40.0f - frame);
+        }
+        s->clip_end();
+
+        s->clip_begin(20.0f, 240.0f, 100.0f, 40.0f);
+        {
+            c.set_rgb24(0x808080);
+            s->clear(c);
+            c.set_rgb24(0xffffff);
+            s->line(c, 0.0f, 255.5f, WIDTH, 265.0f + frame, 2.0f);
+        }
+        s->clip_end();
+
+        // Drawing after the clipped clears
+        c.set_rgb24(0xff8000);
+        s->fill_triangle(c, 10.5f, 300.0f, 200.0f, 310.5f, 60.0f + frame, 400.0f);
+
+        s->end();
+    }
+
+    void render_sequence(uint8_t *dst, bool async)
+    {
+        TestSurface src(64, 64);
+        draw_source(&src);
+
+        TestSurface s(WIDTH, HEIGHT);
+        if (async)
+        {
+            UTEST_ASSERT(s.start_async(1) == STATUS_OK);
+        }
+
+        for (size_t i=0; i<FRAMES; ++i)
+            draw_sequence(&s, &src, i);
+        s.copy_pixels(dst);
+        s.destroy();
+        src.destroy();
+    }
+
+    void render(uint8_t *dst, size_t threads, bool async)
+    {
+        TestSurface s(WIDTH, HEIGHT);
+        if (async)
+        {
+            UTEST_ASSERT(s.start_async(threads) == STATUS_OK);
+            if ((threads > 1) && (s.bands() <= 1))
+                printf("  cairo does not support tee surfaces, rasterizing in one band\n");
+        }
+
+        for (size_t i=0; i<FRAMES; ++i)
+            draw_scene(&s, i);
+        s.copy_pixels(dst);
+        s.destroy();
+    }
+
+    void compare(const char *label, const uint8_t *a, const uint8_t *b)
+    {
+        const size_t row    = WIDTH * sizeof(uint32_t);
+        for (size_t y=0; y<HEIGHT; ++y)
+        {
+            UTEST_ASSERT_MSG(memcmp(&a[y * row], &b[y * row], row) == 0,
+                "%s: pixel data differs at row %d", label, int(y));
+        }
+    }
+
+    void make_color(Color *c, size_t index)
+    {
+        // Components cover the whole range and values near the rounding boundaries
+        // of the double to 16-bit and 16-bit to 8-bit conversions
+        const float r       = float(index) / float(CELLS - 1);
+        const float g       = (256.0f * float(index & 0xff) - 0.5f) / 65535.0f;
+        const float b       = (256.0f * float((index * 7) & 0xff) + 255.5f) / 65535.0f;
+
+        c->set_rgb(r, lsp_limit(g, 0.0f, 1.0f), lsp_limit(b, 0.0f, 1.0f));
+        c->alpha(0.0f);
+    }
+
+    void fill_cells(TestSurface *s, bool direct, const ws::rectangle_t *clip, size_t nclip, ssize_t ox, ssize_t oy)
+    {
+        Color c;
+
+        s->begin();
+        s->clear_rgb(0x102030);
+        s->set_origin(ox, oy);
+        if (nclip > 0)
+            s->clip_boxes(clip, nclip);
+
+        // Rectangles are pixel-aligned in user space, the partially visible ones are clipped
+        for (size_t i=0; i<CELLS; ++i)
+        {
+            make_color(&c, i);
+            const float left    = float(i % CELL_COLUMNS) * CELL_SIZE - CELL_SIZE / 2;
+            const float top     = float(i / CELL_COLUMNS) * CELL_SIZE - CELL_SIZE / 2;
+            const float size    = CELL_SIZE - 3 + (i % 5);
+            if (direct)
+            {
+                UTEST_ASSERT_MSG(s->fill_direct(c, left, top, size, size),
+                    "rectangle %d was not filled directly", int(i));
+            }
+            else
+                s->fill_cairo(c, left, top, size, size);
+        }
+
+        s->end();
+    }
+
+    void test_fill_rect(const char *label, const ws::rectangle_t *clip, size_t nclip, ssize_t ox, ssize_t oy)
+    {
+        printf("Testing direct fill of rectangles %s...\n", label);
+
+        const size_t size   = WIDTH * HEIGHT * sizeof(uint32_t);
+        uint8_t *direct     = new uint8_t[size];
+        uint8_t *cairo      = new uint8_t[size];
+        lsp_finally {
+            delete [] direct;
+            delete [] cairo;
+        };
+
+        TestSurface ds(WIDTH, HEIGHT);
+        fill_cells(&ds, true, clip, nclip, ox, oy);
+        ds.copy_pixels(direct);
+        ds.destroy();
+
+        TestSurface cs(WIDTH, HEIGHT);
+        fill_cells(&cs, false, clip, nclip, ox, oy);
+        cs.copy_pixels(cairo);
+        cs.destroy();
+
+        compare(label, direct, cairo);
+    }
+
+    void test_fill_rect()
+    {
+        static const ws::rectangle_t clip[] =
+        {
+            {   0,   0, 100, 480 },
+            { 120,  40, 150, 200 },
+            { 120, 300, 200, 100 },
+            { 270,  40,  17,  17 }
+        };
+
+        test_fill_rect("without clipping", NULL, 0, 0, 0);
+        test_fill_rect("with clipping", clip, 4, 0, 0);
+        test_fill_rect("with clipping and origin", clip, 4, 5, -7);
+    }
+
+#ifdef USE_LIBFREETYPE
+    void draw_texts(TestSurface *s, ws::ft::FontManager *mgr, size_t *direct, const ws::rectangle_t *clip, size_t nclip)
+    {
+        static const char * const texts[] =
+        {
+            "Hello World",
+            "-12.5 dB",
+            "AVAWAY fjord ffi",
+            "Lorem ipsum dolor sit amet",
+            NULL
+        };
+        static const float sizes[] = { 9.0f, 12.0f, 16.0f, 32.0f };
+
+        LSPString text;
+        Color c;
+        ws::Font f("test", 12.0f);
+        ssize_t y       = 12;
+
+        s->begin();
+        s->clear_rgb(0x202830);
+        if (nclip > 0)
+            s->clip_boxes(clip, nclip);
+
+        for (size_t i=0; i<2; ++i)
+        {
+            f.set_italic(i > 0);
+            for (size_t j=0; j<sizeof(sizes)/sizeof(float); ++j)
+            {
+                f.set_size(sizes[j]);
+                for (size_t k=0; texts[k] != NULL; ++k)
+                {
+                    UTEST_ASSERT(text.set_utf8(texts[k]));
+
+                    // Opaque and translucent colours, some texts are clipped by the surface
+                    c.set_rgb24(0xffe0c0 - k * 0x203040);
+                    c.alpha((k & 1) ? 0.4f : 0.0f);
+                    const float x   = ssize_t(k * 7) - 10;
+
+                    if ((direct != NULL) && (s->text_direct(mgr, f, c, x, y, &text)))
+                        ++(*direct);
+                    else
+                        s->text_bitmap(mgr, f, c, x, y, &text);
+
+                    y               = (y + ssize_t(sizes[j] * 0.5f)) % HEIGHT;
+                }
+            }
+        }
+
+        s->end();
+    }
+
+    void test_text(const char *label, ws::ft::FontManager *mgr, const ws::rectangle_t *clip, size_t nclip)
+    {
+        printf("Testing direct composition of glyphs %s...\n", label);
+
+        const size_t size   = WIDTH * HEIGHT * sizeof(uint32_t);
+        uint8_t *direct     = new uint8_t[size];
+        uint8_t *bitmap     = new uint8_t[size];
+        lsp_finally {
+            delete [] direct;
+            delete [] bitmap;
+        };
+
+        size_t count        = 0;
+        TestSurface ds(WIDTH, HEIGHT);
+        draw_texts(&ds, mgr, &count, clip, nclip);
+        ds.copy_pixels(direct);
+        ds.destroy();
+
+        TestSurface bs(WIDTH, HEIGHT);
+        draw_texts(&bs, mgr, NULL, clip, nclip);
+        bs.copy_pixels(bitmap);
+        bs.destroy();
+
+        printf("  %d texts have been composited directly\n", int(count));
+        UTEST_ASSERT(count > 0);
+        compare(label, direct, bitmap);
+    }
+
+    void test_text()
+    {
+        static const ws::rectangle_t clip[] =
+        {
+            {   0,   0, 160, 480 },
+            { 180,  20, 100, 200 },
+            { 180, 300, 140, 100 }
+        };
+
+        ws::ft::FontManager manager;
+        io::Path path;
+
+        UTEST_ASSERT(manager.init() == STATUS_OK);
+        lsp_finally { manager.destroy(); };
+        UTEST_ASSERT(path.fmt("%s/font/NotoSansDisplay-Regular.ttf", resources()) > 0);
+        UTEST_ASSERT(manager.add("test", &path) == STATUS_OK);
+
+        test_text("without clipping", &manager, NULL, 0);
+        test_text("with clipping", &manager, clip, 3);
+    }
+#endif /* USE_LIBFREETYPE */
+
+    void test_async()
+    {
+        printf("Testing asynchronous rasterization...\n");
+
+        const size_t size   = WIDTH * HEIGHT * sizeof(uint32_t);
+        uint8_t *sync       = new uint8_t[size];
+        uint8_t *async      = new uint8_t[size];
+        lsp_finally {
+            delete [] sync;
+            delete [] async;
+        };
+
+        render_sequence(sync, false);
+        render_sequence(async, true);
+        compare("async", sync, async);
+    }
+
+    void test_bands()
+    {
+        printf("Testing tiled rasterization in %d bands...\n", int(BANDS));
+
+        const size_t size   = WIDTH * HEIGHT * sizeof(uint32_t);
+        uint8_t *single     = new uint8_t[size];
+        uint8_t *tiled      = new uint8_t[size];
+        lsp_finally {
+            delete [] single;
+            delete [] tiled;
+        };
+
+        render(single, 1, true);
+        render(tiled, BANDS, true);
+        compare("tiled", single, tiled);
+    }
+
+    UTEST_MAIN
+    {
+        test_fill_rect();
+    #ifdef USE_LIBFREETYPE
+        test_text();
+    #endif /* USE_LIBFREETYPE */
+        test_async();
+        test_bands();
+    }
+
+UTEST_END;
+
+#endif /* USE_LIBX11 && USE_LIBCAIRO */
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-ws-lib
+ * Created on: 18 окт. 2026 г.
+ *
+ * lsp-ws-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-ws-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-ws-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/ws/version.h>
+
+#ifdef USE_LIBX11
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/x11/X11MetricsCache.h>
+
+UTEST_BEGIN("ws.x11", metricscache)
+
+    void make_params(lsp::ws::x11::X11MetricsCache::params_t *p, float value)
+    {
+        p->text.XBearing    = value;
+        p->text.YBearing    = -value;
+        p->text.Width       = value * 10.0f;
+        p->text.Height      = value * 2.0f;
+        p->text.XAdvance    = value * 11.0f;
+        p->text.YAdvance    = value * 2.0f;
+    }
+
+    void test_lookup()
+    {
+        printf("Testing lookup...\n");
+
+        typedef lsp::ws::x11::X11MetricsCache cache_t;
+
+        cache_t cache;
+        cache_t::params_t p;
+        lsp::ws::Font f("sans", 12.0f);
+        lsp::ws::Font bold("sans", 12.0f);
+        lsp::ws::Font large("sans", 14.0f);
+        lsp::ws::Font serif("serif", 12.0f);
+        bold.set_bold(true);
+
+        const char *text    = "Measured text";
+        const size_t len    = strlen(text);
+        const uint32_t hash = cache_t::hash(f, cache_t::KEY_UTF8, text, len);
+
+        UTEST_ASSERT(cache.get(hash, f, cache_t::KEY_UTF8, text, len) == NULL);
+        make_params(&p, 1.0f);
+        UTEST_ASSERT(cache.put(hash, f, cache_t::KEY_UTF8, text, len, &p));
+        UTEST_ASSERT(cache.size() > 0);
+
+        const cache_t::params_t *c = cache.get(hash, f, cache_t::KEY_UTF8, text, len);
+        UTEST_ASSERT(c != NULL);
+        UTEST_ASSERT(c->text.Width == 10.0f);
+        UTEST_ASSERT(c->text.XAdvance == 11.0f);
+
+        // Different font descriptors, key types and texts should not match
+        UTEST_ASSERT(cache.get(cache_t::hash(bold, cache_t::KEY_UTF8, text, len), bold, cache_t::KEY_UTF8, text, len) == NULL);
+        UTEST_ASSERT(cache.get(cache_t::hash(large, cache_t::KEY_UTF8, text, len), large, cache_t::KEY_UTF8, text, len) == NULL);
+        UTEST_ASSERT(cache.get(cache_t::hash(serif, cache_t::KEY_UTF8, text, len), serif, cache_t::KEY_UTF8, text, len) == NULL);
+        UTEST_ASSERT(cache.get(hash, f, cache_t::KEY_UTF32, text, len) == NULL);
+        UTEST_ASSERT(cache.get(hash, f, cache_t::KEY_UTF8, text, len - 1) == NULL);
+
+        // Font parameters have no text
+        const uint32_t fhash = cache_t::hash(f, cache_t::KEY_FONT, NULL, 0);
+        p.font.Ascent       = 10.0f;
+        p.font.Descent      = 3.0f;
+        p.font.Height       = 14.0f;
+        UTEST_ASSERT(cache.put(fhash, f, cache_t::KEY_FONT, NULL, 0, &p));
+        c = cache.get(fhash, f, cache_t::KEY_FONT, NULL, 0);
+        UTEST_ASSERT(c != NULL);
+        UTEST_ASSERT(c->font.Height == 14.0f);
+
+        UTEST_ASSERT(cache.hits() == 2);
+        UTEST_ASSERT(cache.misses() == 6);
+
+        cache.clear();
+        UTEST_ASSERT(cache.size() == 0);
+        UTEST_ASSERT(cache.get(hash, f, cache_t::KEY_UTF8, text, len) == NULL);
+    }
+
+    void test_collisions()
+    {
+        printf("Testing keys with the same hash...\n");
+
+        typedef lsp::ws::x11::X11MetricsCache cache_t;
+
+        // Keys that differ only in one attribute are stored under the same hash
+        cache_t cache;
+        cache_t::params_t p;
+        lsp::ws::Font f("sans", 12.0f);
+        lsp::ws::Font longer("sans-serif", 12.0f);
+        lsp::ws::Font italic("sans", 12.0f);
+        italic.set_italic(true);
+
+        const uint32_t hash     = 42;
+        const char *text        = "abcd";
+        const uint32_t wtext    = 0x64636261;   // The same bytes as UTF-32 key
+
+        make_params(&p, 1.0f);
+        UTEST_ASSERT(cache.put(hash, f, cache_t::KEY_UTF8, text, 4, &p));
+        make_params(&p, 2.0f);
+        UTEST_ASSERT(cache.put(hash, longer, cache_t::KEY_UTF8, text, 4, &p));
+        make_params(&p, 3.0f);
+        UTEST_ASSERT(cache.put(hash, italic, cache_t::KEY_UTF8, text, 4, &p));
+        make_params(&p, 4.0f);
+        UTEST_ASSERT(cache.put(hash, f, cache_t::KEY_UTF32, &wtext, sizeof(wtext), &p));
+        make_params(&p, 5.0f);
+        UTEST_ASSERT(cache.put(hash, f, cache_t::KEY_FONT, NULL, 0, &p));
+
+        const cache_t::params_t *c;
+        UTEST_ASSERT((c = cache.get(hash, f, cache_t::KEY_UTF8, text, 4)) != NULL);
+        UTEST_ASSERT(c->text.Width == 10.0f);
+        UTEST_ASSERT((c = cache.get(hash, longer, cache_t::KEY_UTF8, text, 4)) != NULL);
+        UTEST_ASSERT(c->text.Width == 20.0f);
+        UTEST_ASSERT((c = cache.get(hash, italic, cache_t::KEY_UTF8, text, 4)) != NULL);
+        UTEST_ASSERT(c->text.Width == 30.0f);
+        UTEST_ASSERT((c = cache.get(hash, f, cache_t::KEY_UTF32, &wtext, sizeof(wtext))) != NULL);
+        UTEST_ASSERT(c->text.Width == 40.0f);
+        UTEST_ASSERT((c = cache.get(hash, f, cache_t::KEY_FONT, NULL, 0)) != NULL);
+        UTEST_ASSERT(c->text.Width == 50.0f);
+
+        // Empty text is not the same as font parameters
+        UTEST_ASSERT(cache.get(hash, f, cache_t::KEY_UTF8, text, 0) == NULL);
+
+        cache.clear_stats();
+        UTEST_ASSERT(cache.hits() == 0);
+        UTEST_ASSERT(cache.misses() == 0);
+    }
+
+    UTEST_MAIN
+    {
+        test_lookup();
+        test_collisions();
+    }
+
+UTEST_END;
+
+#endif /* USE_LIBX11 */